@@ -32,6 +32,8 @@ std::unordered_map<std::string, std::string> user_db = {
 int main() {
     auto scheduler = IoScheduler::make_shared(IoScheduler::Options{.execution_strategy = io_exec_thread_pool});
     http::HttpServer server(scheduler, {.address = net::IpAddress::from_string("0.0.0.0"), .port = 8080});
+    // 处理函数在线程池的多个线程上运行，user_db 由协程锁保护，争用时挂起而不阻塞工作线程
+    Mutex user_db_mutex{scheduler};
 
     // 注册路由
     server.Get("/", [](http::Request& req, http::Response& resp) -> Task<> {
@@ -39,11 +41,14 @@ int main() {
         co_return;
     });
 
+    // /api 的响应缓存 5 秒，按 Accept 头部区分
+    auto api_cache = std::make_shared<http::ResponseCache>(
+            scheduler, http::ResponseCache::Options{.ttl = std::chrono::seconds{5}, .vary_headers = {"Accept"}});
     server.Get("/api", [](http::Request& req, http::Response& resp) -> Task<> {
         resp.headers["Content-Type"] = "application/json";
         resp.body = R"({"status": "ok"})";
         co_return;
-    });
+    }, api_cache);
 
     server.Post("/get_varifycode", [](http::Request& req, http::Response& resp) -> Task<> {
         try {
@@ -89,7 +94,7 @@ int main() {
         co_return ;
     });
 
-    server.Post("/login", [](http::Request& req, http::Response& resp) -> Task<> {
+    server.Post("/login", [&user_db_mutex](http::Request& req, http::Response& resp) -> Task<> {
         try {
             json j = json::parse(req.body);
             std::string username = j["username"];
@@ -98,6 +103,7 @@ int main() {
             std::cerr << "password: " << password << "\n";
 
             json response_json;
+            auto lock = co_await user_db_mutex.scoped_lock();
             if (user_db.count(username) && user_db[username] == password) {
                 response_json["name"] = username;
                 response_json["password"] = password;
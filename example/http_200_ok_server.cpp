@@ -16,17 +16,12 @@ Connection: keep-alive
 )";
             std::string buf(1024, '\0');
             while (true) {
-                co_await client.poll(PollOp::Read);
-                auto [rstatus, rspan] = client.recv(buf);
-                switch (rstatus) {
-                case RecvStatus::Ok:
-                    co_await client.poll(PollOp::Write);
-                    client.send(std::span<const char>{response});
-                    break;
-                case RecvStatus::WouldBlock:
-                    break;
-                case RecvStatus::Closed:
-                default:
+                auto [rstatus, rspan] = co_await client.read_some(buf);
+                if (rstatus != RecvStatus::Ok) {
+                    co_return;
+                }
+                auto [sstatus, sent] = co_await client.write_all(response);
+                if (sstatus != SendStatus::Ok) {
                     co_return;
                 }
             }
@@ -34,7 +29,8 @@ Connection: keep-alive
 
         co_await scheduler->schedule();
 
-        tcp::Server server{scheduler, tcp::Server::LocalEndPoint{.port = 8080}};
+        tcp::Server server{scheduler,
+                           tcp::Server::LocalEndPoint{.address = IpAddress::from_string("0.0.0.0"), .port = 8080}};
         while (true) {
             auto pstatus = co_await server.poll();
             switch (pstatus) {
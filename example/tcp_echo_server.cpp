@@ -8,40 +8,36 @@ using namespace coro::net;
 
 
 int main() {
-    auto tcp_echo_server = [] (std::shared_ptr<IoScheduler> scheduler) -> Task<> {
+    auto tcp_echo_server = [] (std::shared_ptr<IoScheduler> scheduler, tcp::Server& server) -> Task<> {
         auto connection_task = [] ( tcp::Client client) -> Task<> {
             std::string buf(1024, '\0');
 
             while (true) {
-                co_await client.poll(PollOp::Read);
-                auto [rstatus, rstring] = client.recv(buf);
-                switch (rstatus) {
-                    case RecvStatus::Ok:
-                        co_await client.poll(PollOp::Write);
-                        client.send(rstring);
-                        break;
-                    case RecvStatus::WouldBlock:
-                        break;
-                    case RecvStatus::Closed:
-                    default:
-                        co_return;
+                // read_some/write_all 先直接读写，只在 EAGAIN 时挂起；数据段指向 buf，回显过程不分配内存
+                auto [rstatus, received] = co_await client.read_some(buf);
+                if (rstatus != RecvStatus::Ok) {
+                    co_return;
+                }
+                auto [sstatus, sent] = co_await client.write_all(received);
+                if (sstatus != SendStatus::Ok) {
+                    co_return;
                 }
             }
         };
 
         co_await scheduler->schedule();
 
-        tcp::Server server {scheduler,  tcp::Server::LocalEndPoint{.port=8080}};
+        std::vector<tcp::Client> clients;
         while (true) {
             auto pstatus =  co_await server.poll();
             switch (pstatus) {
                 case PollStatus::Event:
-                {
-                    auto client = server.accept();
-                    if (client.socket().is_valid()) {
+                    // 连接在接受它的 reactor 上运行
+                    server.accept_batch(clients);
+                    for (auto& client : clients) {
                         scheduler->spawn(connection_task(std::move(client)));
                     }
-                }
+                    clients.clear();
                     break;
                 case PollStatus::Error:
                 case PollStatus::Closed:
@@ -53,11 +49,14 @@ int main() {
         co_return;
     };
 
+    // 每个核一个 reactor，各自持有一个 SO_REUSEPORT 监听 socket，IO 线程绑定到对应的核
+    tcp::ServerGroup group{tcp::ServerGroup::Options{
+            .local_end_point = {.address = IpAddress::from_string("0.0.0.0"), .port = 8080}}};
+
     std::vector<Task<>> workers{};
-    for (int i = 0; i < 16; ++i) {
-        auto scheduler= IoScheduler::make_shared(IoScheduler::Options{.execution_strategy = io_exec_thread_pool});
-        workers.push_back(tcp_echo_server(scheduler));
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        workers.push_back(tcp_echo_server(group.scheduler(i), group.server(i)));
     }
 
    sync_wait(when_all(std::move(workers)));
-}
\ No newline at end of file
+}
@@ -0,0 +1,276 @@
+#ifndef CORO_ASYNC_CACHE_HPP
+#define CORO_ASYNC_CACHE_HPP
+
+#include "coro/io_scheduler.hpp"
+#include "coro/single_flight.hpp"
+#include "coro/task.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace coro {
+
+    /**
+     * 进程内的异步缓存：按 key 的哈希分片，每个分片一把锁和一个 LRU 链表，超出分片容量时淘汰最久未使用的条目。
+     * 每个条目的 TTL 由 IoScheduler 时间轮上的定时协程到期删除，不扫描；定时器没有触发之前读到过期的条目也当作未命中。
+     * 条目被覆盖、淘汰或删除时取消它的定时器，等待中的定时协程数不超过缓存的条目数。
+     * get_or_load 在未命中时执行 loader 并写入缓存，同一个 key 的并发加载通过 SingleFlight 合并为一次。
+     * 定时协程只持有分片的 weak_ptr，缓存析构时取消所有定时器；缓存不能晚于 scheduler 停止
+     */
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class AsyncCache {
+    public:
+        struct Options {
+            // 所有分片的总容量
+            std::size_t capacity{1024};
+            std::size_t shards{16};
+            // 默认的 TTL，为 0 时不过期
+            std::chrono::milliseconds ttl{std::chrono::seconds{60}};
+        };
+
+        struct Stats {
+            std::size_t hits{0};
+            std::size_t misses{0};
+            std::size_t loads{0};         // 执行 loader 的次数，合并的加载只算一次
+            std::size_t evictions{0};     // 因为容量淘汰
+            std::size_t expirations{0};   // 因为 TTL 删除
+        };
+
+        AsyncCache(std::shared_ptr<IoScheduler> scheduler, Options opts)
+            : m_scheduler(std::move(scheduler)), m_opts(opts), m_flight(m_scheduler) {
+            auto shards = std::max<std::size_t>(m_opts.shards, 1);
+            auto per_shard = std::max<std::size_t>((m_opts.capacity + shards - 1) / shards, 1);
+            m_shards.reserve(shards);
+            for (std::size_t i = 0; i < shards; ++i) {
+                m_shards.push_back(std::make_shared<Shard>(*m_scheduler, per_shard));
+            }
+        }
+        explicit AsyncCache(std::shared_ptr<IoScheduler> scheduler) : AsyncCache(std::move(scheduler), Options{}) {}
+
+        AsyncCache(const AsyncCache&) = delete;
+        AsyncCache& operator=(const AsyncCache&) = delete;
+
+        // 命中时返回值的副本并把条目移到 LRU 的头部
+        std::optional<V> get(const K& key) { return lookup(key, true); }
+
+        // 写入或者覆盖，ttl 为空时使用 Options::ttl
+        void put(K key, V value, std::optional<std::chrono::milliseconds> ttl = std::nullopt) {
+            auto duration = ttl.value_or(m_opts.ttl);
+            auto& shard = shard_for(key);
+            if (duration > std::chrono::milliseconds{0}) {
+                // 定时协程持有 key 的副本；开始等待之前被取消时不挂起
+                auto timer = std::make_shared<detail::PollInfo>();
+                shard->put(key, std::move(value), IoScheduler::clock::now() + duration, timer);
+                m_scheduler->spawn(expire_after(*m_scheduler, shard, std::move(key), std::move(timer), duration));
+            } else {
+                shard->put(std::move(key), std::move(value), IoScheduler::time_point::max(), nullptr);
+            }
+        }
+
+        bool erase(const K& key) {
+            auto& shard = shard_for(key);
+            std::scoped_lock lk{shard->m_mutex};
+            auto it = shard->m_index.find(key);
+            if (it == shard->m_index.end()) {
+                return false;
+            }
+            shard->remove(it);
+            return true;
+        }
+
+        /**
+         * 命中时直接返回，否则执行 loader（返回 Task<V> 的可调用对象）并按 ttl 写入缓存。
+         * 同一个 key 同时只有一个 loader 在执行，其他调用者等待它的结果或者异常
+         */
+        template <typename Loader>
+            requires std::invocable<Loader&> && std::convertible_to<std::invoke_result_t<Loader&>, Task<V>>
+        Task<V> get_or_load(K key, Loader loader, std::optional<std::chrono::milliseconds> ttl = std::nullopt) {
+            auto value = co_await get_or_load_if(std::move(key), [&loader] { return wrap_loader(loader); }, ttl);
+            co_return std::move(*value);
+        }
+
+        // 同上，loader 返回 Task<std::optional<V>>，结果为空时不写入缓存，合并等待的调用者也得到空
+        template <typename Loader>
+            requires std::invocable<Loader&> &&
+                     std::convertible_to<std::invoke_result_t<Loader&>, Task<std::optional<V>>>
+        Task<std::optional<V>> get_or_load_if(K key, Loader loader,
+                                              std::optional<std::chrono::milliseconds> ttl = std::nullopt) {
+            if (auto value = lookup(key, true)) {
+                co_return value;
+            }
+            co_return co_await m_flight.run(key, [&] { return load(key, loader, ttl); });
+        }
+
+        Stats stats() const {
+            Stats stats;
+            for (const auto& shard : m_shards) {
+                std::scoped_lock lk{shard->m_mutex};
+                stats.hits += shard->m_hits;
+                stats.misses += shard->m_misses;
+                stats.evictions += shard->m_evictions;
+                stats.expirations += shard->m_expirations;
+            }
+            stats.loads = m_loads.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        std::size_t size() const {
+            std::size_t size{0};
+            for (const auto& shard : m_shards) {
+                std::scoped_lock lk{shard->m_mutex};
+                size += shard->m_index.size();
+            }
+            return size;
+        }
+
+    private:
+        struct Node {
+            K m_key;
+            V m_value;
+            IoScheduler::time_point m_deadline;
+            // 等待中的定时器，由定时协程和条目共同持有；没有 TTL 时为空
+            std::shared_ptr<detail::PollInfo> m_timer;
+        };
+
+        using Index = std::unordered_map<K, typename std::list<Node>::iterator, Hash, KeyEqual>;
+
+        struct Shard {
+            Shard(IoScheduler& scheduler, std::size_t capacity) : m_scheduler(scheduler), m_capacity(capacity) {}
+
+            ~Shard() {
+                for (auto& node : m_lru) {
+                    cancel(node);
+                }
+            }
+
+            void put(K key, V value, IoScheduler::time_point deadline, std::shared_ptr<detail::PollInfo> timer) {
+                std::scoped_lock lk{m_mutex};
+                auto it = m_index.find(key);
+                if (it != m_index.end()) {
+                    auto node = it->second;
+                    cancel(*node);
+                    node->m_value = std::move(value);
+                    node->m_deadline = deadline;
+                    node->m_timer = std::move(timer);
+                    m_lru.splice(m_lru.begin(), m_lru, node);
+                    return;
+                }
+                m_lru.push_front(Node{key, std::move(value), deadline, std::move(timer)});
+                m_index.emplace(std::move(key), m_lru.begin());
+                if (m_index.size() > m_capacity) {
+                    remove(m_index.find(m_lru.back().m_key));
+                    ++m_evictions;
+                }
+            }
+
+            // 定时器到期：条目仍然是设置这个定时器的那一版时删除
+            void expire(const K& key, const std::shared_ptr<detail::PollInfo>& timer) {
+                std::scoped_lock lk{m_mutex};
+                auto it = m_index.find(key);
+                if (it != m_index.end() && it->second->m_timer == timer) {
+                    it->second->m_timer.reset();
+                    remove(it);
+                    ++m_expirations;
+                }
+            }
+
+            // 以下需持有 m_mutex
+            void remove(typename Index::iterator it) {
+                cancel(*it->second);
+                m_lru.erase(it->second);
+                m_index.erase(it);
+            }
+
+            // 让等待中的定时协程立即结束；已经超时的由它自己在 expire 中发现条目不再属于它
+            void cancel(Node& node) {
+                if (auto timer = std::exchange(node.m_timer, nullptr)) {
+                    m_scheduler.notify_waiter(*timer);
+                }
+            }
+
+            IoScheduler& m_scheduler;
+            const std::size_t m_capacity;
+            mutable std::mutex m_mutex;
+            // 头部是最近使用的条目
+            std::list<Node> m_lru;
+            Index m_index;
+            // 以下需持有 m_mutex
+            std::size_t m_hits{0};
+            std::size_t m_misses{0};
+            std::size_t m_evictions{0};
+            std::size_t m_expirations{0};
+        };
+
+        std::shared_ptr<Shard>& shard_for(const K& key) { return m_shards[Hash{}(key) % m_shards.size()]; }
+
+        // count 为 false 时不计入命中 / 未命中，用于加载之前的再次检查
+        std::optional<V> lookup(const K& key, bool count) {
+            auto& shard = *shard_for(key);
+            std::scoped_lock lk{shard.m_mutex};
+            auto it = shard.m_index.find(key);
+            if (it != shard.m_index.end() && it->second->m_deadline <= IoScheduler::clock::now()) {
+                // 已经过期，定时器还没有触发
+                shard.remove(it);
+                ++shard.m_expirations;
+                it = shard.m_index.end();
+            }
+            if (it == shard.m_index.end()) {
+                shard.m_misses += count;
+                return std::nullopt;
+            }
+            shard.m_hits += count;
+            shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it->second);
+            return it->second->m_value;
+        }
+
+        template <typename Loader>
+        Task<std::optional<V>> load(const K& key, Loader& loader, std::optional<std::chrono::milliseconds> ttl) {
+            // 未命中之后、合并之前，上一次加载可能刚刚写入
+            if (auto value = lookup(key, false)) {
+                co_return value;
+            }
+            m_loads.fetch_add(1, std::memory_order_relaxed);
+            auto value = co_await std::invoke(loader);
+            if (value) {
+                put(key, *value, ttl);
+            }
+            co_return value;
+        }
+
+        template <typename Loader>
+        static Task<std::optional<V>> wrap_loader(Loader& loader) {
+            co_return co_await std::invoke(loader);
+        }
+
+        static Task<> expire_after(IoScheduler& scheduler, std::weak_ptr<Shard> shard, K key,
+                                   std::shared_ptr<detail::PollInfo> timer, std::chrono::milliseconds ttl) {
+            if (co_await scheduler.wait_notified(*timer, ttl) != PollStatus::Timeout) {
+                // 条目被覆盖、淘汰或删除
+                co_return;
+            }
+            if (auto locked = shard.lock()) {
+                locked->expire(key, timer);
+            }
+        }
+
+        std::shared_ptr<IoScheduler> m_scheduler;
+        Options m_opts;
+        std::vector<std::shared_ptr<Shard>> m_shards;
+        std::atomic<std::size_t> m_loads{0};
+        SingleFlight<K, std::optional<V>, Hash, KeyEqual> m_flight;
+    };
+
+} // namespace coro
+
+#endif //CORO_ASYNC_CACHE_HPP
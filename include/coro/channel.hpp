@@ -0,0 +1,469 @@
+#ifndef CORO_CHANNEL_HPP
+#define CORO_CHANNEL_HPP
+
+#include "coro/io_scheduler.hpp"
+#include "coro/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro {
+
+    /**
+     * 有界的多生产者多消费者通道，在协程之间（可以在不同的工作线程上）传递数据。
+     * 数据放在按 2 的幂取整的环形缓冲区中，每个格子带序号（Vyukov 队列），缓冲区不满 / 不空时
+     * send / recv 只有几次原子操作，不加锁。缓冲区满时发送者挂起，形成背压；空时接收者挂起。
+     * 挂起的一方由对面在操作成功后直接代为完成再恢复：发送者的数据被放进缓冲区，接收者拿到数据才恢复。
+     * 等待者由构造时指定的 IoScheduler / ThreadPool 恢复，没有指定时在对面的线程上直接恢复。
+     * close 之后 send 返回 false，recv 取完剩余的数据之后返回空
+     */
+    template <typename T>
+    class Channel {
+        static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                      "Channel<T> requires T to be nothrow movable");
+
+    public:
+        explicit Channel(std::size_t capacity) : Channel(capacity, nullptr, nullptr) {}
+        Channel(std::size_t capacity, std::shared_ptr<IoScheduler> scheduler)
+            : Channel(capacity, std::move(scheduler), nullptr) {}
+        Channel(std::size_t capacity, ThreadPool& pool) : Channel(capacity, nullptr, &pool) {}
+
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        ~Channel() {
+            while (try_pop([](T&&) {})) {
+            }
+        }
+
+    private:
+        struct SendWaiter {
+            SendWaiter* m_prev{nullptr};
+            SendWaiter* m_next{nullptr};
+            std::coroutine_handle<> m_handle;
+            T* m_value{nullptr};
+            bool m_ok{false};
+        };
+
+        struct RecvWaiter {
+            RecvWaiter* m_prev{nullptr};
+            RecvWaiter* m_next{nullptr};
+            std::coroutine_handle<> m_handle;
+            // recv 的结果写入 m_result，recv_many 的写入 m_slot
+            std::optional<T>* m_result{nullptr};
+            T* m_slot{nullptr};
+            bool m_received{false};
+
+            void deliver(T&& value) noexcept {
+                if (m_slot != nullptr) {
+                    *m_slot = std::move(value);
+                } else {
+                    m_result->emplace(std::move(value));
+                }
+                m_received = true;
+            }
+        };
+
+    public:
+        class SendAwaiter : private SendWaiter {
+        public:
+            SendAwaiter(Channel& channel, T value) noexcept : m_channel(channel), m_storage(std::move(value)) {
+                this->m_value = &m_storage;
+            }
+
+            bool await_ready() noexcept {
+                if (m_channel.m_closed.load(std::memory_order_acquire)) {
+                    return true;
+                }
+                this->m_ok = m_channel.try_send(m_storage);
+                return this->m_ok;
+            }
+            bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
+                this->m_handle = awaiting_coroutine;
+                return m_channel.suspend_sender(*this);
+            }
+            // 通道已经关闭时返回 false，数据被丢弃
+            bool await_resume() noexcept { return this->m_ok; }
+
+        private:
+            Channel& m_channel;
+            T m_storage;
+        };
+
+        class RecvAwaiter : private RecvWaiter {
+        public:
+            explicit RecvAwaiter(Channel& channel) noexcept : m_channel(channel) { this->m_result = &m_storage; }
+
+            bool await_ready() noexcept {
+                if (m_channel.try_pop([this](T&& value) { this->deliver(std::move(value)); })) {
+                    m_channel.wake_senders(1);
+                    return true;
+                }
+                return m_channel.drained();
+            }
+            bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
+                this->m_handle = awaiting_coroutine;
+                return m_channel.suspend_receiver(*this);
+            }
+            // 通道已经关闭并且取完时为空
+            std::optional<T> await_resume() noexcept { return std::move(m_storage); }
+
+        private:
+            Channel& m_channel;
+            std::optional<T> m_storage;
+        };
+
+        class RecvManyAwaiter : private RecvWaiter {
+        public:
+            RecvManyAwaiter(Channel& channel, std::span<T> out) noexcept : m_channel(channel), m_out(out) {}
+
+            bool await_ready() noexcept {
+                m_count = m_channel.try_recv_many(m_out);
+                return m_count > 0 || m_out.empty() || m_channel.drained();
+            }
+            bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
+                this->m_handle = awaiting_coroutine;
+                this->m_slot = m_out.data();
+                return m_channel.suspend_receiver(*this);
+            }
+            // 取得的个数，至少为 1；通道已经关闭并且取完时为 0
+            std::size_t await_resume() noexcept {
+                if (this->m_received) {
+                    // 被代为接收了第一个，剩下的位置用缓冲区中已有的数据填满
+                    m_count = 1 + m_channel.try_recv_many(m_out.subspan(1));
+                }
+                return m_count;
+            }
+
+        private:
+            Channel& m_channel;
+            std::span<T> m_out;
+            std::size_t m_count{0};
+        };
+
+        // co_await 的结果为 false 表示通道已经关闭；缓冲区满时挂起直到有空位
+        [[nodiscard]] SendAwaiter send(T value) noexcept { return SendAwaiter{*this, std::move(value)}; }
+
+        // co_await 的结果为空表示通道已经关闭并且取完；缓冲区空时挂起直到有数据
+        [[nodiscard]] RecvAwaiter recv() noexcept { return RecvAwaiter{*this}; }
+
+        // 取出至少 1 个、至多 out.size() 个数据，只在缓冲区空时挂起；co_await 的结果是取得的个数
+        [[nodiscard]] RecvManyAwaiter recv_many(std::span<T> out) noexcept { return RecvManyAwaiter{*this, out}; }
+
+        // 缓冲区有空位并且没有关闭时放入，成功时 value 被移走
+        bool try_send(T& value) {
+            if (m_closed.load(std::memory_order_acquire) || !try_push(value)) {
+                return false;
+            }
+            wake_receiver();
+            return true;
+        }
+
+        std::optional<T> try_recv() {
+            std::optional<T> result;
+            if (try_pop([&result](T&& value) { result.emplace(std::move(value)); })) {
+                wake_senders(1);
+            }
+            return result;
+        }
+
+        // 不挂起地取出至多 out.size() 个数据，返回个数
+        std::size_t try_recv_many(std::span<T> out) {
+            std::size_t count{0};
+            while (count < out.size() && try_pop([&](T&& value) { out[count] = std::move(value); })) {
+                ++count;
+            }
+            if (count > 0) {
+                wake_senders(count);
+            }
+            return count;
+        }
+
+        // 关闭通道，恢复所有等待者：发送者得到 false，接收者取走剩余的数据或者得到空
+        void close() {
+            m_closed.store(true, std::memory_order_seq_cst);
+            std::vector<std::coroutine_handle<>> ready;
+            {
+                std::scoped_lock lk{m_mutex};
+                while (auto* waiter = pop_front(m_recv_head, m_recv_tail)) {
+                    try_pop([waiter](T&& value) { waiter->deliver(std::move(value)); });
+                    ready.push_back(waiter->m_handle);
+                }
+                while (auto* waiter = pop_front(m_send_head, m_send_tail)) {
+                    waiter->m_ok = false;
+                    ready.push_back(waiter->m_handle);
+                }
+                m_recv_waiting.store(0, std::memory_order_relaxed);
+                m_send_waiting.store(0, std::memory_order_relaxed);
+            }
+            for (auto handle : ready) {
+                resume(handle);
+            }
+        }
+
+        bool closed() const noexcept { return m_closed.load(std::memory_order_acquire); }
+        std::size_t capacity() const noexcept { return m_mask + 1; }
+
+    private:
+        // 环形缓冲区的格子：序号等于位置时可写，等于位置 + 1 时可读
+        struct Cell {
+            std::atomic<std::size_t> m_sequence;
+            alignas(T) std::byte m_storage[sizeof(T)];
+
+            T* value() noexcept { return std::launder(reinterpret_cast<T*>(m_storage)); }
+        };
+
+        Channel(std::size_t capacity, std::shared_ptr<IoScheduler> scheduler, ThreadPool* pool)
+            : m_mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+              m_cells(std::make_unique<Cell[]>(m_mask + 1)),
+              m_scheduler(std::move(scheduler)),
+              m_pool(pool) {
+            for (std::size_t i = 0; i <= m_mask; ++i) {
+                m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool try_push(T& value) noexcept {
+            auto pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &m_cells[pos & m_mask];
+                auto sequence = cell->m_sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            ::new (static_cast<void*>(cell->m_storage)) T(std::move(value));
+            cell->m_sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename Sink>
+        bool try_pop(Sink&& sink) noexcept {
+            auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &m_cells[pos & m_mask];
+                auto sequence = cell->m_sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            sink(std::move(*cell->value()));
+            cell->value()->~T();
+            cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 已经关闭并且缓冲区为空
+        bool drained() noexcept {
+            return m_closed.load(std::memory_order_acquire) &&
+                   m_dequeue_pos.load(std::memory_order_acquire) == m_enqueue_pos.load(std::memory_order_acquire);
+        }
+
+        /**
+         * 等待者先在锁内登记（计数加一），再重新尝试一次；成功操作的一方先完成操作，再读对面的计数。
+         * 两边之间都有 seq_cst 屏障，至少有一方能看到另一方，所以不会丢失唤醒
+         */
+        bool suspend_sender(SendWaiter& waiter) noexcept {
+            {
+                std::scoped_lock lk{m_mutex};
+                if (m_closed.load(std::memory_order_acquire)) {
+                    waiter.m_ok = false;
+                    return false;
+                }
+                m_send_waiting.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!try_push(*waiter.m_value)) {
+                    push_back(m_send_head, m_send_tail, &waiter);
+                    return true;
+                }
+                m_send_waiting.fetch_sub(1, std::memory_order_relaxed);
+            }
+            waiter.m_ok = true;
+            wake_receiver();
+            return false;
+        }
+
+        bool suspend_receiver(RecvWaiter& waiter) noexcept {
+            {
+                std::scoped_lock lk{m_mutex};
+                m_recv_waiting.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!try_pop([&waiter](T&& value) { waiter.deliver(std::move(value)); })) {
+                    if (!m_closed.load(std::memory_order_acquire)) {
+                        push_back(m_recv_head, m_recv_tail, &waiter);
+                        return true;
+                    }
+                    // 已经关闭并且取完
+                    m_recv_waiting.fetch_sub(1, std::memory_order_relaxed);
+                    return false;
+                }
+                m_recv_waiting.fetch_sub(1, std::memory_order_relaxed);
+            }
+            wake_senders(1);
+            return false;
+        }
+
+        // 放入数据之后调用：有接收者在等待时替它取一个数据，然后恢复它
+        void wake_receiver() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_recv_waiting.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            std::coroutine_handle<> handle;
+            {
+                std::scoped_lock lk{m_mutex};
+                auto* waiter = pop_front(m_recv_head, m_recv_tail);
+                if (waiter == nullptr) {
+                    return;
+                }
+                if (!try_pop([waiter](T&& value) { waiter->deliver(std::move(value)); })) {
+                    // 数据已经被别的接收者取走，继续等待
+                    push_front(m_recv_head, m_recv_tail, waiter);
+                    return;
+                }
+                m_recv_waiting.fetch_sub(1, std::memory_order_relaxed);
+                handle = waiter->m_handle;
+            }
+            resume(handle);
+            // 取走数据又空出了一个位置
+            wake_senders(1);
+        }
+
+        // 取出 count 个数据之后调用：替等待的发送者放入数据，然后恢复它们
+        void wake_senders(std::size_t count) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_send_waiting.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            SendWaiter* ready{nullptr};
+            std::size_t pushed{0};
+            {
+                std::scoped_lock lk{m_mutex};
+                for (; pushed < count; ++pushed) {
+                    auto* waiter = pop_front(m_send_head, m_send_tail);
+                    if (waiter == nullptr) {
+                        break;
+                    }
+                    if (!try_push(*waiter->m_value)) {
+                        // 空位已经被别的发送者占用，继续等待
+                        push_front(m_send_head, m_send_tail, waiter);
+                        break;
+                    }
+                    m_send_waiting.fetch_sub(1, std::memory_order_relaxed);
+                    waiter->m_ok = true;
+                    waiter->m_next = ready;
+                    ready = waiter;
+                }
+            }
+            while (ready != nullptr) {
+                auto* waiter = ready;
+                ready = waiter->m_next;
+                resume(waiter->m_handle);
+            }
+            // 替发送者放入的数据可能有接收者在等
+            for (std::size_t i = 0; i < pushed; ++i) {
+                wake_receiver();
+            }
+        }
+
+        void resume(std::coroutine_handle<> handle) {
+            if (m_scheduler && m_scheduler->resume(handle)) {
+                return;
+            }
+            if (m_pool != nullptr && m_pool->resume(handle)) {
+                return;
+            }
+            handle.resume();
+        }
+
+        template <typename Waiter>
+        static void push_back(Waiter*& head, Waiter*& tail, Waiter* waiter) noexcept {
+            waiter->m_prev = tail;
+            waiter->m_next = nullptr;
+            if (tail != nullptr) {
+                tail->m_next = waiter;
+            } else {
+                head = waiter;
+            }
+            tail = waiter;
+        }
+
+        template <typename Waiter>
+        static void push_front(Waiter*& head, Waiter*& tail, Waiter* waiter) noexcept {
+            waiter->m_prev = nullptr;
+            waiter->m_next = head;
+            if (head != nullptr) {
+                head->m_prev = waiter;
+            } else {
+                tail = waiter;
+            }
+            head = waiter;
+        }
+
+        template <typename Waiter>
+        static Waiter* pop_front(Waiter*& head, Waiter*& tail) noexcept {
+            auto* waiter = head;
+            if (waiter != nullptr) {
+                head = waiter->m_next;
+                if (head != nullptr) {
+                    head->m_prev = nullptr;
+                } else {
+                    tail = nullptr;
+                }
+            }
+            return waiter;
+        }
+
+        static constexpr std::size_t cache_line = 64;
+
+        const std::size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+        // 生产者和消费者的位置放在不同的缓存行，避免伪共享
+        alignas(cache_line) std::atomic<std::size_t> m_enqueue_pos{0};
+        alignas(cache_line) std::atomic<std::size_t> m_dequeue_pos{0};
+
+        alignas(cache_line) std::atomic<bool> m_closed{false};
+        // 等待者的个数，在锁内修改，快速路径在锁外读取以判断是否需要唤醒
+        std::atomic<std::size_t> m_send_waiting{0};
+        std::atomic<std::size_t> m_recv_waiting{0};
+        std::mutex m_mutex;
+        SendWaiter* m_send_head{nullptr};
+        SendWaiter* m_send_tail{nullptr};
+        RecvWaiter* m_recv_head{nullptr};
+        RecvWaiter* m_recv_tail{nullptr};
+
+        std::shared_ptr<IoScheduler> m_scheduler;
+        ThreadPool* m_pool{nullptr};
+    };
+
+} // namespace coro
+
+#endif //CORO_CHANNEL_HPP
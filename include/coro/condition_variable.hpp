@@ -0,0 +1,64 @@
+#ifndef CORO_CONDITION_VARIABLE_HPP
+#define CORO_CONDITION_VARIABLE_HPP
+
+#include "coro/mutex.hpp"
+#include "coro/task.hpp"
+
+#include <coroutine>
+#include <mutex>
+
+namespace coro {
+
+    /**
+     * 配合 Mutex 使用的协程条件变量。wait 把协程放入等待队列并释放锁，挂起期间不占用线程；
+     * 被通知后重新加锁，取得锁之后才恢复，和 Mutex 一样由它的执行器恢复。
+     * 等待队列由一个 std::mutex 保护，只在几次指针操作期间持有，不会跨越挂起
+     */
+    class ConditionVariable {
+    public:
+        ConditionVariable() = default;
+        ConditionVariable(const ConditionVariable&) = delete;
+        ConditionVariable& operator=(const ConditionVariable&) = delete;
+
+        class WaitAwaiter : private Mutex::Waiter {
+        public:
+            WaitAwaiter(ConditionVariable& cv, Mutex& mutex) noexcept : m_cv(cv), m_mutex(mutex) {}
+
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept;
+            void await_resume() noexcept {}
+
+        private:
+            friend class ConditionVariable;
+
+            ConditionVariable& m_cv;
+            Mutex& m_mutex;
+            WaitAwaiter* m_cv_next{nullptr};
+        };
+
+        // 调用时必须持有 lock，恢复时重新持有；和 std::condition_variable 一样可能虚假唤醒
+        [[nodiscard]] WaitAwaiter wait(ScopedLock& lock) noexcept { return WaitAwaiter{*this, *lock.mutex()}; }
+
+        // 等到 pred() 为 true，pred 在持有锁时调用
+        template <typename Predicate>
+        [[nodiscard]] Task<> wait(ScopedLock& lock, Predicate pred) {
+            while (!pred()) {
+                co_await wait(lock);
+            }
+        }
+
+        void notify_one();
+        void notify_all();
+
+    private:
+        // 被通知的等待者重新加锁，立即取得锁时恢复它
+        static void relock(WaitAwaiter& waiter);
+
+        std::mutex m_waiters_mutex;
+        WaitAwaiter* m_head{nullptr};
+        WaitAwaiter* m_tail{nullptr};
+    };
+
+} // namespace coro
+
+#endif //CORO_CONDITION_VARIABLE_HPP
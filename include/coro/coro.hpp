@@ -13,12 +13,20 @@
 #include "coro/net/socket.hpp"
 #include "coro/net/tcp/client.hpp"
 #include "coro/net/tcp/http/http_server.hpp"
+#include "coro/net/tcp/http/response_cache.hpp"
 #include "coro/net/tcp/server.hpp"
+#include "coro/net/tcp/server_group.hpp"
 
 #endif
 
+#include "coro/async_cache.hpp"
+#include "coro/channel.hpp"
+#include "coro/condition_variable.hpp"
 #include "coro/io_scheduler.hpp"
+#include "coro/mutex.hpp"
 #include "coro/poll.hpp"
+#include "coro/semaphore.hpp"
+#include "coro/single_flight.hpp"
 #include "coro/sync_wait.hpp"
 #include "coro/task.hpp"
 #include "coro/thread_pool.hpp"
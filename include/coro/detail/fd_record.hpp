@@ -0,0 +1,41 @@
+#ifndef CORO_FD_RECORD_HPP
+#define CORO_FD_RECORD_HPP
+
+#include <sys/epoll.h>
+
+#include <cstdint>
+#include <mutex>
+
+#include "coro/detail/poll_info.hpp"
+
+namespace coro::detail {
+
+    /**
+     * 以 EPOLLET 常驻在 epoll 中的 fd 的就绪状态，epoll_event.data.ptr 指向它（最低位置 1，以区别于 PollInfo）
+     * 边沿事件到来时由 IO 线程记录在对应方向上，直到调用方遇到 EAGAIN 才清除，因此 poll 只在未就绪时挂起。
+     * 所有字段由 m_mutex 保护；注销后由 IO 线程延迟释放，保证 epoll_wait 已经返回的事件不会访问悬空指针。
+     */
+    struct FdRecord {
+        static constexpr std::uint32_t read_events = EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR;
+        static constexpr std::uint32_t write_events = EPOLLOUT | EPOLLHUP | EPOLLERR;
+
+        struct Direction {
+            std::uint32_t m_events{0};      // 上次清除之后收到的事件，非 0 表示就绪
+            std::uint64_t m_sequence{0};    // 收到边沿事件的次数，清除前用来判断是否又有新的事件
+            PollInfo* m_waiter{nullptr};    // 正在等待这个方向的 poll，同一时间只能有一个
+        };
+
+        explicit FdRecord(int fd) : m_fd(fd) {}
+        FdRecord(const FdRecord&) = delete;
+        FdRecord& operator=(const FdRecord&) = delete;
+        ~FdRecord() = default;
+
+        int m_fd{-1};
+        std::mutex m_mutex;
+        Direction m_read;
+        Direction m_write;
+    };
+
+} // namespace coro::detail
+
+#endif //CORO_FD_RECORD_HPP
@@ -0,0 +1,26 @@
+#ifndef CORO_FRAME_ALLOCATOR_HPP
+#define CORO_FRAME_ALLOCATOR_HPP
+
+#include <cstddef>
+
+namespace coro::detail {
+
+    /**
+     * 协程帧的池化分配器，由 Promise 的 operator new/delete 使用
+     * 每个线程按 16 字节一档的大小类维护本地空闲链表，分配和同线程释放都不需要加锁；
+     * 在其他线程释放的帧通过无锁栈还给所属线程，由它在下次分配时取回。
+     * 每块前面有 16 字节的头部记录所属线程和大小类，超过 2048 字节的帧直接使用全局 operator new。
+     */
+    class FrameAllocator {
+    public:
+        static void* allocate(std::size_t size);
+        static void deallocate(void* ptr) noexcept;
+
+        // 运行时开关，关闭后新分配的帧直接使用全局 operator new（已分配的帧照常释放），用于对比测试
+        static void set_enabled(bool enabled) noexcept;
+        static bool enabled() noexcept;
+    };
+
+} // namespace coro::detail
+
+#endif //CORO_FRAME_ALLOCATOR_HPP
@@ -0,0 +1,109 @@
+#ifndef CORO_IO_URING_HPP
+#define CORO_IO_URING_HPP
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+namespace coro::detail {
+
+    // 一次通过 io_uring 提交的异步操作，user_data 指向它，完成时由 IO 线程回填结果并恢复等待的协程
+    struct UringOp {
+        UringOp() = default;
+        auto operator=(UringOp&&) = delete;
+        ~UringOp() = default;
+
+        io_uring_sqe m_sqe{};                      // 预先填好的 sqe，提交时拷贝进提交队列
+        bool m_has_timeout{false};                 // 是否追加一个 IORING_OP_LINK_TIMEOUT
+        __kernel_timespec m_timeout{};             // LINK_TIMEOUT/TIMEOUT 使用的时间
+        std::coroutine_handle<> m_awaiting_handle; // co_await 所在的协程
+        int m_result{0};                           // cqe->res，>=0 为结果，<0 为 -errno
+    };
+
+    /**
+     * 对 io_uring 原始系统调用的最小封装（不依赖 liburing）
+     * 提交队列可能被多个线程使用，调用方负责加锁；完成队列只能由一个线程消费。
+     */
+    class IoUring {
+    public:
+        // 创建失败（内核不支持、被 seccomp 禁止等）时抛出 std::system_error
+        explicit IoUring(unsigned entries = 4096);
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+        ~IoUring();
+
+        int fd() const noexcept { return m_ring_fd; }
+
+        // 获取一个空闲 sqe，提交队列满时返回 nullptr
+        io_uring_sqe* get_sqe() noexcept;
+
+        // 提交队列剩余的空位
+        unsigned sq_space() const noexcept;
+
+        // 是否还有内核没有取走的 sqe
+        bool has_unsubmitted() const noexcept;
+
+        // 提交所有已填写的 sqe，返回提交数量或 -errno；失败时 sqe 保留在队列中，下次 submit() 会重新提交
+        int submit() noexcept;
+
+        // 依次处理完成队列中已有的 cqe，返回处理的数量
+        template<typename F>
+        std::size_t for_each_cqe(F&& on_cqe) {
+            std::size_t count{0};
+            while (true) {
+                auto head = *m_cq_head;
+                auto tail = std::atomic_ref<unsigned>(*m_cq_tail).load(std::memory_order_acquire);
+                if (head == tail) {
+                    // 完成队列溢出时内核会把剩余的 cqe 暂存起来，需要 GETEVENTS 才会刷回完成队列
+                    if (!cq_overflowed() || flush_overflow() < 0) {
+                        break;
+                    }
+                    if (*m_cq_head == std::atomic_ref<unsigned>(*m_cq_tail).load(std::memory_order_acquire)) {
+                        break;
+                    }
+                    continue;
+                }
+
+                for (; head != tail; ++head) {
+                    on_cqe(m_cqes[head & *m_cq_mask]);
+                    ++count;
+                }
+                std::atomic_ref<unsigned>(*m_cq_head).store(head, std::memory_order_release);
+            }
+            return count;
+        }
+
+    private:
+        bool cq_overflowed() const noexcept;
+        int flush_overflow() noexcept;
+
+        int m_ring_fd{-1};
+
+        void* m_sq_ring{nullptr};
+        std::size_t m_sq_ring_size{0};
+        void* m_cq_ring{nullptr};
+        std::size_t m_cq_ring_size{0};
+        io_uring_sqe* m_sqes{nullptr};
+        std::size_t m_sqes_size{0};
+
+        unsigned* m_sq_head{nullptr};
+        unsigned* m_sq_tail{nullptr};
+        unsigned* m_sq_mask{nullptr};
+        unsigned* m_sq_entries{nullptr};
+        unsigned* m_sq_flags{nullptr};
+        unsigned* m_sq_array{nullptr};
+        unsigned m_sq_local_tail{0};   // 已填写但尚未提交的 sqe 的尾部
+        unsigned m_sq_submitted{0};    // 已经发布给内核的尾部
+
+        unsigned* m_cq_head{nullptr};
+        unsigned* m_cq_tail{nullptr};
+        unsigned* m_cq_mask{nullptr};
+        io_uring_cqe* m_cqes{nullptr};
+    };
+
+} // namespace coro::detail
+
+#endif //CORO_IO_URING_HPP
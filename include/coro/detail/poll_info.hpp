@@ -2,20 +2,21 @@
 #define CORO_POLL_INFO_HPP
 
 #include <chrono>
-#include <map>
-#include <optional>
 #include <atomic>
 #include <coroutine>
 
 #include "coro/poll.hpp"
+#include "coro/detail/timing_wheel.hpp"
 
 namespace coro::detail {
 
+    struct FdRecord;
+
     // 等待 poll 事件时保存的详细信息，类似于reactor模型中channel的作用
-    struct PollInfo {
+    // 继承 TimerNode，带超时的 poll 直接把自身挂到时间轮上（m_expire_tick 非 0 表示设置过超时）
+    struct PollInfo : TimerNode {
         using clock = std::chrono::steady_clock;
         using time_point = clock::time_point;
-        using timed_events = std::multimap<time_point, PollInfo*>;
 
         PollInfo() = default;
         auto operator=(PollInfo&&) = delete;
@@ -37,7 +38,7 @@ namespace coro::detail {
         auto operator co_await() { return PollAwaiter{*this}; }
 
         int m_fd{-1};   // poll operation 对应的 fd
-        std::optional<timed_events::iterator> m_timer_pos {std::nullopt};  // 记录定时事件在multi_map中的位置
+        FdRecord* m_record{nullptr};  // 常驻注册的 fd 的 poll 指向其就绪状态，此时 m_fd 为 -1，不需要 EPOLL_CTL_DEL
         PollStatus m_poll_status {PollStatus::Error};  // poll operation 完成后返回的状态
         std::coroutine_handle<> m_awaiting_handle;    // 记录 co_await pi 时所在的协程，当poll operation 返回时恢复到之前的协程
         std::atomic<bool> m_processed{false};     // poll operation 是否被处理，事件本身和定时事件（如果该事件超时）只能处理一次
@@ -26,6 +26,10 @@ namespace coro::detail {
 
         ~SelfDeletingPromise() = default;
 
+        // 与 Task 的协程帧共用帧池
+        static void* operator new(std::size_t size) { return FrameAllocator::allocate(size); }
+        static void operator delete(void* ptr) noexcept { FrameAllocator::deallocate(ptr); }
+
         SelfDeletingTask get_return_object();
         auto initial_suspend() { return std::suspend_always{}; }
         auto final_suspend() noexcept {
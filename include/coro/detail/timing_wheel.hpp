@@ -0,0 +1,90 @@
+#ifndef CORO_TIMING_WHEEL_HPP
+#define CORO_TIMING_WHEEL_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace coro::detail {
+
+    // 侵入式定时器节点，需要定时的对象（如 PollInfo）继承它，插入和取消都不需要额外分配内存
+    struct TimerNode {
+        TimerNode() = default;
+        TimerNode(const TimerNode&) = delete;
+        TimerNode& operator=(const TimerNode&) = delete;
+        ~TimerNode() = default;
+
+        bool is_linked() const noexcept { return m_prev != nullptr; }
+
+        TimerNode* m_prev{nullptr};
+        TimerNode* m_next{nullptr};
+        std::uint64_t m_expire_tick{0};  // 到期的 tick（相对于时间轮的起点）
+        std::uint8_t m_level{0};         // 所在的层，取消时用于维护每层的计数
+    };
+
+    /**
+     * 分层时间轮：4 层，每层 256 个槽，1 个 tick 默认 1ms，可以覆盖约 49 天
+     * 插入、取消都是 O(1)；高层槽里的定时器在低层转完一圈时逐级下沉（cascade）。
+     * 本身不加锁，由调用方保证互斥。
+     */
+    class TimingWheel {
+    public:
+        using clock = std::chrono::steady_clock;
+        using time_point = clock::time_point;
+
+        static constexpr std::size_t slot_bits = 8;
+        static constexpr std::size_t slot_count = std::size_t{1} << slot_bits;
+        static constexpr std::size_t slot_mask = slot_count - 1;
+        static constexpr std::size_t level_count = 4;
+
+        explicit TimingWheel(time_point origin = clock::now(),
+                             std::chrono::nanoseconds tick = std::chrono::milliseconds(1));
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+        ~TimingWheel() = default;
+
+        // 插入定时器，返回它到期的 tick
+        std::uint64_t add(TimerNode& node, time_point expiry);
+
+        // 取消定时器，节点不在时间轮中时什么也不做
+        void remove(TimerNode& node) noexcept;
+
+        // 推进到 now，把到期的节点摘下放入 expired
+        void advance(time_point now, std::vector<TimerNode*>& expired);
+
+        // 下一次需要调用 advance() 的 tick：最早到期的 tick 或下一次 cascade 的边界，没有定时器时为空
+        std::optional<std::uint64_t> next_tick() const noexcept;
+
+        // tick 对应的时间点
+        time_point tick_to_time(std::uint64_t tick) const noexcept { return m_origin + m_tick * tick; }
+
+        std::size_t size() const noexcept { return m_count; }
+        bool empty() const noexcept { return m_count == 0; }
+
+    private:
+        std::uint64_t time_to_tick(time_point tp) const noexcept;
+        void place(TimerNode& node) noexcept;
+        void cascade(std::size_t level, std::size_t index) noexcept;
+        void process_tick(std::uint64_t tick, std::vector<TimerNode*>& expired);
+
+        TimerNode& slot(std::size_t level, std::size_t index) noexcept { return m_slots[level * slot_count + index]; }
+        const TimerNode& slot(std::size_t level, std::size_t index) const noexcept {
+            return m_slots[level * slot_count + index];
+        }
+
+        time_point m_origin;
+        std::chrono::nanoseconds m_tick;
+        std::uint64_t m_current{0};   // 已经处理完的最后一个 tick
+        std::size_t m_count{0};
+
+        // 每个槽是一个以哨兵节点为头的双向循环链表
+        std::array<TimerNode, level_count * slot_count> m_slots;
+        std::array<std::size_t, level_count> m_level_counts{};
+    };
+
+} // namespace coro::detail
+
+#endif //CORO_TIMING_WHEEL_HPP
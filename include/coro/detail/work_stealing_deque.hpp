@@ -0,0 +1,141 @@
+#ifndef CORO_WORK_STEALING_DEQUE_HPP
+#define CORO_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace coro::detail {
+
+    /**
+     * Chase-Lev 无锁工作窃取双端队列（Lê et al. 2013 的 C11 内存序版本）
+     * 只有拥有者线程可以调用 push()/pop()，在底部做 LIFO 操作；其他线程通过 steal() 从顶部窃取。
+     * 扩容后的旧数组不会立即释放（窃取者可能仍在读取），在队列析构时统一回收。
+     */
+    template<typename T>
+    class WorkStealingDeque {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque only holds trivially copyable values");
+
+        class Array {
+        public:
+            explicit Array(std::size_t capacity) : m_mask(capacity - 1), m_buffer(capacity) {}
+
+            std::size_t capacity() const noexcept { return m_mask + 1; }
+
+            void put(std::int64_t i, T value) noexcept {
+                m_buffer[static_cast<std::size_t>(i) & m_mask].store(value, std::memory_order_relaxed);
+            }
+
+            T get(std::int64_t i) const noexcept {
+                return m_buffer[static_cast<std::size_t>(i) & m_mask].load(std::memory_order_relaxed);
+            }
+
+            Array* grow(std::int64_t bottom, std::int64_t top) const {
+                auto* next = new Array(capacity() * 2);
+                for (std::int64_t i = top; i != bottom; ++i) {
+                    next->put(i, get(i));
+                }
+                return next;
+            }
+
+        private:
+            std::size_t m_mask;
+            std::vector<std::atomic<T>> m_buffer;
+        };
+
+    public:
+        // capacity 必须是 2 的幂
+        explicit WorkStealingDeque(std::size_t capacity = 256) : m_array(new Array(capacity)) {
+            m_garbage.emplace_back(m_array.load(std::memory_order_relaxed));
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+        ~WorkStealingDeque() = default;
+
+        // 仅拥有者线程调用
+        void push(T value) {
+            auto b = m_bottom.load(std::memory_order_relaxed);
+            auto t = m_top.load(std::memory_order_acquire);
+            auto* a = m_array.load(std::memory_order_relaxed);
+
+            if (b - t > static_cast<std::int64_t>(a->capacity()) - 1) {
+                a = a->grow(b, t);
+                m_garbage.emplace_back(a);
+                m_array.store(a, std::memory_order_release);
+            }
+
+            a->put(b, value);
+            m_bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // 仅拥有者线程调用
+        std::optional<T> pop() {
+            auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+            auto* a = m_array.load(std::memory_order_relaxed);
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = m_top.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                // 队列为空
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            T value = a->get(b);
+            if (t == b) {
+                // 只剩最后一个元素，和窃取者竞争
+                if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    m_bottom.store(b + 1, std::memory_order_relaxed);
+                    return std::nullopt;
+                }
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return value;
+        }
+
+        // 任意线程调用
+        std::optional<T> steal() {
+            auto t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto b = m_bottom.load(std::memory_order_acquire);
+
+            if (t >= b) {
+                return std::nullopt;
+            }
+
+            auto* a = m_array.load(std::memory_order_acquire);
+            T value = a->get(t);
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                // 被其他窃取者或拥有者抢先
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        // 近似大小，仅用于判断是否有任务可取
+        std::size_t size() const noexcept {
+            auto b = m_bottom.load(std::memory_order_relaxed);
+            auto t = m_top.load(std::memory_order_relaxed);
+            return b > t ? static_cast<std::size_t>(b - t) : 0;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+    private:
+        alignas(64) std::atomic<std::int64_t> m_top{0};
+        alignas(64) std::atomic<std::int64_t> m_bottom{0};
+        alignas(64) std::atomic<Array*> m_array;
+
+        // 所有分配过的数组，只由拥有者线程追加
+        std::vector<std::unique_ptr<Array>> m_garbage;
+    };
+
+} // namespace coro::detail
+
+#endif //CORO_WORK_STEALING_DEQUE_HPP
@@ -3,18 +3,20 @@
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/socket.h>
 #include <sys/timerfd.h>
 
 #include <atomic>
 #include <chrono>
 #include <coroutine>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <thread>
 #include <vector>
 
+#include "coro/detail/fd_record.hpp"
 #include "coro/detail/poll_info.hpp"
 #include "coro/poll.hpp"
 #include "coro/task.hpp"
@@ -29,11 +31,15 @@
 using namespace coro::detail;
 using namespace coro::net;
 
+namespace coro::detail {
+    class IoUring;
+    struct UringOp;
+}
+
 namespace coro {
 
     class IoScheduler {
     public:
-        using timed_events = detail::PollInfo::timed_events;
         using time_point = std::chrono::steady_clock::time_point;
         using clock = std::chrono::steady_clock;
 
@@ -42,15 +48,29 @@ namespace coro {
             On_ThreadInline,
         };
 
+        // IO 事件的来源
+        enum class IoBackend {
+            Epoll,      // epoll + EPOLLONESHOT，每次 poll 需要 epoll_ctl 添加/删除
+            IoUring,    // 通过 io_uring 提交 sqe，由 cqe 恢复协程；内核不支持时自动退回 Epoll
+        };
+
         struct Options {
             ExecutionStrategy execution_strategy{ExecutionStrategy::On_ThreadPool};
             std::size_t threads_count{std::thread::hardware_concurrency()};
+            // On_ThreadPool 时线程池的队列组织方式
+            ThreadPool::QueueStrategy queue_strategy{ThreadPool::QueueStrategy::WorkStealing};
+            IoBackend backend{IoBackend::Epoll};
+            // 非负时把 IO 线程绑定到这个 CPU（按 hardware_concurrency 取模），绑定失败只打印警告
+            int io_thread_cpu{-1};
         };
 
         // 公开接口
         static std::shared_ptr<IoScheduler> make_shared(Options opts = {
                                                             ExecutionStrategy::On_ThreadPool,
-                                                            std::thread::hardware_concurrency()});
+                                                            std::thread::hardware_concurrency(),
+                                                            ThreadPool::QueueStrategy::WorkStealing,
+                                                            IoBackend::Epoll,
+                                                            -1});
 
         IoScheduler(IoScheduler&&) = delete;
         auto operator=(IoScheduler&&) = delete;
@@ -61,6 +81,9 @@ namespace coro {
         bool resume(std::coroutine_handle<> handle);
         std::size_t size() const noexcept;
 
+        // 实际使用的后端（请求 IoUring 但内核不支持时为 Epoll）
+        IoBackend backend() const noexcept;
+
         // 调度相关
         struct ScheduleAwaiter;
         ScheduleAwaiter schedule();
@@ -72,8 +95,71 @@ namespace coro {
         Task<> yield_for(std::chrono::milliseconds amount);
         Task<> yield_until(std::chrono::steady_clock::time_point time);
 
+        /**
+         * fd 的常驻注册：以 EPOLLET 加入 epoll 一次，之后的 poll 不再需要 epoll_ctl 添加/删除。
+         * 就绪状态缓存在 FdRecord 中，poll(Registration&) 只有在缓存为未就绪时才挂起；
+         * 调用方在系统调用之前取 sequence()，返回 EAGAIN 后用 clear_ready() 清除缓存的就绪状态。
+         * 每个方向同时只能有一个协程等待；析构时不能有协程在等待，且不能晚于 IoScheduler 析构。
+         */
+        class Registration {
+        public:
+            Registration(IoScheduler& scheduler, int fd);
+            Registration(const Registration&) = delete;
+            Registration& operator=(const Registration&) = delete;
+            ~Registration();
+
+            int fd() const noexcept { return m_record->m_fd; }
+
+            // op 方向已经收到的边沿事件数，在系统调用之前获取
+            std::uint64_t sequence(PollOp op) noexcept;
+            // op 方向缓存的就绪状态，为 false 时系统调用必然 EAGAIN，可以直接等待
+            bool ready(PollOp op) noexcept;
+            // 清除 op 方向缓存的就绪状态，如果获取 sequence 之后又收到了事件则保持就绪
+            void clear_ready(PollOp op, std::uint64_t sequence) noexcept;
+
+        private:
+            friend class IoScheduler;
+
+            IoScheduler& m_scheduler;
+            detail::FdRecord* m_record{nullptr};
+        };
+
+        // 注册失败时抛出 std::system_error
+        std::unique_ptr<Registration> register_fd(int fd);
+
         // I/O操作
         Task<PollStatus> poll(int fd, PollOp op, std::chrono::milliseconds timeout);
+        Task<PollStatus> poll(Registration& registration, PollOp op,
+                              std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        /**
+         * 带超时地等待另一个协程或线程的通知，供同步原语实现带超时的等待（见 Semaphore::acquire_for）。
+         * co_await wait_notified(pi, timeout) 在 notify_waiter(pi) 之后返回 Event，超时返回 Timeout；
+         * notify_waiter 可以在等待开始之前调用，这时 wait_notified 不挂起。
+         * 通知和超时只有一个生效：notify_waiter 返回 false 表示已经超时，等待者由超时恢复，
+         * 返回 true 时等待者通过这个调度器恢复。pi 由等待者持有，只能使用一次
+         */
+        Task<PollStatus> wait_notified(detail::PollInfo& pi, std::chrono::milliseconds timeout);
+        bool notify_waiter(detail::PollInfo& pi);
+
+        /**
+         * 异步 IO 操作：IoUring 后端直接提交对应的 sqe；Epoll 后端先尝试系统调用，EAGAIN 时 poll 后重试
+         * @return 成功时为字节数（accept 为新的 fd），失败时为 -errno，超时为 -ETIMEDOUT
+         */
+        Task<int> recv(int fd, std::span<char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        Task<int> send(int fd, std::span<const char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        Task<int> accept(int fd, sockaddr* addr, socklen_t* addrlen,
+                         std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        Task<int> connect(int fd, const sockaddr* addr, socklen_t addrlen,
+                          std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        // 常驻注册的 fd：先尝试系统调用，EAGAIN 时清除就绪状态并等待下一个边沿事件（不使用 io_uring）
+        Task<int> recv(Registration& registration, std::span<char> buffer,
+                       std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        Task<int> send(Registration& registration, std::span<const char> buffer,
+                       std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        Task<int> accept(Registration& registration, sockaddr* addr, socklen_t* addrlen,
+                         std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
 #ifdef NETWORKING
         Task<PollStatus> poll(net::Socket& sock, PollOp op,
@@ -117,10 +203,25 @@ namespace coro {
         void on_schedule();
         PollStatus event_to_poll_status(uint32_t events);
 
-        // 定时器管理
-        timed_events::iterator add_time_token(time_point tp, detail::PollInfo& pi);
-        void remove_timer_token(timed_events::iterator pos);
-        void update_timeout(time_point now);
+        // 常驻注册相关
+        struct RegisteredPollAwaiter;
+        struct NotifiedAwaiter;
+        void on_fd_event(detail::FdRecord& record, uint32_t events);
+        void deregister(detail::FdRecord* record);
+
+        // io_uring 相关
+        struct UringAwaiter;
+        void on_uring_completion();
+        bool uring_submit(detail::UringOp& op);
+        Task<int> uring_execute(detail::UringOp& op, std::chrono::milliseconds timeout);
+
+        // 定时器管理（调用方不持有 m_timed_events_mutex）
+        void add_time_token(time_point tp, detail::PollInfo& pi);
+        // 同上，需持有 m_timed_events_mutex
+        void add_time_token_locked(time_point tp, detail::PollInfo& pi);
+        void remove_timer_token(detail::PollInfo& pi);
+        // 按时间轮的下一个 tick 重新设置 timerfd，需持有 m_timed_events_mutex
+        void update_timeout();
 
         // 成员变量
         Options m_opts;
@@ -132,16 +233,26 @@ namespace coro {
         std::thread m_io_thread;
         std::unique_ptr<ThreadPool> m_thread_pool{nullptr};
 
+        std::unique_ptr<detail::IoUring> m_uring{nullptr};
+        std::mutex m_uring_mutex;
+
         std::atomic<bool> m_shutdown{false};
         std::atomic<bool> m_schedule_fd_triggered{false};
         std::atomic<std::size_t> m_size{0};
 
         std::vector<std::coroutine_handle<>> m_tasks;
         std::mutex m_tasks_mutex;
+        // IO 线程每轮从 m_tasks 换出的就绪协程，和 m_tasks 交替使用以复用容量
+        std::vector<std::coroutine_handle<>> m_io_tasks;
 
-        timed_events m_timed_events;
+        detail::TimingWheel m_timing_wheel;
+        std::optional<std::uint64_t> m_armed_tick{std::nullopt};  // timerfd 当前设置的 tick
         std::mutex m_timed_events_mutex;
 
+        // 已经注销的 FdRecord，IO 线程在下一次 epoll_wait 之前释放
+        std::vector<std::unique_ptr<detail::FdRecord>> m_retired_records;
+        std::mutex m_retired_records_mutex;
+
         static constexpr int m_max_events = 128;
         std::array<struct epoll_event, m_max_events> m_events{};
 
@@ -152,6 +263,10 @@ namespace coro {
         static const constexpr void* m_timer_ptr = &m_timer_object;
         static const constexpr int m_schedule_object{};
         static const constexpr void* m_schedule_ptr = &m_schedule_object;
+        static const constexpr int m_uring_object{};
+        static const constexpr void* m_uring_ptr = &m_uring_object;
+        // epoll_event.data.ptr 最低位为 1 时指向 FdRecord
+        static constexpr std::uintptr_t m_record_tag = 1;
     };
 
     // 内联常量定义
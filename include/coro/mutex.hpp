@@ -0,0 +1,130 @@
+#ifndef CORO_MUTEX_HPP
+#define CORO_MUTEX_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace coro {
+
+    class IoScheduler;
+    class ThreadPool;
+    class ConditionVariable;
+    class ScopedLock;
+
+    /**
+     * 协程互斥锁：锁被占用时 co_await lock() 挂起协程，而不是阻塞线程池的工作线程或者 IO 线程。
+     * 状态是一个原子指针：this 表示未加锁，nullptr 表示已加锁且没有等待者，否则指向等待者的栈；
+     * 加锁和没有等待者时的解锁都只有一次 CAS。解锁时锁直接交给最早的等待者，
+     * 由构造时指定的 IoScheduler / ThreadPool 恢复它；没有指定时在解锁的线程上直接恢复
+     */
+    class Mutex {
+    public:
+        Mutex() noexcept = default;
+        explicit Mutex(std::shared_ptr<IoScheduler> scheduler) noexcept : m_scheduler(std::move(scheduler)) {}
+        explicit Mutex(ThreadPool& pool) noexcept : m_pool(&pool) {}
+
+        Mutex(const Mutex&) = delete;
+        Mutex& operator=(const Mutex&) = delete;
+
+        // 等待者链表的节点，放在等待者的协程帧中
+        struct Waiter {
+            Waiter* m_next{nullptr};
+            std::coroutine_handle<> m_handle;
+        };
+
+        class LockAwaiter : protected Waiter {
+        public:
+            explicit LockAwaiter(Mutex& mutex) noexcept : m_mutex(mutex) {}
+
+            bool await_ready() noexcept { return m_mutex.try_lock(); }
+            bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
+                m_handle = awaiting_coroutine;
+                return m_mutex.enqueue(*this);
+            }
+            void await_resume() noexcept {}
+
+        protected:
+            Mutex& m_mutex;
+        };
+
+        class ScopedLockAwaiter : public LockAwaiter {
+        public:
+            using LockAwaiter::LockAwaiter;
+            [[nodiscard]] ScopedLock await_resume() noexcept;
+        };
+
+        // co_await 之后持有锁，需要调用 unlock()
+        [[nodiscard]] LockAwaiter lock() noexcept { return LockAwaiter{*this}; }
+
+        // co_await 的结果是 ScopedLock，离开作用域时解锁
+        [[nodiscard]] ScopedLockAwaiter scoped_lock() noexcept { return ScopedLockAwaiter{*this}; }
+
+        bool try_lock() noexcept {
+            void* expected = unlocked();
+            return m_state.compare_exchange_strong(expected, nullptr, std::memory_order_acquire,
+                                                   std::memory_order_relaxed);
+        }
+
+        // 有等待者时把锁交给最早的一个并恢复它
+        void unlock();
+
+    private:
+        friend class ConditionVariable;
+
+        void* unlocked() noexcept { return this; }
+
+        // 加锁，锁被占用时把 waiter 放入等待栈；立即取得锁时返回 false，这时 waiter 不会被恢复
+        bool enqueue(Waiter& waiter) noexcept;
+        // 释放锁或者交给下一个等待者，返回需要恢复的等待者
+        std::coroutine_handle<> release() noexcept;
+        // 把取得锁的等待者交给执行器；没有执行器或者执行器已经停止时返回它，由调用方直接恢复
+        std::coroutine_handle<> transfer(std::coroutine_handle<> handle);
+
+        std::atomic<void*> m_state{unlocked()};
+        // 按到达顺序排列的等待者，只由持有锁的协程访问
+        Waiter* m_waiters{nullptr};
+
+        std::shared_ptr<IoScheduler> m_scheduler;
+        ThreadPool* m_pool{nullptr};
+    };
+
+    // 持有 Mutex 的 RAII 对象，只能移动
+    class ScopedLock {
+    public:
+        ScopedLock(Mutex& mutex, std::adopt_lock_t) noexcept : m_mutex(&mutex) {}
+        ScopedLock(ScopedLock&& other) noexcept : m_mutex(std::exchange(other.m_mutex, nullptr)) {}
+        ScopedLock& operator=(ScopedLock&& other) noexcept {
+            if (this != &other) {
+                unlock();
+                m_mutex = std::exchange(other.m_mutex, nullptr);
+            }
+            return *this;
+        }
+        ScopedLock(const ScopedLock&) = delete;
+        ScopedLock& operator=(const ScopedLock&) = delete;
+        ~ScopedLock() { unlock(); }
+
+        // 提前解锁
+        void unlock() {
+            if (auto* mutex = std::exchange(m_mutex, nullptr)) {
+                mutex->unlock();
+            }
+        }
+
+        bool owns_lock() const noexcept { return m_mutex != nullptr; }
+        Mutex* mutex() const noexcept { return m_mutex; }
+
+    private:
+        Mutex* m_mutex;
+    };
+
+    inline ScopedLock Mutex::ScopedLockAwaiter::await_resume() noexcept {
+        return ScopedLock{m_mutex, std::adopt_lock};
+    }
+
+} // namespace coro
+
+#endif //CORO_MUTEX_HPP
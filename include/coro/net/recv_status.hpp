@@ -9,6 +9,7 @@ namespace coro::net {
         Ok = 0,
         Closed = -1,
         UdpNotBound = -2,
+        Timeout = -3,           // 仅由 read_some/read_exact 返回
         TryAgain = EAGAIN,
         WouldBlock = EWOULDBLOCK,
         ConnectionRefused = ECONNREFUSED,
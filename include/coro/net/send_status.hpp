@@ -7,6 +7,7 @@ namespace coro::net {
     enum class SendStatus {
         Ok = 0,
         Closed = -1,
+        Timeout = -2,           // 仅由 write_all 返回
         TryAgain = EAGAIN,
         PermissionDenied = EACCES,
         Interrupted = EINTR,
@@ -11,9 +11,13 @@
 
 #include "coro/concepts/buffer.hpp"
 
+#include <sys/types.h>
+#include <sys/uio.h>
+
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <span>
 
 namespace coro::net::tcp {
 
@@ -35,40 +39,109 @@ namespace coro::net::tcp {
         ~Client();
 
     public:
+        /**
+         * 把 socket 常驻注册到 IoScheduler（EPOLLET），之后的 poll 只在缓存的就绪状态为未就绪时挂起，
+         * recv/send 遇到 EAGAIN 时清除就绪状态。拷贝得到的 Client 会为 dup 出的 fd 重新注册。
+         * 注册失败时抛出 std::system_error
+         */
+        void register_socket();
+        bool is_registered() const noexcept { return m_registration != nullptr; }
+
         Task<PollStatus> poll(PollOp op, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
         Task<ConnectStatus> connect(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
-        // 返回接收状态和实际接收的数据段
-        auto recv(concepts::MutableBuffer auto&& buffer) -> std::pair<RecvStatus, std::string> {
+        // 返回接收状态和实际接收的数据段（指向 buffer 内部），不分配内存
+        auto recv_into(concepts::MutableBuffer auto&& buffer) -> std::pair<RecvStatus, std::span<char>> {
             if (buffer.empty()) {
-                return {RecvStatus::Ok, std::string{}};
+                return {RecvStatus::Ok, std::span<char>{}};
             }
 
+            auto sequence = m_registration ? m_registration->sequence(PollOp::Read) : 0;
             auto bytes_recv = ::recv(m_socket.fd(), buffer.data(), buffer.size(), 0);
             if (bytes_recv > 0) {
-                return {RecvStatus::Ok, std::string{buffer.data(), static_cast<size_t>(bytes_recv)}};
+                return {RecvStatus::Ok, std::span<char>{buffer.data(), static_cast<size_t>(bytes_recv)}};
             } else if (bytes_recv == 0) {
-                return {RecvStatus::Closed, std::string{}};
+                return {RecvStatus::Closed, std::span<char>{}};
             } else {
-                return {static_cast<RecvStatus>(errno), std::string{}};
+                auto error = errno;
+                if (m_registration && (error == EAGAIN || error == EWOULDBLOCK)) {
+                    m_registration->clear_ready(PollOp::Read, sequence);
+                }
+                return {static_cast<RecvStatus>(error), std::span<char>{}};
             }
         }
 
-        // 返回发送状态和未发送的剩余数据
-        auto send(const concepts::ConstBuffer auto&  buffer) -> std::pair<SendStatus, std::string> {
-            if (buffer.empty()) {
-                return {SendStatus::Ok, std::string{buffer.data(), buffer.size()}};
+        // 返回发送状态和未发送的剩余数据段（指向 buffer 内部），不分配内存
+        auto send_from(const concepts::ConstBuffer auto& buffer) -> std::pair<SendStatus, std::span<const char>> {
+            std::span<const char> data{buffer.data(), buffer.size()};
+            if (data.empty()) {
+                return {SendStatus::Ok, data};
             }
 
-            auto bytes_sent = ::send(m_socket.fd(), buffer.data(), buffer.size(), 0);
+            auto sequence = m_registration ? m_registration->sequence(PollOp::Write) : 0;
+            auto bytes_sent = ::send(m_socket.fd(), data.data(), data.size(), MSG_NOSIGNAL);
             if (bytes_sent >= 0) {
-                return {SendStatus::Ok, std::string{buffer.data() + bytes_sent, buffer.size() - bytes_sent}};
+                return {SendStatus::Ok, data.subspan(static_cast<size_t>(bytes_sent))};
             } else {
-                return {static_cast<SendStatus>(errno), std::string{buffer.data(), buffer.size()}};
+                auto error = errno;
+                if (m_registration && (error == EAGAIN || error == EWOULDBLOCK)) {
+                    m_registration->clear_ready(PollOp::Write, sequence);
+                }
+                return {static_cast<SendStatus>(error), data};
             }
         }
 
+        // 用一次 sendmsg 发送多段数据，返回发送状态和发送的字节数，不修改 buffers
+        auto sendv_from(std::span<const iovec> buffers) -> std::pair<SendStatus, std::size_t>;
+
+        // 用 sendfile 从 file_fd 的 offset 处发送最多 count 字节，offset 随之前进；返回发送状态和发送的字节数
+        auto sendfile_from(int file_fd, off_t& offset, std::size_t count) -> std::pair<SendStatus, std::size_t>;
+
+        // 返回接收状态和实际接收的数据（拷贝到新的 string 中）
+        auto recv(concepts::MutableBuffer auto&& buffer) -> std::pair<RecvStatus, std::string> {
+            auto [status, received] = recv_into(buffer);
+            return {status, std::string{received.data(), received.size()}};
+        }
+
+        // 返回发送状态和未发送的剩余数据（拷贝到新的 string 中）
+        auto send(const concepts::ConstBuffer auto& buffer) -> std::pair<SendStatus, std::string> {
+            auto [status, rest] = send_from(buffer);
+            return {status, std::string{rest.data(), rest.size()}};
+        }
+
+        /**
+         * 以下协程先直接尝试系统调用，只在 EAGAIN 时挂起等待就绪，数据已在内核缓冲区时不经过 epoll。
+         * timeout 为 0 表示不超时；read_exact/write_all 的 timeout 是整个操作的截止时间而不是单次等待的时间，
+         * 超时返回 RecvStatus::Timeout / SendStatus::Timeout。
+         */
+        // 读到至少 1 字节后返回，返回的数据段指向 buffer 内部
+        Task<std::pair<RecvStatus, std::span<char>>> read_some(
+            std::span<char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        // 读满 buffer 才返回 Ok；对端提前关闭返回 Closed，第二个值是已经读到的字节数
+        Task<std::pair<RecvStatus, std::size_t>> read_exact(
+            std::span<char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        // 发送完整个 buffer 才返回 Ok，第二个值是已经发送的字节数
+        Task<std::pair<SendStatus, std::size_t>> write_all(
+            std::span<const char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        /**
+         * 发送 buffers 中的全部数据，多段数据合并在一次 sendmsg 中发出；部分发送时原地修改 buffers 记录进度，
+         * 返回后 buffers 的内容不再有意义。第二个值是已经发送的字节数
+         */
+        Task<std::pair<SendStatus, std::size_t>> writev_all(
+            std::span<iovec> buffers, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        /**
+         * 用 sendfile 发送文件中 [offset, offset + count) 的内容，数据直接从页缓存进入 socket，不经过用户态。
+         * 文件在发送途中被截断时返回 SendStatus::Closed。第二个值是已经发送的字节数
+         */
+        Task<std::pair<SendStatus, std::size_t>> sendfile_all(
+            int file_fd, off_t offset, std::size_t count,
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
         Socket& socket() { return m_socket; }
         const Socket socket() const { return m_socket; }
         const RemoteEndPoint& remote_endpoint() const { return m_remote_endpoint; }
@@ -81,6 +154,8 @@ namespace coro::net::tcp {
         RemoteEndPoint m_remote_endpoint;
         Socket m_socket {-1};
         std::optional<ConnectStatus> m_connect_status {std::nullopt};
+        // 必须在 m_socket 之后声明，保证先从 epoll 注销再关闭 fd
+        std::unique_ptr<IoScheduler::Registration> m_registration {nullptr};
     };
 
 } // namespace coro::net::tcp
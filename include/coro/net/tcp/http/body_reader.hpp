@@ -0,0 +1,98 @@
+#ifndef CORO_HTTP_BODY_READER_HPP
+#define CORO_HTTP_BODY_READER_HPP
+
+#include "coro/net/tcp/client.hpp"
+#include "coro/task.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace coro::net::tcp::http {
+
+    /**
+     * 流式读取请求正文，支持 Content-Length 和 chunked 编码，每个连接一个，由连接在每个请求之前 start。
+     * 正文先从连接缓冲区中已经收到的数据里取，取完后才从 socket 读入自己固定大小的缓冲区，
+     * 只有处理函数调用 read 时才读 socket，上传再大占用的内存也是固定的，处理不过来时由 TCP 流控让客户端等待。
+     */
+    class BodyReader {
+    public:
+        explicit BodyReader(Client& client, std::size_t buffer_size = 64 * 1024)
+            : m_client(client), m_buffer_size(buffer_size) {}
+
+        BodyReader(const BodyReader&) = delete;
+        BodyReader& operator=(const BodyReader&) = delete;
+
+        // 正文已经完整地在连接缓冲区中
+        void start_buffered(std::string_view body);
+        /**
+         * received 是连接缓冲区中头部之后已经收到的数据，可能还包含之后的流水线请求。
+         * expect_continue 时在第一次需要从 socket 读取正文之前回复 100 Continue
+         */
+        void start_content_length(std::size_t length, std::string_view received, bool expect_continue);
+        void start_chunked(std::string_view received, std::size_t max_body, bool expect_continue);
+
+        /**
+         * 返回下一段正文，指向连接或者读取器的缓冲区，下次 read 之前有效，不拷贝。
+         * 正文结束或者出错时返回空，用 failed() 区分
+         */
+        Task<std::string_view> read();
+
+        // 跳过剩余的正文，最多 max_bytes；正文更长或者出错时返回 false，连接无法再用于之后的请求
+        Task<bool> skip(std::size_t max_bytes);
+
+        bool done() const noexcept { return m_state == State::Done; }
+        bool failed() const noexcept { return m_state == State::Failed; }
+        // 出错时应返回的状态码：400（编码错误）、413（超过 max_body），连接在正文结束之前关闭时为 0
+        int error_status() const noexcept { return m_error_status; }
+        // 已经读取的正文字节数，不包括 chunked 的框架
+        std::size_t bytes_read() const noexcept { return m_bytes_read; }
+
+        // received 中属于这个请求（正文和 chunked 框架）的字节数
+        std::size_t received_consumed() const noexcept;
+        // 从 socket 多读到的、属于之后请求的数据，done() 之后有效
+        std::string_view leftover() const noexcept { return m_from_received ? std::string_view{} : m_input; }
+
+    private:
+        enum class State {
+            Fixed,           // 按 Content-Length 读取
+            ChunkSize,
+            ChunkExtension,
+            ChunkSizeLf,
+            ChunkData,
+            ChunkDataCr,
+            ChunkDataLf,
+            TrailerStart,
+            Trailer,
+            TrailerLf,
+            FinalLf,
+            Done,
+            Failed,
+        };
+
+        void start(std::string_view received, bool expect_continue);
+        Task<bool> fill();
+        std::string_view take_fixed();
+        std::string_view decode_chunked();
+        void fail(int status);
+
+        Client& m_client;
+        std::size_t m_buffer_size;
+        std::unique_ptr<char[]> m_buffer;  // 第一次需要读 socket 时才分配
+
+        State m_state{State::Done};
+        std::string_view m_received;
+        std::string_view m_input;  // 还没有处理的数据，在 m_received 或者 m_buffer 中
+        bool m_from_received{true};
+        bool m_expect_continue{false};
+        std::size_t m_remaining{0};     // Content-Length 剩余的字节数，或者当前 chunk 剩余的字节数
+        std::size_t m_max_body{0};
+        std::size_t m_size_digits{0};
+        std::size_t m_line_bytes{0};    // chunk 扩展和 trailer 的长度，防止无限长的行
+        std::size_t m_bytes_read{0};
+        int m_error_status{0};
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_BODY_READER_HPP
@@ -0,0 +1,182 @@
+#ifndef CORO_HTTP_HANDLER_HPP
+#define CORO_HTTP_HANDLER_HPP
+
+#include "coro/net/tcp/http/request.hpp"
+#include "coro/net/tcp/http/response.hpp"
+#include "coro/task.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace coro::net::tcp::http {
+
+    // 返回 Task<> 的处理函数，每次调用创建一个协程帧
+    template <typename F>
+    concept AsyncHandler = std::is_invocable_v<F&, Request&, Response&> &&
+                           std::same_as<std::invoke_result_t<F&, Request&, Response&>, Task<>>;
+
+    // 返回 void 的处理函数，在连接的协程中直接调用，不创建协程帧也不挂起
+    template <typename F>
+    concept SyncHandler = std::is_invocable_v<F&, Request&, Response&> &&
+                          std::is_void_v<std::invoke_result_t<F&, Request&, Response&>>;
+
+    /**
+     * 路由的处理函数，代替 std::function。可调用对象不超过 inline_size 并且可以 noexcept 移动时
+     * 存放在对象内部，否则放在堆上；调用通过按类型生成的函数表，没有虚函数和类型检查。
+     * 处理函数不需要等待时可以返回 void，连接直接调用它，省去协程帧的分配和一次挂起、恢复。
+     * 只能移动，不能拷贝
+     */
+    class Handler {
+    public:
+        static constexpr std::size_t inline_size = 6 * sizeof(void*);
+
+        Handler() noexcept = default;
+
+        template <typename F>
+            requires(!std::same_as<std::remove_cvref_t<F>, Handler> &&
+                     (AsyncHandler<std::decay_t<F>> || SyncHandler<std::decay_t<F>>))
+        Handler(F&& func) : m_ops(&ops_for<std::decay_t<F>>) {
+            using Func = std::decay_t<F>;
+            if constexpr (stored_inline<Func>) {
+                ::new (static_cast<void*>(m_storage)) Func(std::forward<F>(func));
+            } else {
+                ::new (static_cast<void*>(m_storage)) Func*(new Func(std::forward<F>(func)));
+            }
+        }
+
+        Handler(Handler&& other) noexcept : m_ops(std::exchange(other.m_ops, nullptr)) {
+            if (m_ops) {
+                m_ops->move(m_storage, other.m_storage);
+            }
+        }
+
+        Handler& operator=(Handler&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_ops = std::exchange(other.m_ops, nullptr);
+                if (m_ops) {
+                    m_ops->move(m_storage, other.m_storage);
+                }
+            }
+            return *this;
+        }
+
+        Handler(const Handler&) = delete;
+        Handler& operator=(const Handler&) = delete;
+
+        ~Handler() { reset(); }
+
+        explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+        // 是否是返回 void 的处理函数，是的话用 call_sync 调用；空的 Handler 返回 false
+        bool is_sync() const noexcept { return m_ops != nullptr && m_ops->call_sync != nullptr; }
+
+        // 可调用对象是否存放在 Handler 内部
+        bool is_inline() const noexcept { return m_ops != nullptr && m_ops->inline_storage; }
+
+        // 只能在 is_sync() 为 true 时调用
+        void call_sync(Request& req, Response& resp) { m_ops->call_sync(m_storage, req, resp); }
+
+        // 两种处理函数都可以这样调用，返回 void 的处理函数被包装成一个协程；空的 Handler 抛出 std::bad_function_call
+        Task<> operator()(Request& req, Response& resp) {
+            if (m_ops == nullptr) {
+                throw std::bad_function_call{};
+            }
+            if (is_sync()) {
+                return run_sync(*this, req, resp);
+            }
+            return m_ops->call(m_storage, req, resp);
+        }
+
+    private:
+        struct Ops {
+            Task<> (*call)(void* storage, Request& req, Response& resp);
+            void (*call_sync)(void* storage, Request& req, Response& resp);
+            // 从 src 移动构造到 dst，然后销毁 src
+            void (*move)(void* dst, void* src) noexcept;
+            void (*destroy)(void* storage) noexcept;
+            bool inline_storage;
+        };
+
+        template <typename Func>
+        static constexpr bool stored_inline = sizeof(Func) <= inline_size &&
+                                              alignof(Func) <= alignof(std::max_align_t) &&
+                                              std::is_nothrow_move_constructible_v<Func>;
+
+        template <typename Func>
+        static Func& target(void* storage) noexcept {
+            if constexpr (stored_inline<Func>) {
+                return *std::launder(static_cast<Func*>(storage));
+            } else {
+                return **std::launder(static_cast<Func**>(storage));
+            }
+        }
+
+        template <typename Func>
+        static Task<> call_async(void* storage, Request& req, Response& resp) {
+            if constexpr (AsyncHandler<Func>) {
+                return target<Func>(storage)(req, resp);
+            } else {
+                return Task<>{};
+            }
+        }
+
+        template <typename Func>
+        static void call_inline(void* storage, Request& req, Response& resp) {
+            if constexpr (SyncHandler<Func>) {
+                target<Func>(storage)(req, resp);
+            }
+        }
+
+        template <typename Func>
+        static void move_to(void* dst, void* src) noexcept {
+            if constexpr (stored_inline<Func>) {
+                auto& func = target<Func>(src);
+                ::new (dst) Func(std::move(func));
+                func.~Func();
+            } else {
+                ::new (dst) Func*(*std::launder(static_cast<Func**>(src)));
+            }
+        }
+
+        template <typename Func>
+        static void destroy(void* storage) noexcept {
+            if constexpr (stored_inline<Func>) {
+                target<Func>(storage).~Func();
+            } else {
+                delete &target<Func>(storage);
+            }
+        }
+
+        template <typename Func>
+        static constexpr Ops ops_for{
+            AsyncHandler<Func> ? &call_async<Func> : nullptr,
+            SyncHandler<Func> ? &call_inline<Func> : nullptr,
+            &move_to<Func>,
+            &destroy<Func>,
+            stored_inline<Func>,
+        };
+
+        static Task<> run_sync(Handler& handler, Request& req, Response& resp) {
+            handler.call_sync(req, resp);
+            co_return;
+        }
+
+        void reset() noexcept {
+            if (m_ops) {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+        const Ops* m_ops{nullptr};
+        alignas(std::max_align_t) std::byte m_storage[inline_size];
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_HANDLER_HPP
@@ -1,58 +1,96 @@
 #ifndef CORO_HTTP_SERVER_HPP
 #define CORO_HTTP_SERVER_HPP
 
-#include <unordered_map>
-#include <functional>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
 
+#include "coro/net/tcp/http/body_reader.hpp"
+#include "coro/net/tcp/http/handler.hpp"
+#include "coro/net/tcp/http/request.hpp"
+#include "coro/net/tcp/http/request_parser.hpp"
+#include "coro/net/tcp/http/response.hpp"
+#include "coro/net/tcp/http/response_cache.hpp"
+#include "coro/net/tcp/http/response_writer.hpp"
+#include "coro/net/tcp/http/router.hpp"
+#include "coro/net/tcp/http/static_files.hpp"
 #include "coro/net/tcp/server.hpp"
+#include "coro/net/tcp/server_group.hpp"
+#include "coro/semaphore.hpp"
 #include "coro/task.hpp"
 
 
 namespace coro::net::tcp::http {
 
-    class Request {
-    public:
-        std::string method;
-        std::string path;
-        std::unordered_map<std::string, std::string> headers;
-        std::string body;
-        size_t content_length = 0;
-
-        static Request parse(const std::string &raw_request);
-    };
-
-    class Response {
-    public:
-        int status_code = 200;
-        std::unordered_map<std::string, std::string> headers;
-        std::string body;
-
-        std::string to_string() const;
-    };
-
     class HttpServer {
     public:
-        using Handler = std::function<Task<>(Request & , Response & )>;
+        // 处理函数可以返回 Task<>，或者在不需要等待时返回 void，见 http::Handler
+        using Handler = http::Handler;
 
         HttpServer(std::shared_ptr<IoScheduler> scheduler, Server::LocalEndPoint opts = {});
+        // 在多个 SO_REUSEPORT reactor 上运行，每个 reactor 处理自己接受的连接
+        explicit HttpServer(ServerGroup::Options opts);
+
+        /**
+         * 注册路由处理函数，必须在 start() 之前调用。路径可以包含 ":name" 段和最后的 "*name" 段，
+         * 匹配到的值通过 Request::param 取得；路由重复或格式错误时抛出 std::runtime_error，
+         * handler 为空时抛出 std::invalid_argument。
+         * 路径没有 HEAD 路由时 HEAD 请求由 GET 路由处理，响应的头部不变，不发送正文
+         */
+        void route(Method method, std::string_view path, Handler handler);
+
+        // 路由的并发上限，所有 reactor 共用
+        struct ConcurrencyLimit {
+            std::size_t max_concurrent{1};
+            // 达到上限时排队等待的最长时间，按到达顺序取得许可；为 0 时直接拒绝。拒绝或者超时时回复 503
+            std::chrono::milliseconds queue_timeout{0};
+        };
+
+        // 同上，同时处理这个路由的请求不超过 limit.max_concurrent 个，处理函数和流式正文发送期间都占用名额
+        void route(Method method, std::string_view path, Handler handler, ConcurrencyLimit limit);
 
-        // 注册路由处理函数
         void Get(const std::string &path, Handler handler);
 
+        // 同上，响应经过 cache 缓存，见 ResponseCache；一个 cache 可以被多个路由共用
+        void Get(const std::string &path, Handler handler, std::shared_ptr<ResponseCache> cache);
+
         void Post(const std::string &path, Handler handler);
 
+        // 用 GET prefix/*path 提供 opts.root 下的静态文件，见 StaticFiles
+        void serve_static(std::string_view prefix, StaticFiles::Options opts);
+
+        // 冻结路由表，然后在所有 reactor 上接受连接，直到 stop() 或者监听出错才返回
         Task<> start();
 
-    private:
-        std::shared_ptr<IoScheduler> m_scheduler;
-        Server m_server;
-        std::unordered_map<std::string, std::unordered_map<std::string, Handler>> m_routes;
+        // 停止接受新连接，start() 随后返回；已经建立的连接处理到关闭为止
+        void stop();
 
+        // 监听的端口，构造时 port 为 0 时是内核分配的端口
+        uint16_t port() const noexcept { return m_group.port(); }
 
-        Task<> handle_client(Client client);
+    private:
+        ServerGroup m_group;
+        struct Route {
+            Handler handler;
+            std::unique_ptr<Semaphore> limit;  // 没有并发上限时为空
+            std::chrono::milliseconds queue_timeout{0};
+        };
+
+        // 路由的值是 m_routes 中的下标
+        Router m_router;
+        std::vector<Route> m_routes;
+
+
+        Task<> accept_loop(std::size_t reactor);
+        /**
+         * 处理一个连接：缓冲区中有几个完整的请求就按顺序处理几个（HTTP/1.1 流水线），
+         * 它们的响应合并成一次 writev 发送；遵守 keep-alive / Connection: close 的语义
+         */
+        Task<> handle_client(Client client, std::size_t reactor);
+        // 查找请求的路由；没有匹配的路由时填写 404 / 405 响应并返回 nullptr
+        Route* find_route(Request& req, Response& resp);
 
     };
 
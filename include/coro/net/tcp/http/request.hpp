@@ -0,0 +1,110 @@
+#ifndef CORO_HTTP_REQUEST_HPP
+#define CORO_HTTP_REQUEST_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace coro::net::tcp::http {
+
+    struct Header {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    enum class Method : std::uint8_t {
+        Get,
+        Head,
+        Post,
+        Put,
+        Delete,
+        Patch,
+        Options,
+        Connect,
+        Trace,
+        Unknown,  // 其他扩展方法，路由按 405 处理
+    };
+    inline constexpr std::size_t method_count = static_cast<std::size_t>(Method::Unknown) + 1;
+
+    Method parse_method(std::string_view method) noexcept;
+
+    // 路由匹配得到的路径参数（:name 和 *name），指向请求的 path；容量固定，不分配内存
+    class PathParams {
+    public:
+        static constexpr std::size_t capacity = 8;
+
+        struct Param {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        std::optional<std::string_view> get(std::string_view name) const noexcept {
+            for (std::size_t i = 0; i < m_size; ++i) {
+                if (m_params[i].name == name) {
+                    return m_params[i].value;
+                }
+            }
+            return std::nullopt;
+        }
+
+        void push(std::string_view name, std::string_view value) noexcept { m_params[m_size++] = {name, value}; }
+        void pop() noexcept { --m_size; }
+        void clear() noexcept { m_size = 0; }
+
+        std::size_t size() const noexcept { return m_size; }
+        const Param* begin() const noexcept { return m_params.data(); }
+        const Param* end() const noexcept { return m_params.data() + m_size; }
+
+    private:
+        std::array<Param, capacity> m_params{};
+        std::size_t m_size{0};
+    };
+
+    class BodyReader;
+
+    /**
+     * 解析得到的请求，所有 string_view 都指向连接的接收缓冲区，
+     * 只在处理函数返回之前有效，需要保留时由调用方自行拷贝
+     */
+    class Request {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        Request() = default;
+        explicit Request(allocator_type alloc) : headers(alloc) {}
+
+        std::string_view method;
+        std::string_view target;   // 完整的请求目标，包含查询串
+        std::string_view path;     // target 中 '?' 之前的部分
+        std::string_view query;    // target 中 '?' 之后的部分，没有时为空
+        std::string_view version;  // "HTTP/1.1" 或 "HTTP/1.0"
+        std::pmr::vector<Header> headers;
+        std::string_view body;     // 缓冲的正文；正文较大或者是 chunked 编码时为空，需要通过 body_reader 读取
+        size_t content_length = 0;
+        PathParams params;  // 由路由填写
+        // 由连接设置，逐段读取正文（缓冲的正文也可以这样读取），只在处理函数返回之前有效
+        BodyReader* body_reader = nullptr;
+
+        // 路径参数，没有时返回 nullopt
+        std::optional<std::string_view> param(std::string_view name) const noexcept { return params.get(name); }
+
+        // 按名字查找头部（不区分大小写），有重复时返回第一个
+        std::optional<std::string_view> header(std::string_view name) const;
+
+        // 处理完这个请求后是否保持连接：HTTP/1.1 默认保持，HTTP/1.0 默认关闭，由 Connection 头部覆盖
+        bool keep_alive() const;
+
+        // 保留 headers 的容量，供同一个连接上的下一个请求复用
+        void clear();
+    };
+
+    // ASCII 不区分大小写的比较
+    bool iequals(std::string_view lhs, std::string_view rhs) noexcept;
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_REQUEST_HPP
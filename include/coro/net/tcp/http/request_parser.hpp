@@ -0,0 +1,103 @@
+#ifndef CORO_HTTP_REQUEST_PARSER_HPP
+#define CORO_HTTP_REQUEST_PARSER_HPP
+
+#include "coro/net/tcp/http/request.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace coro::net::tcp::http {
+
+    /**
+     * 增量的 HTTP/1.1 请求解析器（状态机），直接在连接的接收缓冲区上工作，不拷贝数据。
+     * 每次收到新数据后用从请求起始处开始的全部数据再调用 parse，解析从上次停下的位置继续；
+     * 内部只记录偏移量，所以两次调用之间缓冲区可以扩容搬移。
+     * 解析完成后 Request 中的 string_view 指向最后一次传入的 data。
+     * 不超过 max_buffered_body 的 Content-Length 正文等收全后放在 Request::body 中；更大的正文和 chunked 正文
+     * 在头部结束时就返回 Complete（body_streamed() 为 true），正文由调用方用 BodyReader 从连接中逐段读取。
+     */
+    class RequestParser {
+    public:
+        struct Limits {
+            std::size_t max_request_line{8 * 1024};
+            std::size_t max_header_bytes{64 * 1024};  // 请求行加全部头部
+            std::size_t max_headers{100};
+            std::size_t max_body{1024 * 1024 * 1024};  // 正文的总长度，包括流式读取的正文
+            std::size_t max_buffered_body{64 * 1024};
+        };
+
+        enum class Result {
+            Incomplete,  // 需要更多数据
+            Complete,
+            Error,       // 请求无效或超出限制，error_status() 给出应返回的状态码
+        };
+
+        RequestParser() : RequestParser(Limits{}) {}
+        explicit RequestParser(Limits limits) : m_limits(limits) {}
+
+        Result parse(std::string_view data, Request& request);
+
+        // 开始解析下一个请求，之后传入的 data 应从上一个请求之后开始
+        void reset();
+
+        // 已经解析的字节数（头部加缓冲的正文，流式正文不计入），Complete 之后有效
+        std::size_t consumed() const noexcept { return m_header_end + (m_body_streamed ? 0 : m_content_length); }
+
+        // 正文没有缓冲，需要流式读取；Complete 之后有效
+        bool body_streamed() const noexcept { return m_body_streamed; }
+        // 正文使用 chunked 编码（总是流式读取）
+        bool chunked() const noexcept { return m_chunked; }
+
+        // 出错时应返回的状态码：400、413、414、431、501、505
+        int error_status() const noexcept { return m_error_status; }
+
+        const Limits& limits() const noexcept { return m_limits; }
+
+    private:
+        enum class State {
+            RequestLine,
+            Headers,
+            Body,
+            Done,
+            Error,
+        };
+
+        struct Slice {
+            std::uint32_t offset{0};
+            std::uint32_t length{0};
+
+            std::string_view view(std::string_view data) const { return data.substr(offset, length); }
+        };
+
+        struct HeaderSlice {
+            Slice name;
+            Slice value;
+        };
+
+        bool parse_request_line(std::string_view data, std::size_t end);
+        bool parse_header_line(std::string_view data, std::size_t end);
+        bool finish_headers(std::string_view data);
+        void fill(std::string_view data, Request& request) const;
+        Result fail(int status);
+
+        Limits m_limits;
+        State m_state{State::RequestLine};
+        std::size_t m_line_start{0};  // 当前行的起始位置
+        std::size_t m_scan{0};        // 下一次查找行尾的位置，已经查找过的部分不再重复扫描
+        std::size_t m_header_end{0};  // 空行之后的位置，即正文的起始位置
+
+        Slice m_method;
+        Slice m_target;
+        Slice m_version;
+        std::vector<HeaderSlice> m_headers;
+        std::size_t m_content_length{0};
+        bool m_has_content_length{false};
+        bool m_chunked{false};
+        bool m_body_streamed{false};
+        int m_error_status{0};
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_REQUEST_PARSER_HPP
@@ -0,0 +1,82 @@
+#ifndef CORO_HTTP_RESPONSE_HPP
+#define CORO_HTTP_RESPONSE_HPP
+
+#include "coro/task.hpp"
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace coro::net::tcp::http {
+
+    // 直接从文件发送的正文（sendfile），owner 保证发送期间 fd 不被关闭
+    struct FileBody {
+        std::shared_ptr<const void> owner;
+        int fd{-1};
+        off_t offset{0};
+        std::size_t length{0};
+    };
+
+    class ResponseWriter;
+
+    // 头部名字到值的表，可以直接用 string_view 查找
+    struct HeaderHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+    using HeaderMap = std::pmr::unordered_map<std::pmr::string, std::pmr::string, HeaderHash, std::equal_to<>>;
+
+    /**
+     * 响应的头部表和正文都从构造时给定的内存资源分配；HttpServer 用每个连接的内存池构造，
+     * 一批响应发出后整体释放，稳定状态下不分配堆内存。默认使用全局的 new/delete
+     */
+    class Response {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        Response() = default;
+        explicit Response(allocator_type alloc) : headers(alloc), body(alloc) {}
+
+        int status_code = 200;
+        HeaderMap headers;
+        std::pmr::string body;
+        std::optional<FileBody> file;  // 设置时代替 body 作为正文
+        /**
+         * 流式正文：处理函数返回后，连接先发出头部（Transfer-Encoding: chunked），再调用 stream 逐段发送正文，
+         * 发送期间 Request 仍然有效。设置时忽略 body 和 file
+         */
+        std::function<Task<>(ResponseWriter&)> stream;
+
+        // 正文的长度
+        std::size_t content_length() const noexcept { return file ? file->length : body.size(); }
+
+        // 1xx、204 和 304 响应不能有正文（RFC 9110 8.6）
+        bool allows_body() const noexcept { return status_code >= 200 && status_code != 204 && status_code != 304; }
+
+        /**
+         * 把状态行和头部（加上 Content-Length，以及没有设置时的 Date）追加到 out，不包含正文。
+         * out 由连接复用，正文和它一起用 writev 发送，不需要拷贝。不能有正文的响应没有 Content-Length。
+         * 流式响应写 Transfer-Encoding: chunked；chunked 为 false 时（HTTP/1.0）不写长度，由关闭连接结束正文
+         */
+        void write_head(std::string& out, bool chunked = true) const;
+
+        // 头部加正文拼成一个完整的响应，不包含 file 正文
+        std::string to_string() const;
+    };
+
+    // 状态码对应的原因短语，未知的状态码返回空串
+    std::string_view reason_phrase(int status_code) noexcept;
+
+    // IMF-fixdate 格式的当前时间，每个线程每秒只格式化一次
+    std::string_view http_date() noexcept;
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_RESPONSE_HPP
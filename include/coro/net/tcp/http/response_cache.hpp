@@ -0,0 +1,69 @@
+#ifndef CORO_HTTP_RESPONSE_CACHE_HPP
+#define CORO_HTTP_RESPONSE_CACHE_HPP
+
+#include "coro/async_cache.hpp"
+#include "coro/io_scheduler.hpp"
+#include "coro/net/tcp/http/handler.hpp"
+#include "coro/net/tcp/http/request.hpp"
+#include "coro/net/tcp/http/response.hpp"
+#include "coro/task.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace coro::net::tcp::http {
+
+    /**
+     * GET 路由的响应缓存：key 是请求目标（路径加查询串）和 vary_headers 中各个头部的值。
+     * 命中时直接用缓存的状态码、头部和正文填写响应（加上 X-Cache: HIT），不调用处理函数；
+     * 同一个 key 的并发未命中只调用一次处理函数，其他请求等待它的结果。
+     * 只缓存 200 并且正文在 body 中的响应，file / stream 响应和其他状态码每次都调用处理函数。
+     * 可以被多个路由和多个 reactor 共用，用 HttpServer::Get(path, handler, cache) 注册
+     */
+    class ResponseCache {
+    public:
+        struct Options {
+            std::size_t capacity{1024};
+            std::size_t shards{16};
+            std::chrono::milliseconds ttl{std::chrono::seconds{10}};
+            // 影响响应内容的请求头部，名字不区分大小写
+            std::vector<std::string> vary_headers;
+        };
+
+        // 缓存的响应，不包含 Date 头部，由发送时重新生成
+        struct Entry {
+            int status_code{200};
+            std::vector<std::pair<std::string, std::string>> headers;
+            std::string body;
+        };
+
+        using Cache = AsyncCache<std::string, std::shared_ptr<const Entry>>;
+
+        // 条目的 TTL 由 scheduler 的定时器到期
+        ResponseCache(std::shared_ptr<IoScheduler> scheduler, Options opts);
+
+        // 返回带缓存的处理函数，cache 在处理函数存在期间保持有效
+        static Handler wrap(std::shared_ptr<ResponseCache> cache, Handler handler);
+
+        // 用缓存处理一个请求，未命中时调用 handler
+        Task<> serve(Request& req, Response& resp, Handler& handler);
+
+        Cache::Stats stats() const { return m_cache.stats(); }
+        Cache& cache() noexcept { return m_cache; }
+
+    private:
+        std::string make_key(const Request& req) const;
+        // 调用处理函数，响应可以缓存时返回它的副本
+        Task<std::optional<std::shared_ptr<const Entry>>> load(Request& req, Response& resp, Handler& handler,
+                                                               bool& called);
+
+        std::vector<std::string> m_vary_headers;
+        Cache m_cache;
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_RESPONSE_CACHE_HPP
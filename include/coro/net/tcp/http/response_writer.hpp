@@ -0,0 +1,45 @@
+#ifndef CORO_HTTP_RESPONSE_WRITER_HPP
+#define CORO_HTTP_RESPONSE_WRITER_HPP
+
+#include "coro/net/tcp/client.hpp"
+#include "coro/task.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace coro::net::tcp::http {
+
+    /**
+     * 流式响应的写入端，由连接创建后交给 Response::stream。
+     * 每次 write 都直接发送（HTTP/1.1 为一个 chunk），socket 缓冲区满时挂起等待可写，
+     * 不在用户态积攒数据，所以无论正文多大，每个连接占用的内存都是固定的。
+     */
+    class ResponseWriter {
+    public:
+        // chunked 为 false 时（HTTP/1.0 客户端）原样发送，正文由关闭连接结束
+        ResponseWriter(Client& client, bool chunked) : m_client(client), m_chunked(chunked) {}
+
+        ResponseWriter(const ResponseWriter&) = delete;
+        ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+        // 发送一段数据，全部交给内核后才返回；连接出错后返回 false，之后的写入都被忽略
+        Task<bool> write(std::string_view data);
+
+        // 结束正文（发送最后的空 chunk），stream 返回后由连接调用，重复调用没有影响
+        Task<bool> finish();
+
+        bool ok() const noexcept { return m_ok; }
+        // 已经发送的正文字节数，不包括 chunk 的框架
+        std::size_t bytes_written() const noexcept { return m_bytes_written; }
+
+    private:
+        Client& m_client;
+        bool m_chunked;
+        bool m_ok{true};
+        bool m_finished{false};
+        std::size_t m_bytes_written{0};
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_RESPONSE_WRITER_HPP
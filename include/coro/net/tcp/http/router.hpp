@@ -0,0 +1,95 @@
+#ifndef CORO_HTTP_ROUTER_HPP
+#define CORO_HTTP_ROUTER_HPP
+
+#include "coro/net/tcp/http/request.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coro::net::tcp::http {
+
+    /**
+     * 压缩基数树路由，键是方法加路径。路径中以 '/' 开头的段可以是 ":name"（匹配一个非空的段）
+     * 或者 "*name"（匹配剩余的全部路径，只能在最后）；匹配时静态段优先，其次参数，最后通配，失败时回溯。
+     * 启动时 add 全部路由，freeze 后压平成连续数组，之后只读，可以在多个线程中同时 match。
+     * 路由的值是调用方的下标（例如处理函数数组中的位置）。
+     */
+    class Router {
+    public:
+        using value_type = std::uint32_t;
+
+        enum class Status {
+            Found,
+            NotFound,          // 404：路径不匹配任何路由
+            MethodNotAllowed,  // 405：路径匹配，但没有这个方法的路由
+        };
+
+        struct Match {
+            Status status;
+            value_type value;  // status 为 Found 时有效
+        };
+
+        Router();
+        ~Router();
+        Router(Router&&) noexcept;
+        Router& operator=(Router&&) noexcept;
+
+        // 路由重复、参数名冲突、格式错误或者已经 freeze 时抛出 std::runtime_error
+        void add(Method method, std::string_view pattern, value_type value);
+
+        // 压平成只读的数组，之后不能再 add；重复调用没有影响
+        void freeze();
+        bool frozen() const noexcept { return m_build_root == nullptr; }
+
+        // 必须在 freeze 之后调用；参数追加到 params（指向 path），失败时 params 不变
+        Match match(Method method, std::string_view path, PathParams& params) const;
+
+        std::size_t size() const noexcept { return m_route_count; }
+
+    private:
+        struct BuildNode;
+
+        static constexpr std::uint32_t npos = UINT32_MAX;
+
+        struct Node {
+            std::uint32_t m_prefix_offset{0};  // 静态前缀在 m_strings 中的位置
+            std::uint32_t m_prefix_size{0};
+            std::uint32_t m_name_offset{0};    // 参数和通配节点的名字
+            std::uint32_t m_name_size{0};
+            std::uint32_t m_children_begin{0};  // 静态子节点在 m_nodes 中连续存放，首字节在 m_first_bytes 中
+            std::uint32_t m_children_count{0};
+            std::uint32_t m_param_child{npos};
+            std::uint32_t m_wildcard_child{npos};
+            std::uint32_t m_values{npos};  // 各方法的值在 m_values 中的起始位置，没有路由时为 npos
+        };
+
+        struct MatchState {
+            Method method;
+            PathParams& params;
+            value_type value;
+            bool path_matched;  // 有路径匹配但方法不匹配的路由，用于区分 404 和 405
+        };
+
+        bool match_node(std::uint32_t index, std::string_view rest, MatchState& state) const;
+        bool take_value(const Node& node, MatchState& state) const noexcept;
+        std::string_view string_at(std::uint32_t offset, std::uint32_t size) const noexcept {
+            return {m_strings.data() + offset, size};
+        }
+
+        std::unique_ptr<BuildNode> m_build_root;
+        std::size_t m_route_count{0};
+
+        std::vector<Node> m_nodes;
+        std::vector<char> m_first_bytes;  // 与 m_nodes 下标对应，静态子节点前缀的第一个字节
+        std::vector<value_type> m_values;  // 每个有路由的节点 method_count 个
+        std::string m_strings;
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_ROUTER_HPP
@@ -0,0 +1,36 @@
+#ifndef CORO_HTTP_SCAN_HPP
+#define CORO_HTTP_SCAN_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace coro::net::tcp::http::detail {
+
+    /**
+     * HTTP 解析用的字节扫描内核，启动时按 CPUID 选择 AVX2 / SSE4.2 实现，其他平台使用标量实现。
+     * 所有函数返回第一个满足条件的字节的下标，没有时返回 size。
+     */
+    enum class ScanLevel {
+        Scalar,
+        Sse42,
+        Avx2,
+    };
+
+    // 第一个控制字符（0x00-0x1f 中除 HTAB 以外的字节，以及 0x7f），行尾的 CR/LF 也属于控制字符
+    std::size_t find_control(const char* data, std::size_t size) noexcept;
+
+    // 第一个不是 tchar（RFC 9110 token 字符）的字节
+    std::size_t find_non_token(const char* data, std::size_t size) noexcept;
+
+    inline std::size_t find_control(std::string_view s) noexcept { return find_control(s.data(), s.size()); }
+    inline std::size_t find_non_token(std::string_view s) noexcept { return find_non_token(s.data(), s.size()); }
+
+    // 当前使用的实现
+    ScanLevel scan_level() noexcept;
+    // 切换实现（不支持的级别会降到 CPU 支持的最高级别），返回实际使用的级别；仅用于测试和基准，不是线程安全的
+    ScanLevel set_scan_level(ScanLevel level) noexcept;
+    const char* to_string(ScanLevel level) noexcept;
+
+} // namespace coro::net::tcp::http::detail
+
+#endif //CORO_HTTP_SCAN_HPP
@@ -0,0 +1,85 @@
+#ifndef CORO_HTTP_STATIC_FILES_HPP
+#define CORO_HTTP_STATIC_FILES_HPP
+
+#include "coro/net/tcp/http/request.hpp"
+#include "coro/net/tcp/http/response.hpp"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace coro::net::tcp::http {
+
+    /**
+     * 静态文件处理：正文用 sendfile 直接从页缓存发送，不读入内存。
+     * 打开的 fd 和 stat 结果放在 LRU 缓存中，文件所在目录用 inotify 监视，文件被修改、替换或删除时缓存失效。
+     * 支持单个 Range（206 / 416）和 If-None-Match（304）。可以被多个 reactor 同时使用。
+     */
+    class StaticFiles {
+    public:
+        struct Options {
+            std::string root;                      // 文件根目录
+            std::size_t max_open_files{256};       // 缓存的 fd 数量上限
+            std::string index_file{"index.html"};  // 路径为空或以 '/' 结尾时使用
+        };
+
+        // root 无法打开时抛出 std::system_error
+        explicit StaticFiles(Options opts);
+        ~StaticFiles();
+
+        StaticFiles(const StaticFiles&) = delete;
+        StaticFiles& operator=(const StaticFiles&) = delete;
+
+        // 用 root 下的 path（URL 编码，相对于 root）填写响应；不允许 ".." 段，也不跟随指向 root 之外的符号链接
+        void serve(std::string_view path, const Request& req, Response& resp);
+
+        // 当前缓存的文件数
+        std::size_t cached() const;
+
+    private:
+        // 缓存的文件，正在发送它的响应也持有一份，淘汰后等发送完成才关闭
+        struct OpenFile {
+            int fd{-1};
+            std::size_t size{0};
+            std::string etag;
+            std::string_view content_type;
+            std::string dir;  // 所在目录（相对于 root），用于 inotify
+
+            ~OpenFile();
+        };
+
+        struct Entry {
+            std::shared_ptr<const OpenFile> file;
+            std::list<std::string>::iterator lru;
+        };
+
+        std::shared_ptr<const OpenFile> open(const std::string& path);
+        std::shared_ptr<const OpenFile> lookup(const std::string& path);
+        void drain_events();
+        void erase(std::unordered_map<std::string, Entry>::iterator it);
+        // 监视目录，同一目录下的文件共用一个监视；失败时返回 false
+        bool watch(const std::string& dir);
+        void unwatch(const std::string& dir);
+
+        Options m_opts;
+        int m_root_fd{-1};
+        int m_inotify_fd{-1};
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+        std::list<std::string> m_lru;  // 最近使用的在前面
+
+        struct Watch {
+            int wd;
+            std::size_t files;  // 这个目录下缓存的文件数，为 0 时移除监视
+        };
+        std::unordered_map<std::string, Watch> m_watches;  // 目录 -> 监视
+        std::unordered_map<int, std::string> m_watch_dirs;  // wd -> 目录
+    };
+
+} // namespace coro::net::tcp::http
+
+#endif //CORO_HTTP_STATIC_FILES_HPP
@@ -3,17 +3,21 @@
 
 #include "coro/net/tcp/client.hpp"
 
+#include <vector>
+
 namespace coro::net::tcp {
 
     class Client;
 
     class Server {
+        friend class ServerGroup;
     public:
         struct LocalEndPoint {
             IpAddress address;
             uint16_t port;
         };
 
+        // port 为 0 时由内核分配一个空闲端口，用 local_end_point() 取得
         Server(std::shared_ptr<IoScheduler> scheduler,LocalEndPoint local_end_point = {.address = IpAddress::from_string("0.0.0.0"), .port = 8080 }, uint32_t backlog = 128);
 
         Server(Server&& other) noexcept;
@@ -21,14 +25,36 @@ namespace coro::net::tcp {
         ~Server() = default;
 
     public:
+        // 把监听 socket 常驻注册到 IoScheduler（EPOLLET），之后 accept() 得到的 Client 也会自动注册
+        void register_socket();
+        bool is_registered() const noexcept { return m_registration != nullptr; }
+
+        // 监听的地址和实际绑定的端口
+        const LocalEndPoint& local_end_point() const noexcept { return m_local_end_point; }
+
         Task<PollStatus> poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
+        // 接受一个连接，没有等待中的连接时返回的 Client 的 socket 无效
         Client accept();
 
+        /**
+         * 循环 accept4 直到 EAGAIN 或者取满 max_count 个，追加到 clients 中，返回本次接受的连接数
+         * 一次 poll 唤醒可以取走连接队列中的所有连接；得到的 socket 都是非阻塞的
+         */
+        std::size_t accept_batch(std::vector<Client>& clients, std::size_t max_count = 64);
+
+        // 停止监听：等待中的 poll 以 Closed/Error 返回，之后不再接受新连接，已经接受的连接不受影响
+        void shutdown();
+
     private:
+        // 非阻塞地 accept4 一个连接，EAGAIN 时清除缓存的就绪状态
+        Socket accept_socket(sockaddr_in& clientaddr);
+        Client make_client(Socket socket, const sockaddr_in& clientaddr);
+
         std::shared_ptr<IoScheduler> m_scheduler;
         LocalEndPoint m_local_end_point;
         Socket m_accept_socket {-1};
+        std::unique_ptr<IoScheduler::Registration> m_registration {nullptr};
 
     };
 
@@ -0,0 +1,59 @@
+#ifndef CORO_SERVER_GROUP_HPP
+#define CORO_SERVER_GROUP_HPP
+
+#include "coro/net/tcp/server.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace coro::net::tcp {
+
+    /**
+     * 多 reactor 的服务端：每个 reactor 是一个 IO 线程内联执行的 IoScheduler，各自持有一个
+     * SO_REUSEPORT 监听 socket，内核在这些 socket 之间分配新连接，连接由接受它的 reactor 处理，
+     * reactor 之间不共享任何队列。
+     * 可选地把 reactor i 绑定到 CPU i，并附加按 CPU 选择监听 socket 的 CBPF 程序，
+     * 使连接由处理它的网卡中断所在的 CPU 接受。
+     */
+    class ServerGroup {
+    public:
+        struct Options {
+            Server::LocalEndPoint local_end_point{.address = IpAddress::from_string("0.0.0.0"), .port = 8080};
+            std::size_t reactors{std::thread::hardware_concurrency()};
+            uint32_t backlog{128};
+            // reactor i 的 IO 线程绑定到 CPU i
+            bool pin_cpus{true};
+            // 附加 SO_ATTACH_REUSEPORT_CBPF 程序，按收到连接的 CPU 选择监听 socket；失败时只打印警告
+            bool steer_by_cpu{false};
+            IoScheduler::IoBackend backend{IoScheduler::IoBackend::Epoll};
+        };
+
+        // 单个 reactor 的组，使用已有的 IoScheduler
+        ServerGroup(std::shared_ptr<IoScheduler> scheduler, Server::LocalEndPoint local_end_point, uint32_t backlog = 128);
+        explicit ServerGroup(Options opts);
+
+        ServerGroup(const ServerGroup&) = delete;
+        ServerGroup& operator=(const ServerGroup&) = delete;
+        ~ServerGroup() = default;
+
+        std::size_t size() const noexcept { return m_reactors.size(); }
+        const std::shared_ptr<IoScheduler>& scheduler(std::size_t index) const { return m_reactors[index].m_scheduler; }
+        Server& server(std::size_t index) { return m_reactors[index].m_server; }
+        // 所有 reactor 共同监听的端口，local_end_point.port 为 0 时是内核分配的端口
+        uint16_t port() const noexcept { return m_reactors.front().m_server.local_end_point().port; }
+
+    private:
+        struct Reactor {
+            std::shared_ptr<IoScheduler> m_scheduler;
+            // 在 m_scheduler 之后声明，保证先注销监听 socket
+            Server m_server;
+        };
+
+        void attach_cpu_steering();
+
+        std::vector<Reactor> m_reactors;
+    };
+
+} // namespace coro::net::tcp
+
+#endif //CORO_SERVER_GROUP_HPP
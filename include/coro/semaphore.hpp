@@ -0,0 +1,116 @@
+#ifndef CORO_SEMAPHORE_HPP
+#define CORO_SEMAPHORE_HPP
+
+#include "coro/detail/poll_info.hpp"
+#include "coro/task.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace coro {
+
+    class IoScheduler;
+    class ThreadPool;
+
+    /**
+     * 协程计数信号量，用于限制并发数（后端调用、每个路由同时处理的请求等），等待时挂起而不阻塞线程。
+     * 状态是一个原子整数：低位是可用的许可数，最高位表示有等待者。没有等待者时 acquire / release 都只有一次 CAS；
+     * 有等待者时新的 acquire 也排队，release 按到达顺序把许可直接交给等待者（FIFO，不会被后来者抢走）。
+     * 等待者由构造时指定的 IoScheduler / ThreadPool 恢复，没有指定时在 release 的线程上直接恢复；
+     * acquire_for 的等待者由传入的 IoScheduler 恢复
+     */
+    class Semaphore {
+    public:
+        explicit Semaphore(std::size_t initial) noexcept : m_state(initial) {}
+        Semaphore(std::size_t initial, std::shared_ptr<IoScheduler> scheduler) noexcept
+            : m_state(initial), m_scheduler(std::move(scheduler)) {}
+        Semaphore(std::size_t initial, ThreadPool& pool) noexcept : m_state(initial), m_pool(&pool) {}
+
+        Semaphore(const Semaphore&) = delete;
+        Semaphore& operator=(const Semaphore&) = delete;
+
+        // 等待队列的节点，放在等待者的协程帧中
+        struct Waiter {
+            Waiter* m_prev{nullptr};
+            Waiter* m_next{nullptr};
+            std::coroutine_handle<> m_handle;
+            // acquire_for 的等待者通过 IoScheduler 的定时等待恢复
+            IoScheduler* m_scheduler{nullptr};
+            detail::PollInfo* m_timer{nullptr};
+            bool m_linked{false};
+        };
+
+        class AcquireAwaiter : private Waiter {
+        public:
+            explicit AcquireAwaiter(Semaphore& semaphore) noexcept : m_semaphore(semaphore) {}
+
+            bool await_ready() noexcept { return m_semaphore.try_acquire(); }
+            bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept;
+            void await_resume() noexcept {}
+
+        private:
+            Semaphore& m_semaphore;
+        };
+
+        // co_await 之后持有一个许可，用完之后 release()
+        [[nodiscard]] AcquireAwaiter acquire() noexcept { return AcquireAwaiter{*this}; }
+
+        // 有可用的许可并且没有等待者时取得一个
+        bool try_acquire() noexcept {
+            auto state = m_state.load(std::memory_order_relaxed);
+            while ((state & waiters_bit) == 0 && state > 0) {
+                if (m_state.compare_exchange_weak(state, state - 1, std::memory_order_acquire,
+                                                  std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * 最多等待 timeout，在 scheduler 的时间轮上计时，取得许可时返回 true。
+         * timeout 为 0 时等同于 try_acquire。等待者从 scheduler 恢复
+         */
+        Task<bool> acquire_for(IoScheduler& scheduler, std::chrono::milliseconds timeout);
+
+        // 归还 n 个许可，先交给等待者
+        void release(std::size_t n = 1);
+
+        // 当前可用的许可数，有等待者时为 0
+        std::size_t available() const noexcept {
+            return static_cast<std::size_t>(m_state.load(std::memory_order_relaxed) & ~waiters_bit);
+        }
+
+    private:
+        static constexpr std::uint64_t waiters_bit = std::uint64_t{1} << 63;
+
+        // 以下需持有 m_mutex
+        // 没有等待者并且有许可时取得一个返回 true，否则把 waiter 放到队尾
+        bool acquire_or_enqueue_locked(Waiter& waiter) noexcept;
+        void unlink_locked(Waiter& waiter) noexcept;
+
+        // 恢复取得许可的等待者
+        void resume(std::coroutine_handle<> handle);
+
+        /**
+         * 有等待者时最高位为 1，低位为 0：许可总是先交给等待者，
+         * 所以只有持有 m_mutex 时才会修改设置了最高位的状态
+         */
+        std::atomic<std::uint64_t> m_state;
+
+        std::mutex m_mutex;
+        Waiter* m_head{nullptr};
+        Waiter* m_tail{nullptr};
+
+        std::shared_ptr<IoScheduler> m_scheduler;
+        ThreadPool* m_pool{nullptr};
+    };
+
+} // namespace coro
+
+#endif //CORO_SEMAPHORE_HPP
@@ -0,0 +1,165 @@
+#ifndef CORO_SINGLE_FLIGHT_HPP
+#define CORO_SINGLE_FLIGHT_HPP
+
+#include "coro/io_scheduler.hpp"
+#include "coro/task.hpp"
+#include "coro/thread_pool.hpp"
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace coro {
+
+    /**
+     * 合并同一个 key 的并发加载：某个 key 没有进行中的加载时，第一个调用 run 的协程执行 loader，
+     * 在它完成之前对同一个 key 调用 run 的协程挂起（不阻塞线程），完成后全部得到同一个结果的副本，
+     * loader 抛出的异常也会在每个等待者中重新抛出。加载完成后 key 被移除，之后的调用重新加载。
+     * 等待者由构造时指定的 IoScheduler / ThreadPool 恢复，没有指定时在执行 loader 的协程完成时依次直接恢复
+     */
+    template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class SingleFlight {
+        static_assert(std::is_copy_constructible_v<T>, "SingleFlight<Key, T> shares copies of the result");
+
+    public:
+        SingleFlight() = default;
+        explicit SingleFlight(std::shared_ptr<IoScheduler> scheduler) : m_scheduler(std::move(scheduler)) {}
+        explicit SingleFlight(ThreadPool& pool) : m_pool(&pool) {}
+
+        SingleFlight(const SingleFlight&) = delete;
+        SingleFlight& operator=(const SingleFlight&) = delete;
+
+        /**
+         * loader 是返回 Task<T> 的可调用对象，只在没有同一个 key 的进行中的加载时被调用。
+         * 调用者的协程帧保存了 key 和 loader，调用时可以传临时对象
+         */
+        template <typename Loader>
+            requires std::invocable<Loader&> && std::convertible_to<std::invoke_result_t<Loader&>, Task<T>>
+        Task<T> run(Key key, Loader loader) {
+            std::shared_ptr<Call> call;
+            bool leader{false};
+            {
+                std::scoped_lock lk{m_mutex};
+                auto [it, inserted] = m_calls.try_emplace(key);
+                if (inserted) {
+                    it->second = std::make_shared<Call>();
+                }
+                call = it->second;
+                leader = inserted;
+            }
+
+            if (!leader) {
+                co_await WaitAwaiter{*this, *call};
+                co_return call->get();
+            }
+
+            try {
+                call->m_value.emplace(co_await std::invoke(loader));
+            } catch (...) {
+                call->m_exception = std::current_exception();
+            }
+            complete(key, *call);
+            co_return call->get();
+        }
+
+        // 正在进行中的加载数
+        std::size_t in_flight() const {
+            std::scoped_lock lk{m_mutex};
+            return m_calls.size();
+        }
+
+    private:
+        struct Waiter {
+            Waiter* m_next{nullptr};
+            std::coroutine_handle<> m_handle;
+        };
+
+        // 一次加载，等待者持有 shared_ptr，在 key 被移除之后仍然可以读取结果
+        struct Call {
+            std::optional<T> m_value;
+            std::exception_ptr m_exception;
+            // 以下需持有 SingleFlight::m_mutex
+            bool m_done{false};
+            Waiter* m_head{nullptr};
+            Waiter* m_tail{nullptr};
+
+            T get() const {
+                if (m_exception) {
+                    std::rethrow_exception(m_exception);
+                }
+                return *m_value;
+            }
+        };
+
+        class WaitAwaiter : private Waiter {
+        public:
+            WaitAwaiter(SingleFlight& flight, Call& call) noexcept : m_flight(flight), m_call(call) {}
+
+            bool await_ready() noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
+                this->m_handle = awaiting_coroutine;
+                std::scoped_lock lk{m_flight.m_mutex};
+                if (m_call.m_done) {
+                    return false;
+                }
+                if (m_call.m_tail != nullptr) {
+                    m_call.m_tail->m_next = this;
+                } else {
+                    m_call.m_head = this;
+                }
+                m_call.m_tail = this;
+                return true;
+            }
+            void await_resume() noexcept {}
+
+        private:
+            SingleFlight& m_flight;
+            Call& m_call;
+        };
+
+        // 结果已经写入 call：移除 key，按到达顺序恢复等待者
+        void complete(const Key& key, Call& call) {
+            Waiter* waiter;
+            {
+                std::scoped_lock lk{m_mutex};
+                m_calls.erase(key);
+                call.m_done = true;
+                waiter = std::exchange(call.m_head, nullptr);
+                call.m_tail = nullptr;
+            }
+            while (waiter != nullptr) {
+                // 恢复之后等待者的协程帧可能已经销毁
+                auto* next = waiter->m_next;
+                resume(waiter->m_handle);
+                waiter = next;
+            }
+        }
+
+        void resume(std::coroutine_handle<> handle) {
+            if (m_scheduler && m_scheduler->resume(handle)) {
+                return;
+            }
+            if (m_pool != nullptr && m_pool->resume(handle)) {
+                return;
+            }
+            handle.resume();
+        }
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<Key, std::shared_ptr<Call>, Hash, KeyEqual> m_calls;
+
+        std::shared_ptr<IoScheduler> m_scheduler;
+        ThreadPool* m_pool{nullptr};
+    };
+
+} // namespace coro
+
+#endif //CORO_SINGLE_FLIGHT_HPP
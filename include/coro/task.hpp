@@ -12,6 +12,8 @@
 #include <type_traits>
 #include <utility>
 
+#include "coro/detail/frame_allocator.hpp"
+
 namespace coro::detail {
 
     struct PromiseBase {
@@ -35,6 +37,10 @@ namespace coro::detail {
         PromiseBase() = default;
         virtual ~PromiseBase() = default;
 
+        // 协程帧从线程本地的帧池分配
+        static void* operator new(std::size_t size) { return FrameAllocator::allocate(size); }
+        static void operator delete(void* ptr) noexcept { FrameAllocator::deallocate(ptr); }
+
         auto initial_suspend() { return std::suspend_always{}; }
         auto final_suspend() noexcept { return ReturnPreviousAwaiter{m_previousHandle}; }
 
@@ -224,7 +230,7 @@ namespace coro {
                     m_currentHandle.promise().continuation(h);
                     return m_currentHandle;
                 }
-                auto await_resume() noexcept { return m_currentHandle.promise().result(); }
+                auto await_resume() { return m_currentHandle.promise().result(); }
 
                 coroutine_handle m_currentHandle;
             };
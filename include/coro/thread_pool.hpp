@@ -4,18 +4,29 @@
 #include <iostream>
 #include "coro/task.hpp"
 #include "coro/detail/self_deleting_task.hpp"
+#include "coro/detail/work_stealing_deque.hpp"
 
+#include <atomic>
 #include <coroutine>
+#include <memory>
 #include <thread>
 #include <queue>
 #include <mutex>
+#include <span>
 #include <vector>
 #include <condition_variable>
 
 namespace coro {
     class ThreadPool {
     public:
-        ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+        // 任务队列的组织方式
+        enum class QueueStrategy {
+            Global,         // 所有线程共享一个加锁的全局队列
+            WorkStealing,   // 每个线程拥有一个无锁的本地队列，空闲线程从其他线程窃取任务
+        };
+
+        ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency(),
+                   QueueStrategy strategy = QueueStrategy::WorkStealing);
         ~ThreadPool();
         ThreadPool&operator=(ThreadPool &&) = delete;
 
@@ -25,9 +36,10 @@ namespace coro {
 
             auto await_ready() noexcept { return false; }
 
-            // 在协程内部调用co_await tp.schedule(), 此处会将当前协程，即 awaiting_coroutine 放入ThreadPool的工作队列中
+            // 在协程内部调用co_await tp.schedule(), 此处会将当前协程，即 awaiting_coroutine 放入ThreadPool的工作队列中。
+            // 协程把自己重新排队，总是进入 FIFO 的全局队列，排在已经提交的任务之后
             auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
-                pool.scheduler_impl(awaiting_coroutine);
+                pool.scheduler_impl(awaiting_coroutine, true);
             }
 
             auto await_resume() noexcept {}
@@ -52,6 +64,12 @@ namespace coro {
          */
         bool resume(std::coroutine_handle<> handle);
 
+        /**
+         * 批量恢复协程句柄：整批只加一次锁入队，并且只唤醒需要的工作线程（最多 handles.size() 个）
+         * @return 实际入队的句柄数量，线程池停止时为 0
+         */
+        std::size_t resume(std::span<std::coroutine_handle<>> handles);
+
         /**
          * todo 在线程池上调度任务，并返回另一个等待原任务完成的新任务（返回值与原任务相同）
          * @param task 在线程池上调度的任务
@@ -73,17 +91,40 @@ namespace coro {
             return m_size.load(std::memory_order_acquire);
         }
 
+        QueueStrategy queue_strategy() const noexcept { return m_strategy; }
+
 
     private:
+        using local_queue = detail::WorkStealingDeque<std::coroutine_handle<>>;
+
         void executor();
-        void scheduler_impl(std::coroutine_handle<> handle) noexcept;
+        void work_stealing_executor(std::size_t index);
+        // fifo 为 true 时工作窃取模式下也放入全局队列，否则工作线程提交的任务放入自己的本地队列（后进先出）
+        void scheduler_impl(std::coroutine_handle<> handle, bool fifo = false) noexcept;
 
+        /**
+         * 工作窃取模式下依次从本地队列、全局队列、其他线程的队列中取任务；
+         * 每从本地队列取 global_check_interval 个任务先检查一次全局队列，本地队列一直不空时全局队列也不会饿死
+         */
+        std::coroutine_handle<> next_task(std::size_t index);
+        std::coroutine_handle<> pop_global();
+        static constexpr std::size_t global_check_interval = 61;
+        bool has_pending_work() const noexcept;
+        // 唤醒至多 count 个睡眠中的工作线程
+        void notify_sleeping(std::size_t count = 1);
+
+        QueueStrategy m_strategy;
         std::vector<std::thread> m_threads;
         std::queue<std::coroutine_handle<>> m_queue;
         std::mutex m_queue_mutex;
         std::atomic<bool> m_stop{false};
         std::condition_variable m_cv;
 
+        // 工作窃取模式：每个线程一个本地队列；非线程池线程提交的任务仍进入 m_queue
+        std::vector<std::unique_ptr<local_queue>> m_local_queues;
+        std::atomic<std::size_t> m_global_size{0};
+        std::atomic<std::size_t> m_sleeping{0};
+
         // 任务队列中等待的任务数量 + 正在执行的任务。
         std::atomic<std::size_t> m_size{0};
     };
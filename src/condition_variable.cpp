@@ -0,0 +1,65 @@
+#include "coro/condition_variable.hpp"
+
+#include <utility>
+
+namespace coro {
+
+    std::coroutine_handle<> ConditionVariable::WaitAwaiter::await_suspend(
+            std::coroutine_handle<> awaiting_coroutine) noexcept {
+        m_handle = awaiting_coroutine;
+        auto& mutex = m_mutex;
+        {
+            std::scoped_lock lk{m_cv.m_waiters_mutex};
+            if (m_cv.m_tail != nullptr) {
+                m_cv.m_tail->m_cv_next = this;
+            } else {
+                m_cv.m_head = this;
+            }
+            m_cv.m_tail = this;
+        }
+        // 从这里开始可能已经被通知，它重新加锁时会排在锁的等待者中，不能再访问 this。
+        // 锁交给下一个等待者（可能就是自己）时用对称转移恢复，不在这里递归
+        if (auto next = mutex.release()) {
+            return mutex.transfer(next);
+        }
+        return std::noop_coroutine();
+    }
+
+    void ConditionVariable::notify_one() {
+        WaitAwaiter* waiter;
+        {
+            std::scoped_lock lk{m_waiters_mutex};
+            waiter = m_head;
+            if (waiter == nullptr) {
+                return;
+            }
+            m_head = waiter->m_cv_next;
+            if (m_head == nullptr) {
+                m_tail = nullptr;
+            }
+        }
+        relock(*waiter);
+    }
+
+    void ConditionVariable::notify_all() {
+        WaitAwaiter* waiter;
+        {
+            std::scoped_lock lk{m_waiters_mutex};
+            waiter = std::exchange(m_head, nullptr);
+            m_tail = nullptr;
+        }
+        while (waiter != nullptr) {
+            auto* next = waiter->m_cv_next;
+            relock(*waiter);
+            waiter = next;
+        }
+    }
+
+    void ConditionVariable::relock(WaitAwaiter& waiter) {
+        auto& mutex = waiter.m_mutex;
+        if (!mutex.enqueue(waiter)) {
+            mutex.transfer(waiter.m_handle).resume();
+        }
+    }
+
+} // namespace coro
@@ -0,0 +1,224 @@
+#include "coro/detail/frame_allocator.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+namespace coro::detail {
+
+    namespace {
+        constexpr std::size_t header_size = 16;
+        constexpr std::size_t class_granularity = 16;
+        constexpr std::size_t class_count = 128;  // 最大 2048 字节（含头部）
+        constexpr std::size_t max_cached_per_class = 1024;
+        constexpr std::uint32_t large_class = UINT32_MAX;
+
+        class ThreadCache;
+
+        struct BlockHeader {
+            ThreadCache* m_owner;     // nullptr 表示直接来自全局 operator new
+            std::uint32_t m_size_class;
+        };
+        static_assert(sizeof(BlockHeader) <= header_size);
+
+        struct FreeBlock {
+            FreeBlock* m_next;
+        };
+
+        std::atomic<bool> g_enabled{true};
+
+        // 所属线程退出后，远程栈被置为这个值，之后释放的块直接还给全局 operator delete
+        FreeBlock* const closed_stack = reinterpret_cast<FreeBlock*>(std::uintptr_t{1});
+
+        class ThreadCache {
+        public:
+            void* allocate(std::uint32_t size_class) {
+                auto& list = m_free[size_class];
+                if (list.m_head == nullptr) {
+                    drain_remote();
+                }
+
+                FreeBlock* block = list.m_head;
+                if (block != nullptr) {
+                    list.m_head = block->m_next;
+                    --list.m_count;
+                } else {
+                    block = static_cast<FreeBlock*>(::operator new((size_class + 1) * class_granularity));
+                }
+
+                ++m_live;
+                return block;
+            }
+
+            // 仅所属线程调用
+            void deallocate_local(void* ptr, std::uint32_t size_class) noexcept {
+                --m_live;
+                auto& list = m_free[size_class];
+                if (list.m_count >= max_cached_per_class) {
+                    ::operator delete(ptr);
+                    return;
+                }
+                auto* block = static_cast<FreeBlock*>(ptr);
+                block->m_next = list.m_head;
+                list.m_head = block;
+                ++list.m_count;
+            }
+
+            // 其他线程调用
+            void deallocate_remote(void* ptr) noexcept {
+                auto* block = static_cast<FreeBlock*>(ptr);
+                auto head = m_remote.load(std::memory_order_relaxed);
+                do {
+                    if (head == closed_stack) {
+                        ::operator delete(ptr);
+                        release_orphan();
+                        return;
+                    }
+                    block->m_next = head;
+                } while (!m_remote.compare_exchange_weak(head, block, std::memory_order_release,
+                                                         std::memory_order_relaxed));
+            }
+
+            // 线程退出时调用：释放缓存，并把仍在外面的块交给最后一个释放者负责回收本对象
+            void close() noexcept {
+                auto* remote = m_remote.exchange(closed_stack, std::memory_order_acquire);
+                m_live -= free_chain(remote);
+                for (auto& list : m_free) {
+                    free_chain(list.m_head);
+                    list = FreeList{};
+                }
+
+                auto outstanding = static_cast<std::int64_t>(m_live);
+                if (m_orphans.fetch_add(outstanding, std::memory_order_acq_rel) + outstanding == 0) {
+                    delete this;
+                }
+            }
+
+        private:
+            struct FreeList {
+                FreeBlock* m_head{nullptr};
+                std::size_t m_count{0};
+            };
+
+            void drain_remote() noexcept {
+                if (m_remote.load(std::memory_order_relaxed) == nullptr) {
+                    return;
+                }
+                auto* block = m_remote.exchange(nullptr, std::memory_order_acquire);
+                while (block != nullptr) {
+                    auto* next = block->m_next;
+                    auto* header = reinterpret_cast<BlockHeader*>(block);
+                    // 块的头部在释放时仍然保留着大小类
+                    deallocate_local(block, header->m_size_class);
+                    block = next;
+                }
+            }
+
+            static std::size_t free_chain(FreeBlock* block) noexcept {
+                std::size_t count{0};
+                while (block != nullptr) {
+                    auto* next = block->m_next;
+                    ::operator delete(block);
+                    block = next;
+                    ++count;
+                }
+                return count;
+            }
+
+            void release_orphan() noexcept {
+                if (m_orphans.fetch_sub(1, std::memory_order_acq_rel) - 1 == 0) {
+                    delete this;
+                }
+            }
+
+            std::array<FreeList, class_count> m_free{};
+            std::size_t m_live{0};  // 本线程分配出去、还没有还回来的块数
+
+            alignas(64) std::atomic<FreeBlock*> m_remote{nullptr};
+            // 线程退出后仍在外面的块数，close() 之前远程释放会先把它减成负数
+            std::atomic<std::int64_t> m_orphans{0};
+        };
+
+        // 线程退出时关闭本线程的缓存；之后（例如其他 thread_local 析构时）的分配直接使用全局 operator new
+        struct ThreadCacheHolder {
+            ~ThreadCacheHolder() {
+                if (m_cache != nullptr) {
+                    auto* cache = m_cache;
+                    m_cache = nullptr;
+                    t_destroyed = true;
+                    cache->close();
+                }
+            }
+
+            ThreadCache* get() {
+                if (m_cache == nullptr && !t_destroyed) {
+                    m_cache = new ThreadCache();
+                }
+                return m_cache;
+            }
+
+            ThreadCache* m_cache{nullptr};
+            static thread_local bool t_destroyed;
+        };
+
+        thread_local bool ThreadCacheHolder::t_destroyed{false};
+        thread_local ThreadCacheHolder t_cache_holder{};
+
+        ThreadCache* current_cache() noexcept {
+            if (ThreadCacheHolder::t_destroyed) {
+                return nullptr;
+            }
+            return t_cache_holder.get();
+        }
+    }
+
+    void* FrameAllocator::allocate(std::size_t size) {
+        auto total = size + header_size;
+        auto size_class = static_cast<std::uint32_t>((total + class_granularity - 1) / class_granularity - 1);
+
+        ThreadCache* cache{nullptr};
+        void* block{nullptr};
+        if (size_class < class_count && g_enabled.load(std::memory_order_relaxed)) {
+            cache = current_cache();
+        }
+
+        if (cache != nullptr) {
+            block = cache->allocate(size_class);
+        } else {
+            block = ::operator new(total);
+            size_class = large_class;
+        }
+
+        auto* header = static_cast<BlockHeader*>(block);
+        header->m_owner = cache;
+        header->m_size_class = size_class;
+        return static_cast<std::byte*>(block) + header_size;
+    }
+
+    void FrameAllocator::deallocate(void* ptr) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        auto* block = static_cast<std::byte*>(ptr) - header_size;
+        auto* header = reinterpret_cast<BlockHeader*>(block);
+        auto* owner = header->m_owner;
+        if (owner == nullptr) {
+            ::operator delete(block);
+            return;
+        }
+
+        // 空闲块的 m_next 与头部的 m_owner 重叠，大小类保留在头部中
+        if (!ThreadCacheHolder::t_destroyed && owner == t_cache_holder.m_cache) {
+            owner->deallocate_local(block, header->m_size_class);
+        } else {
+            owner->deallocate_remote(block);
+        }
+    }
+
+    void FrameAllocator::set_enabled(bool enabled) noexcept { g_enabled.store(enabled, std::memory_order_relaxed); }
+
+    bool FrameAllocator::enabled() noexcept { return g_enabled.load(std::memory_order_relaxed); }
+
+} // namespace coro::detail
@@ -1,5 +1,11 @@
 #include "coro/io_scheduler.hpp"
+#include "coro/detail/io_uring.hpp"
 
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <system_error>
 
@@ -7,6 +13,19 @@ using namespace std::chrono_literals;
 
 namespace coro {
 
+    namespace {
+        void pin_current_thread(int cpu) {
+            auto cpus = std::max(1u, std::thread::hardware_concurrency());
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(static_cast<unsigned>(cpu) % cpus, &set);
+            if (auto error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); error != 0) {
+                std::cerr << "IoScheduler failed to pin io thread to cpu " << cpu << ": " << std::strerror(error)
+                          << "\n";
+            }
+        }
+    }
+
     IoScheduler::IoScheduler(Options opts)
         : m_opts(opts),
           m_epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
@@ -17,6 +36,15 @@ namespace coro {
             throw std::system_error(errno, std::system_category(),
                                     "Failed to create scheduler fds");
         }
+
+        if (m_opts.backend == IoBackend::IoUring) {
+            try {
+                m_uring = std::make_unique<detail::IoUring>();
+            } catch (const std::system_error&) {
+                // 内核不支持 io_uring（或被禁用），退回 epoll
+                m_uring = nullptr;
+            }
+        }
     }
 
     std::shared_ptr<IoScheduler> IoScheduler::make_shared(Options opts) {
@@ -24,7 +52,7 @@ namespace coro {
             std::shared_ptr<IoScheduler>(new IoScheduler(std::move(opts)));
 
         if (opts.execution_strategy == ExecutionStrategy::On_ThreadPool) {
-            s->m_thread_pool = std::make_unique<ThreadPool>(s->m_opts.threads_count);
+            s->m_thread_pool = std::make_unique<ThreadPool>(s->m_opts.threads_count, s->m_opts.queue_strategy);
         }
 
         struct epoll_event e{};
@@ -40,7 +68,18 @@ namespace coro {
         e.data.ptr = const_cast<void*>(m_schedule_ptr);
         epoll_ctl(s->m_epoll_fd, EPOLL_CTL_ADD, s->m_schedule_fd, &e);
 
-        s->m_io_thread = std::thread([s] { s->run(); });
+        // 完成队列中有 cqe 时 io_uring 的 fd 可读
+        if (s->m_uring) {
+            e.data.ptr = const_cast<void*>(m_uring_ptr);
+            epoll_ctl(s->m_epoll_fd, EPOLL_CTL_ADD, s->m_uring->fd(), &e);
+        }
+
+        s->m_io_thread = std::thread([s] {
+            if (s->m_opts.io_thread_cpu >= 0) {
+                pin_current_thread(s->m_opts.io_thread_cpu);
+            }
+            s->run();
+        });
 
         return s;
     }
@@ -75,6 +114,15 @@ namespace coro {
 
     void IoScheduler::run() {
         while (!m_shutdown.load(std::memory_order_acquire) || size() > 0) {
+            {
+                // 在这之前注销的 fd 已经从 epoll 删除，上一轮返回的事件也处理完了，可以安全释放
+                std::vector<std::unique_ptr<detail::FdRecord>> retired{};
+                {
+                    std::scoped_lock<std::mutex> lk{m_retired_records_mutex};
+                    retired.swap(m_retired_records);
+                }
+            }
+
             auto event_count = epoll_wait(m_epoll_fd, m_events.data(), m_max_events, -1);
 
             if (event_count > 0) {
@@ -86,10 +134,16 @@ namespace coro {
                         on_timeout();
                     } else if (handle_ptr == m_schedule_ptr) {
                         on_schedule();
+                    } else if (handle_ptr == m_uring_ptr) {
+                        on_uring_completion();
                     } else if (handle_ptr == m_shutdown_ptr) [[unlikely]] {
                         eventfd_t val{0};
                         eventfd_read(m_shutdown_fd, &val);
 
+                    } else if (reinterpret_cast<std::uintptr_t>(handle_ptr) & m_record_tag) {
+                        auto address = reinterpret_cast<std::uintptr_t>(handle_ptr) & ~m_record_tag;
+                        on_fd_event(*reinterpret_cast<detail::FdRecord*>(address), event.events);
+
                         // 处理io事件
                     } else {
                         auto* pi = static_cast<detail::PollInfo*>(handle_ptr);
@@ -104,8 +158,8 @@ namespace coro {
                             }
 
                             // io事件被触发了，删除定时事件
-                            if (pi->m_timer_pos.has_value()) {
-                                remove_timer_token(pi->m_timer_pos.value());
+                            if (pi->m_expire_tick != 0) {
+                                remove_timer_token(*pi);
                             }
 
                             pi->m_poll_status = event_to_poll_status(event.events);
@@ -114,43 +168,26 @@ namespace coro {
                                 std::atomic_thread_fence(std::memory_order::acquire);
                             }
 
+                            std::scoped_lock<std::mutex> lk{m_tasks_mutex};
                             m_tasks.emplace_back(pi->m_awaiting_handle);
                         }
                     }
                 }
             }
-            //            if (!m_tasks.empty()) {
-            //                if (m_opts.execution_strategy ==
-            //                ExecutionStrategy::On_ThreadInline) {
-            //                    for (auto& handle : m_tasks) {
-            //                        handle.resume();
-            //                    }
-            //                } else {
-            //                    // m_thread_pool->resume(m_tasks);
-            //                    for (auto& handle : m_tasks) {
-            //                        m_thread_pool->resume(handle);
-            //                    }
-            //                }
-            //
-            //                m_tasks.clear();
-            //                std::cout << "清空了m_tasks()" << strNow() << "\n";
-            //            }
-            if (!m_tasks.empty()) {
-                std::vector<std::coroutine_handle<>> tasks{};
-                {
-                    std::scoped_lock<std::mutex> lk{m_tasks_mutex};
-                    tasks.swap(m_tasks);
-                }
+            {
+                std::scoped_lock<std::mutex> lk{m_tasks_mutex};
+                m_io_tasks.swap(m_tasks);
+            }
+            if (!m_io_tasks.empty()) {
                 if (m_opts.execution_strategy == ExecutionStrategy::On_ThreadInline) {
-                    for (auto& handle : tasks) {
+                    for (auto& handle : m_io_tasks) {
                         handle.resume();
                     }
                 } else {
-                    // m_thread_pool->resume(tasks);
-                    for (auto& handle : tasks) {
-                        m_thread_pool->resume(handle);
-                    }
+                    // 一次 epoll_wait 中就绪的协程整批交给线程池，只加一次锁
+                    m_thread_pool->resume(m_io_tasks);
                 }
+                m_io_tasks.clear();
             }
         }
     }
@@ -199,6 +236,10 @@ namespace coro {
         }
     }
 
+    IoScheduler::IoBackend IoScheduler::backend() const noexcept {
+        return m_uring ? IoBackend::IoUring : IoBackend::Epoll;
+    }
+
     std::size_t IoScheduler::size() const noexcept {
         if (m_opts.execution_strategy == ExecutionStrategy::On_ThreadInline) {
             return m_size.load(std::memory_order::acquire);
@@ -208,25 +249,16 @@ namespace coro {
     }
 
     void IoScheduler::on_timeout() {
-        std::vector<detail::PollInfo*> poll_infos{};
-        auto now = clock::now();
+        std::vector<detail::TimerNode*> expired{};
         {
             std::scoped_lock<std::mutex> lk{m_timed_events_mutex};
-            while (!m_timed_events.empty()) {
-                auto first = m_timed_events.begin();
-                auto [tp, pi] = *first;
-
-                // 把超时的事件都加入 poll_infos
-                if (tp <= now) {
-                    m_timed_events.erase(first);
-                    poll_infos.emplace_back(pi);
-                } else {
-                    break;
-                }
-            }
+            // 把超时的事件都从时间轮上摘下，并且每个 tick 只重新设置一次 timerfd
+            m_timing_wheel.advance(clock::now(), expired);
+            update_timeout();
         }
 
-        for (auto pi : poll_infos) {
+        for (auto* node : expired) {
+            auto* pi = static_cast<detail::PollInfo*>(node);
             if (!pi->m_processed) {
                 // 事件和超时可能发生在同一次epoll_wait调用中，确保只有一个被处理
                 pi->m_processed = true;
@@ -236,18 +268,28 @@ namespace coro {
                     epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, pi->m_fd, nullptr);
                 }
 
+                // 常驻注册的 fd 保留在 epoll 中，只撤下等待者
+                if (pi->m_record != nullptr) {
+                    std::scoped_lock<std::mutex> lk{pi->m_record->m_mutex};
+                    if (pi->m_record->m_read.m_waiter == pi) {
+                        pi->m_record->m_read.m_waiter = nullptr;
+                    }
+                    if (pi->m_record->m_write.m_waiter == pi) {
+                        pi->m_record->m_write.m_waiter = nullptr;
+                    }
+                }
+
                 while (pi->m_awaiting_handle == nullptr) {
                     std::atomic_thread_fence(std::memory_order::acquire);
                     // std::cerr << "process_event_execute() has a nullptr event\n";
                 }
 
-                m_tasks.emplace_back(pi->m_awaiting_handle);
                 // 设置这些事件的 PollStatus 为 Timeout
                 pi->m_poll_status = PollStatus::Timeout;
+                std::scoped_lock<std::mutex> lk{m_tasks_mutex};
+                m_tasks.emplace_back(pi->m_awaiting_handle);
             }
         }
-
-        update_timeout(clock::now());
     }
 
     void IoScheduler::on_schedule() {
@@ -275,6 +317,13 @@ namespace coro {
     Task<> IoScheduler::schedule_after(std::chrono::milliseconds amount) {
         if (amount <= 0ms) {
             co_await schedule();
+        } else if (m_uring) {
+            detail::UringOp op{};
+            op.m_sqe.opcode = IORING_OP_TIMEOUT;
+            op.m_sqe.fd = -1;
+            op.m_sqe.addr = reinterpret_cast<std::uint64_t>(&op.m_timeout);
+            op.m_sqe.len = 1;
+            co_await uring_execute(op, amount);
         } else {
             m_size.fetch_add(1, std::memory_order_release);
             detail::PollInfo pi{};
@@ -290,6 +339,8 @@ namespace coro {
         auto now = clock::now();
         if (time <= now) {
             co_await schedule();
+        } else if (m_uring) {
+            co_await schedule_after(std::chrono::duration_cast<std::chrono::milliseconds>(time - now));
         } else {
             m_size.fetch_add(1, std::memory_order_release);
             auto amount = std::chrono::duration_cast<std::chrono::milliseconds>(time - now);
@@ -312,6 +363,21 @@ namespace coro {
     }
 
     Task<PollStatus> IoScheduler::poll(int fd, PollOp op, std::chrono::milliseconds timeout) {
+        if (m_uring) {
+            // 一个 POLL_ADD sqe 代替 epoll_ctl(ADD) + epoll_ctl(DEL)
+            detail::UringOp uop{};
+            uop.m_sqe.opcode = IORING_OP_POLL_ADD;
+            uop.m_sqe.fd = fd;
+            uop.m_sqe.poll32_events = static_cast<std::uint32_t>(op) | EPOLLRDHUP;
+            auto res = co_await uring_execute(uop, timeout);
+            if (res == -ETIMEDOUT) {
+                co_return PollStatus::Timeout;
+            } else if (res < 0) {
+                co_return PollStatus::Error;
+            }
+            co_return event_to_poll_status(static_cast<uint32_t>(res));
+        }
+
         m_size.fetch_add(1, std::memory_order_release);
 
         bool timeout_requested = (timeout > 0ms);
@@ -320,7 +386,7 @@ namespace coro {
         pi.m_fd = fd;
 
         if (timeout_requested) {
-            pi.m_timer_pos = add_time_token(clock::now() + timeout, pi);
+            add_time_token(clock::now() + timeout, pi);
         }
 
         epoll_event e{};
@@ -339,82 +405,523 @@ namespace coro {
         co_return result;
     }
 
-    PollStatus IoScheduler::event_to_poll_status(uint32_t events) {
-        if (events & EPOLLIN || events & EPOLLOUT) {
-            return PollStatus::Event;
-        } else if (events & EPOLLERR) {
-            return PollStatus::Error;
-        } else if (events & EPOLLRDHUP || events & EPOLLHUP) {
-            return PollStatus::Closed;
+    IoScheduler::Registration::Registration(IoScheduler& scheduler, int fd)
+        : m_scheduler(scheduler), m_record(new detail::FdRecord(fd)) {
+        epoll_event e{};
+        // 读写两个方向一起注册，边沿触发，之后不再修改
+        e.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        e.data.ptr = reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(m_record) | m_record_tag);
+        if (epoll_ctl(m_scheduler.m_epoll_fd, EPOLL_CTL_ADD, fd, &e) == -1) {
+            auto error = errno;
+            delete m_record;
+            throw std::system_error(error, std::system_category(), "Failed to register fd");
         }
-        throw std::runtime_error{"event_to_poll_status: unknown PollStatus"};
     }
 
-    auto IoScheduler::add_time_token(time_point tp, detail::PollInfo& pi)
-        -> timed_events::iterator {
-        std::scoped_lock<std::mutex> lk{m_timed_events_mutex};
-        auto pos = m_timed_events.emplace(tp, &pi);
+    IoScheduler::Registration::~Registration() { m_scheduler.deregister(m_record); }
+
+    std::uint64_t IoScheduler::Registration::sequence(PollOp op) noexcept {
+        std::scoped_lock<std::mutex> lk{m_record->m_mutex};
+        return poll_op_readable(op) ? m_record->m_read.m_sequence : m_record->m_write.m_sequence;
+    }
+
+    bool IoScheduler::Registration::ready(PollOp op) noexcept {
+        std::scoped_lock<std::mutex> lk{m_record->m_mutex};
+        return (poll_op_readable(op) && m_record->m_read.m_events != 0) ||
+               (poll_op_writeable(op) && m_record->m_write.m_events != 0);
+    }
 
-        // 如果插入的时间点是最早的，则更新 timerfd 触发时间
-        if (pos == m_timed_events.begin()) {
-            update_timeout(clock::now());
+    void IoScheduler::Registration::clear_ready(PollOp op, std::uint64_t sequence) noexcept {
+        std::scoped_lock<std::mutex> lk{m_record->m_mutex};
+        // 序号变化说明 EAGAIN 之后又来了边沿事件，清除会丢失这次唤醒
+        if (poll_op_readable(op) && m_record->m_read.m_sequence == sequence) {
+            m_record->m_read.m_events = 0;
+        }
+        if (poll_op_writeable(op) && m_record->m_write.m_sequence == sequence) {
+            m_record->m_write.m_events = 0;
         }
+    }
 
-        return pos;
+    std::unique_ptr<IoScheduler::Registration> IoScheduler::register_fd(int fd) {
+        return std::make_unique<Registration>(*this, fd);
     }
 
-    void IoScheduler::remove_timer_token(timed_events::iterator pos) {
+    void IoScheduler::deregister(detail::FdRecord* record) {
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, record->m_fd, nullptr);
+        std::scoped_lock<std::mutex> lk{m_retired_records_mutex};
+        m_retired_records.emplace_back(record);
+    }
+
+    struct IoScheduler::RegisteredPollAwaiter {
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> awaiting_handle) noexcept {
+            std::scoped_lock<std::mutex> lk{m_record.m_mutex};
+
+            std::uint32_t events{0};
+            if (poll_op_readable(m_op)) {
+                events |= m_record.m_read.m_events;
+            }
+            if (poll_op_writeable(m_op)) {
+                events |= m_record.m_write.m_events;
+            }
+            // 缓存的状态已经就绪，不挂起
+            if (events != 0) {
+                m_pi.m_poll_status = m_scheduler.event_to_poll_status(events);
+                return false;
+            }
+
+            if ((poll_op_readable(m_op) && m_record.m_read.m_waiter != nullptr) ||
+                (poll_op_writeable(m_op) && m_record.m_write.m_waiter != nullptr)) {
+                std::cerr << "fd " << m_record.m_fd << " already has a waiter in this direction\n";
+                m_pi.m_poll_status = PollStatus::Error;
+                return false;
+            }
+
+            m_pi.m_awaiting_handle = awaiting_handle;
+            m_pi.m_record = &m_record;
+            if (poll_op_readable(m_op)) {
+                m_record.m_read.m_waiter = &m_pi;
+            }
+            if (poll_op_writeable(m_op)) {
+                m_record.m_write.m_waiter = &m_pi;
+            }
+
+            // 持有 m_mutex 时加入定时器，超时处理需要先拿到这把锁才能撤下等待者
+            if (m_timeout > std::chrono::milliseconds(0)) {
+                m_scheduler.add_time_token(clock::now() + m_timeout, m_pi);
+            }
+            return true;
+        }
+        PollStatus await_resume() noexcept { return m_pi.m_poll_status; }
+
+        IoScheduler& m_scheduler;
+        detail::FdRecord& m_record;
+        PollOp m_op;
+        std::chrono::milliseconds m_timeout;
+        detail::PollInfo& m_pi;
+    };
+
+    Task<PollStatus> IoScheduler::poll(Registration& registration, PollOp op, std::chrono::milliseconds timeout) {
+        m_size.fetch_add(1, std::memory_order_release);
+        detail::PollInfo pi{};
+        auto result = co_await RegisteredPollAwaiter{*this, *registration.m_record, op, timeout, pi};
+        m_size.fetch_sub(1, std::memory_order_release);
+        co_return result;
+    }
+
+    /**
+     * 通知和超时的竞争在 m_timed_events_mutex 下决定：等待者持有这把锁时加入时间轮，
+     * notify_waiter 持有这把锁时如果还能把它从时间轮上摘下就算通知成功；
+     * 已经被 on_timeout 摘下的等待者只由 IO 线程处理，notify_waiter 不再访问它
+     */
+    struct IoScheduler::NotifiedAwaiter {
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> awaiting_handle) noexcept {
+            std::scoped_lock<std::mutex> lk{m_scheduler.m_timed_events_mutex};
+            if (m_pi.m_processed.load(std::memory_order_relaxed)) {
+                // 已经被通知，不挂起
+                return false;
+            }
+            m_pi.m_awaiting_handle = awaiting_handle;
+            m_scheduler.add_time_token_locked(clock::now() + m_timeout, m_pi);
+            return true;
+        }
+        PollStatus await_resume() noexcept { return m_pi.m_poll_status; }
+
+        IoScheduler& m_scheduler;
+        detail::PollInfo& m_pi;
+        std::chrono::milliseconds m_timeout;
+    };
+
+    Task<PollStatus> IoScheduler::wait_notified(detail::PollInfo& pi, std::chrono::milliseconds timeout) {
+        m_size.fetch_add(1, std::memory_order_release);
+        auto result = co_await NotifiedAwaiter{*this, pi, std::max(timeout, std::chrono::milliseconds(1))};
+        m_size.fetch_sub(1, std::memory_order_release);
+        co_return result;
+    }
+
+    bool IoScheduler::notify_waiter(detail::PollInfo& pi) {
+        std::coroutine_handle<> handle;
         {
             std::scoped_lock<std::mutex> lk{m_timed_events_mutex};
-            // 检查是否是最早的任务
-            auto is_first = (m_timed_events.begin() == pos);
+            if (pi.m_awaiting_handle == nullptr) {
+                // 还没有开始等待
+                pi.m_poll_status = PollStatus::Event;
+                pi.m_processed.store(true, std::memory_order_relaxed);
+                return true;
+            }
+            if (!pi.is_linked()) {
+                // 已经超时
+                return false;
+            }
+            m_timing_wheel.remove(pi);
+            pi.m_processed.store(true, std::memory_order_relaxed);
+            pi.m_poll_status = PollStatus::Event;
+            handle = pi.m_awaiting_handle;
+        }
+        // 调用方可能持有自己的锁，不在这里直接恢复
+        resume(handle);
+        return true;
+    }
 
-            m_timed_events.erase(pos);
+    void IoScheduler::on_fd_event(detail::FdRecord& record, uint32_t events) {
+        detail::PollInfo* reader{nullptr};
+        detail::PollInfo* writer{nullptr};
+        {
+            std::scoped_lock<std::mutex> lk{record.m_mutex};
+            if (auto read_events = events & detail::FdRecord::read_events; read_events != 0) {
+                record.m_read.m_events |= read_events;
+                ++record.m_read.m_sequence;
+                reader = std::exchange(record.m_read.m_waiter, nullptr);
+            }
+            if (auto write_events = events & detail::FdRecord::write_events; write_events != 0) {
+                record.m_write.m_events |= write_events;
+                ++record.m_write.m_sequence;
+                writer = std::exchange(record.m_write.m_waiter, nullptr);
+            }
 
-            // 如果被删除的是最早的任务，则需要更新 timerfd
-            if (is_first) {
-                update_timeout(clock::now());
+            // PollOp::ReadWrite 的等待者同时挂在两个方向上
+            if (reader != nullptr && record.m_write.m_waiter == reader) {
+                record.m_write.m_waiter = nullptr;
+            }
+            if (writer != nullptr && record.m_read.m_waiter == writer) {
+                record.m_read.m_waiter = nullptr;
+            }
+            if (writer == reader) {
+                writer = nullptr;
             }
         }
+
+        for (auto* pi : {reader, writer}) {
+            if (pi == nullptr || pi->m_processed) {
+                continue;
+            }
+            pi->m_processed = true;
+            if (pi->m_expire_tick != 0) {
+                remove_timer_token(*pi);
+            }
+            pi->m_poll_status = event_to_poll_status(events);
+
+            std::scoped_lock<std::mutex> lk{m_tasks_mutex};
+            m_tasks.emplace_back(pi->m_awaiting_handle);
+        }
     }
 
-    void IoScheduler::update_timeout(time_point now) {
-        if (!m_timed_events.empty()) {
-            // 获取最早的任务
-            auto& [tp, pi] = *m_timed_events.begin();
-            // 计算距离现在的时间间隔
-            auto amount = tp - now;
+    struct IoScheduler::UringAwaiter {
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> awaiting_handle) noexcept {
+            m_op.m_awaiting_handle = awaiting_handle;
+            // 提交失败时不挂起，直接返回错误
+            return m_scheduler.uring_submit(m_op);
+        }
+        int await_resume() noexcept { return m_op.m_result; }
 
-            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(amount);
-            amount -= seconds;
-            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(amount);
+        IoScheduler& m_scheduler;
+        detail::UringOp& m_op;
+    };
 
-            if (seconds <= 0s) {
-                seconds = 0s;
-                if (nanoseconds <= 0ns) {
-                    // 设置为1纳秒，确保定时器不会被禁用,而是立即触发
-                    nanoseconds = 1ns;
-                }
+    Task<int> IoScheduler::uring_execute(detail::UringOp& op, std::chrono::milliseconds timeout) {
+        if (timeout > 0ms && op.m_sqe.opcode != IORING_OP_TIMEOUT) {
+            op.m_has_timeout = true;
+        }
+        if (timeout > 0ms) {
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            op.m_timeout.tv_sec = seconds.count();
+            op.m_timeout.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count();
+        }
+
+        m_size.fetch_add(1, std::memory_order_release);
+        auto res = co_await UringAwaiter{*this, op};
+        m_size.fetch_sub(1, std::memory_order_release);
+
+        // 被 LINK_TIMEOUT 取消，或 TIMEOUT 到期
+        if ((op.m_has_timeout && res == -ECANCELED) || (op.m_sqe.opcode == IORING_OP_TIMEOUT && res == -ETIME)) {
+            co_return -ETIMEDOUT;
+        }
+        co_return res;
+    }
+
+    bool IoScheduler::uring_submit(detail::UringOp& op) {
+        std::scoped_lock<std::mutex> lk{m_uring_mutex};
+
+        unsigned needed = op.m_has_timeout ? 2 : 1;
+        if (m_uring->sq_space() < needed) {
+            m_uring->submit();
+            if (m_uring->sq_space() < needed) {
+                op.m_result = -EBUSY;
+                return false;
             }
+        }
 
-            itimerspec ts{};
-            ts.it_value.tv_sec = seconds.count();
-            ts.it_value.tv_nsec = nanoseconds.count();
-            // 更新 timerfd 的定时器时间
-            if (timerfd_settime(m_timer_fd, 0, &ts, nullptr) == -1) {
-                std::cerr << "failed to set timerfd errorno=[" << std::string{strerror(errno)}
-                          << "].";
+        auto* sqe = m_uring->get_sqe();
+        *sqe = op.m_sqe;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(&op);
+
+        if (op.m_has_timeout) {
+            sqe->flags |= IOSQE_IO_LINK;
+            auto* timeout_sqe = m_uring->get_sqe();
+            timeout_sqe->opcode = IORING_OP_LINK_TIMEOUT;
+            timeout_sqe->fd = -1;
+            timeout_sqe->addr = reinterpret_cast<std::uint64_t>(&op.m_timeout);
+            timeout_sqe->len = 1;
+            // user_data 为 0 的 cqe 在完成时被忽略
+            timeout_sqe->user_data = 0;
+        }
+
+        // sqe 已经发布，即使 io_uring_enter 失败也会在下次提交时被内核取走，因此这里总是挂起
+        if (auto ret = m_uring->submit(); ret < 0) {
+            std::cerr << "io_uring_enter failed errorno=[" << std::string{strerror(-ret)} << "].\n";
+        }
+        return true;
+    }
+
+    void IoScheduler::on_uring_completion() {
+        std::vector<std::coroutine_handle<>> handles{};
+        m_uring->for_each_cqe([&](const io_uring_cqe& cqe) {
+            if (cqe.user_data == 0) {
+                return;
             }
-        } else {
-            // 如果没有定时任务，则禁用 timerfd
+            auto* op = reinterpret_cast<detail::UringOp*>(cqe.user_data);
+            op->m_result = cqe.res;
+            handles.emplace_back(op->m_awaiting_handle);
+        });
+
+        {
+            // 之前 io_uring_enter 失败时遗留的 sqe
+            std::scoped_lock<std::mutex> lk{m_uring_mutex};
+            if (m_uring->has_unsubmitted()) {
+                m_uring->submit();
+            }
+        }
+
+        if (!handles.empty()) {
+            std::scoped_lock<std::mutex> lk{m_tasks_mutex};
+            m_tasks.insert(m_tasks.end(), handles.begin(), handles.end());
+        }
+    }
+
+    Task<int> IoScheduler::recv(int fd, std::span<char> buffer, std::chrono::milliseconds timeout) {
+        if (m_uring) {
+            detail::UringOp op{};
+            op.m_sqe.opcode = IORING_OP_RECV;
+            op.m_sqe.fd = fd;
+            op.m_sqe.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+            op.m_sqe.len = static_cast<std::uint32_t>(buffer.size());
+            co_return co_await uring_execute(op, timeout);
+        }
+
+        while (true) {
+            auto n = ::recv(fd, buffer.data(), buffer.size(), 0);
+            if (n >= 0) {
+                co_return static_cast<int>(n);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                co_return -errno;
+            }
+
+            auto pstatus = co_await poll(fd, PollOp::Read, timeout);
+            if (pstatus == PollStatus::Timeout) {
+                co_return -ETIMEDOUT;
+            }
+        }
+    }
+
+    Task<int> IoScheduler::send(int fd, std::span<const char> buffer, std::chrono::milliseconds timeout) {
+        if (m_uring) {
+            detail::UringOp op{};
+            op.m_sqe.opcode = IORING_OP_SEND;
+            op.m_sqe.fd = fd;
+            op.m_sqe.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+            op.m_sqe.len = static_cast<std::uint32_t>(buffer.size());
+            op.m_sqe.msg_flags = MSG_NOSIGNAL;
+            co_return co_await uring_execute(op, timeout);
+        }
+
+        while (true) {
+            auto n = ::send(fd, buffer.data(), buffer.size(), MSG_NOSIGNAL);
+            if (n >= 0) {
+                co_return static_cast<int>(n);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                co_return -errno;
+            }
+
+            auto pstatus = co_await poll(fd, PollOp::Write, timeout);
+            if (pstatus == PollStatus::Timeout) {
+                co_return -ETIMEDOUT;
+            }
+        }
+    }
+
+    Task<int> IoScheduler::accept(int fd, sockaddr* addr, socklen_t* addrlen, std::chrono::milliseconds timeout) {
+        if (m_uring) {
+            detail::UringOp op{};
+            op.m_sqe.opcode = IORING_OP_ACCEPT;
+            op.m_sqe.fd = fd;
+            op.m_sqe.addr = reinterpret_cast<std::uint64_t>(addr);
+            op.m_sqe.addr2 = reinterpret_cast<std::uint64_t>(addrlen);
+            op.m_sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+            co_return co_await uring_execute(op, timeout);
+        }
+
+        while (true) {
+            auto client_fd = ::accept4(fd, addr, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client_fd >= 0) {
+                co_return client_fd;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                co_return -errno;
+            }
+
+            auto pstatus = co_await poll(fd, PollOp::Read, timeout);
+            if (pstatus == PollStatus::Timeout) {
+                co_return -ETIMEDOUT;
+            }
+        }
+    }
+
+    Task<int> IoScheduler::connect(int fd, const sockaddr* addr, socklen_t addrlen, std::chrono::milliseconds timeout) {
+        if (m_uring) {
+            detail::UringOp op{};
+            op.m_sqe.opcode = IORING_OP_CONNECT;
+            op.m_sqe.fd = fd;
+            op.m_sqe.addr = reinterpret_cast<std::uint64_t>(addr);
+            op.m_sqe.off = addrlen;
+            co_return co_await uring_execute(op, timeout);
+        }
+
+        if (::connect(fd, addr, addrlen) == 0) {
+            co_return 0;
+        } else if (errno != EINPROGRESS && errno != EAGAIN) {
+            co_return -errno;
+        }
+
+        auto pstatus = co_await poll(fd, PollOp::Write, timeout);
+        if (pstatus == PollStatus::Timeout) {
+            co_return -ETIMEDOUT;
+        }
+
+        int result{0};
+        socklen_t len{sizeof(result)};
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &result, &len) < 0) {
+            co_return -errno;
+        }
+        co_return -result;
+    }
+
+    Task<int> IoScheduler::recv(Registration& registration, std::span<char> buffer,
+                                std::chrono::milliseconds timeout) {
+        while (true) {
+            auto sequence = registration.sequence(PollOp::Read);
+            auto n = ::recv(registration.fd(), buffer.data(), buffer.size(), 0);
+            if (n >= 0) {
+                co_return static_cast<int>(n);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                co_return -errno;
+            } else if (errno != EINTR) {
+                registration.clear_ready(PollOp::Read, sequence);
+            }
+
+            auto pstatus = co_await poll(registration, PollOp::Read, timeout);
+            if (pstatus == PollStatus::Timeout) {
+                co_return -ETIMEDOUT;
+            }
+        }
+    }
+
+    Task<int> IoScheduler::send(Registration& registration, std::span<const char> buffer,
+                                std::chrono::milliseconds timeout) {
+        while (true) {
+            auto sequence = registration.sequence(PollOp::Write);
+            auto n = ::send(registration.fd(), buffer.data(), buffer.size(), MSG_NOSIGNAL);
+            if (n >= 0) {
+                co_return static_cast<int>(n);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                co_return -errno;
+            } else if (errno != EINTR) {
+                registration.clear_ready(PollOp::Write, sequence);
+            }
+
+            auto pstatus = co_await poll(registration, PollOp::Write, timeout);
+            if (pstatus == PollStatus::Timeout) {
+                co_return -ETIMEDOUT;
+            }
+        }
+    }
+
+    Task<int> IoScheduler::accept(Registration& registration, sockaddr* addr, socklen_t* addrlen,
+                                  std::chrono::milliseconds timeout) {
+        while (true) {
+            auto sequence = registration.sequence(PollOp::Read);
+            auto client_fd = ::accept4(registration.fd(), addr, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client_fd >= 0) {
+                co_return client_fd;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                co_return -errno;
+            } else if (errno != EINTR) {
+                registration.clear_ready(PollOp::Read, sequence);
+            }
+
+            auto pstatus = co_await poll(registration, PollOp::Read, timeout);
+            if (pstatus == PollStatus::Timeout) {
+                co_return -ETIMEDOUT;
+            }
+        }
+    }
+
+    PollStatus IoScheduler::event_to_poll_status(uint32_t events) {
+        if (events & EPOLLIN || events & EPOLLOUT) {
+            return PollStatus::Event;
+        } else if (events & EPOLLERR) {
+            return PollStatus::Error;
+        } else if (events & EPOLLRDHUP || events & EPOLLHUP) {
+            return PollStatus::Closed;
+        }
+        throw std::runtime_error{"event_to_poll_status: unknown PollStatus"};
+    }
+
+    void IoScheduler::add_time_token(time_point tp, detail::PollInfo& pi) {
+        std::scoped_lock<std::mutex> lk{m_timed_events_mutex};
+        add_time_token_locked(tp, pi);
+    }
+
+    void IoScheduler::add_time_token_locked(time_point tp, detail::PollInfo& pi) {
+        auto tick = m_timing_wheel.add(pi, tp);
+
+        // 只有比 timerfd 当前的触发时间更早时才需要重新设置
+        if (!m_armed_tick.has_value() || tick < m_armed_tick.value()) {
+            m_armed_tick = tick;
             itimerspec ts{};
-            ts.it_value.tv_sec = 0;
-            ts.it_value.tv_nsec = 0;
-            if (timerfd_settime(m_timer_fd, 0, &ts, nullptr) == -1) {
+            auto expiry = m_timing_wheel.tick_to_time(tick).time_since_epoch();
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(expiry);
+            ts.it_value.tv_sec = seconds.count();
+            ts.it_value.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(expiry - seconds).count();
+            if (timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &ts, nullptr) == -1) {
                 std::cerr << "failed to set timerfd errorno=[" << std::string{strerror(errno)}
                           << "].";
             }
         }
     }
 
+    void IoScheduler::remove_timer_token(detail::PollInfo& pi) {
+        // 取消是 O(1) 的，不重新设置 timerfd，多余的一次唤醒会在 on_timeout() 中重新计算
+        std::scoped_lock<std::mutex> lk{m_timed_events_mutex};
+        m_timing_wheel.remove(pi);
+    }
+
+    void IoScheduler::update_timeout() {
+        // steady_clock 即 CLOCK_MONOTONIC，直接使用绝对时间
+        itimerspec ts{};
+        m_armed_tick = m_timing_wheel.next_tick();
+        if (m_armed_tick.has_value()) {
+            auto expiry = m_timing_wheel.tick_to_time(m_armed_tick.value()).time_since_epoch();
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(expiry);
+            ts.it_value.tv_sec = seconds.count();
+            ts.it_value.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(expiry - seconds).count();
+        }
+
+        // 没有定时任务时 it_value 为 0，禁用 timerfd
+        if (timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &ts, nullptr) == -1) {
+            std::cerr << "failed to set timerfd errorno=[" << std::string{strerror(errno)}
+                      << "].";
+        }
+    }
+
 }  // namespace coro
\ No newline at end of file
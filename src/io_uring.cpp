@@ -0,0 +1,156 @@
+#include "coro/detail/io_uring.hpp"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace coro::detail {
+
+    namespace {
+        int io_uring_setup(unsigned entries, io_uring_params* p) {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+        }
+
+        int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        template<typename T>
+        T* ring_ptr(void* ring, unsigned offset) {
+            return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+        }
+    }
+
+    IoUring::IoUring(unsigned entries) {
+        io_uring_params params{};
+        m_ring_fd = io_uring_setup(entries, &params);
+        if (m_ring_fd < 0) {
+            throw std::system_error(errno, std::system_category(), "io_uring_setup failed");
+        }
+
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        }
+
+        m_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         m_ring_fd, IORING_OFF_SQ_RING);
+        if (m_sq_ring == MAP_FAILED) {
+            auto err = errno;
+            ::close(m_ring_fd);
+            throw std::system_error(err, std::system_category(), "io_uring sq ring mmap failed");
+        }
+
+        if (single_mmap) {
+            m_cq_ring = m_sq_ring;
+        } else {
+            m_cq_ring = mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             m_ring_fd, IORING_OFF_CQ_RING);
+            if (m_cq_ring == MAP_FAILED) {
+                auto err = errno;
+                munmap(m_sq_ring, m_sq_ring_size);
+                ::close(m_ring_fd);
+                throw std::system_error(err, std::system_category(), "io_uring cq ring mmap failed");
+            }
+        }
+
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        auto* sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          m_ring_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            auto err = errno;
+            if (m_cq_ring != m_sq_ring) {
+                munmap(m_cq_ring, m_cq_ring_size);
+            }
+            munmap(m_sq_ring, m_sq_ring_size);
+            ::close(m_ring_fd);
+            throw std::system_error(err, std::system_category(), "io_uring sqes mmap failed");
+        }
+        m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+        m_sq_head = ring_ptr<unsigned>(m_sq_ring, params.sq_off.head);
+        m_sq_tail = ring_ptr<unsigned>(m_sq_ring, params.sq_off.tail);
+        m_sq_mask = ring_ptr<unsigned>(m_sq_ring, params.sq_off.ring_mask);
+        m_sq_entries = ring_ptr<unsigned>(m_sq_ring, params.sq_off.ring_entries);
+        m_sq_flags = ring_ptr<unsigned>(m_sq_ring, params.sq_off.flags);
+        m_sq_array = ring_ptr<unsigned>(m_sq_ring, params.sq_off.array);
+        m_sq_local_tail = m_sq_submitted = *m_sq_tail;
+
+        m_cq_head = ring_ptr<unsigned>(m_cq_ring, params.cq_off.head);
+        m_cq_tail = ring_ptr<unsigned>(m_cq_ring, params.cq_off.tail);
+        m_cq_mask = ring_ptr<unsigned>(m_cq_ring, params.cq_off.ring_mask);
+        m_cqes = ring_ptr<io_uring_cqe>(m_cq_ring, params.cq_off.cqes);
+    }
+
+    IoUring::~IoUring() {
+        munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring != m_sq_ring) {
+            munmap(m_cq_ring, m_cq_ring_size);
+        }
+        munmap(m_sq_ring, m_sq_ring_size);
+        ::close(m_ring_fd);
+    }
+
+    io_uring_sqe* IoUring::get_sqe() noexcept {
+        auto head = std::atomic_ref<unsigned>(*m_sq_head).load(std::memory_order_acquire);
+        if (m_sq_local_tail - head >= *m_sq_entries) {
+            return nullptr;
+        }
+
+        auto index = m_sq_local_tail & *m_sq_mask;
+        ++m_sq_local_tail;
+        auto* sqe = &m_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    unsigned IoUring::sq_space() const noexcept {
+        auto head = std::atomic_ref<unsigned>(*m_sq_head).load(std::memory_order_acquire);
+        return *m_sq_entries - (m_sq_local_tail - head);
+    }
+
+    bool IoUring::has_unsubmitted() const noexcept {
+        // 已发布但内核尚未取走的 sqe（之前的 io_uring_enter 失败）
+        auto head = std::atomic_ref<unsigned>(*m_sq_head).load(std::memory_order_acquire);
+        return m_sq_local_tail != head;
+    }
+
+    int IoUring::submit() noexcept {
+        for (auto tail = m_sq_submitted; tail != m_sq_local_tail; ++tail) {
+            m_sq_array[tail & *m_sq_mask] = tail & *m_sq_mask;
+        }
+        std::atomic_ref<unsigned>(*m_sq_tail).store(m_sq_local_tail, std::memory_order_release);
+        m_sq_submitted = m_sq_local_tail;
+
+        // 包含之前 io_uring_enter 失败后仍留在提交队列中的 sqe
+        auto head = std::atomic_ref<unsigned>(*m_sq_head).load(std::memory_order_acquire);
+        auto to_submit = m_sq_local_tail - head;
+        if (to_submit == 0) {
+            return 0;
+        }
+
+        int ret;
+        do {
+            ret = io_uring_enter(m_ring_fd, to_submit, 0, 0);
+        } while (ret < 0 && errno == EINTR);
+
+        return ret < 0 ? -errno : ret;
+    }
+
+    bool IoUring::cq_overflowed() const noexcept {
+        return std::atomic_ref<unsigned>(*m_sq_flags).load(std::memory_order_relaxed) & IORING_SQ_CQ_OVERFLOW;
+    }
+
+    int IoUring::flush_overflow() noexcept {
+        auto ret = io_uring_enter(m_ring_fd, 0, 0, IORING_ENTER_GETEVENTS);
+        return ret < 0 ? -errno : ret;
+    }
+
+} // namespace coro::detail
@@ -0,0 +1,63 @@
+#include "coro/mutex.hpp"
+#include "coro/io_scheduler.hpp"
+#include "coro/thread_pool.hpp"
+
+namespace coro {
+
+    bool Mutex::enqueue(Waiter& waiter) noexcept {
+        void* state = m_state.load(std::memory_order_acquire);
+        while (true) {
+            if (state == unlocked()) {
+                if (m_state.compare_exchange_weak(state, nullptr, std::memory_order_acquire,
+                                                  std::memory_order_acquire)) {
+                    return false;
+                }
+            } else {
+                waiter.m_next = static_cast<Waiter*>(state);
+                if (m_state.compare_exchange_weak(state, &waiter, std::memory_order_release,
+                                                  std::memory_order_acquire)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    std::coroutine_handle<> Mutex::release() noexcept {
+        Waiter* waiter = m_waiters;
+        if (waiter == nullptr) {
+            void* expected = nullptr;
+            if (m_state.compare_exchange_strong(expected, unlocked(), std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+                return {};
+            }
+            // 取走新到的等待者，栈中是后到的在前，反转成先到的在前
+            auto* stack = static_cast<Waiter*>(m_state.exchange(nullptr, std::memory_order_acquire));
+            while (stack != nullptr) {
+                auto* next = stack->m_next;
+                stack->m_next = waiter;
+                waiter = stack;
+                stack = next;
+            }
+        }
+        // 锁保持占用状态，直接交给等待者
+        m_waiters = waiter->m_next;
+        return waiter->m_handle;
+    }
+
+    std::coroutine_handle<> Mutex::transfer(std::coroutine_handle<> handle) {
+        if (m_scheduler && m_scheduler->resume(handle)) {
+            return std::noop_coroutine();
+        }
+        if (m_pool != nullptr && m_pool->resume(handle)) {
+            return std::noop_coroutine();
+        }
+        return handle;
+    }
+
+    void Mutex::unlock() {
+        if (auto handle = release()) {
+            transfer(handle).resume();
+        }
+    }
+
+} // namespace coro
@@ -5,6 +5,7 @@ namespace coro::net {
     static const std::string recv_status_ok{"ok"};
     static const std::string recv_status_closed{"closed"};
     static const std::string recv_status_udp_not_bound{"udp_not_bound"};
+    static const std::string recv_status_timeout{"timeout"};
     static const std::string recv_status_would_block{"would_block"};
     static const std::string recv_status_connection_refused{"connection_refused"};
     static const std::string recv_status_interrupted{"interrupted"};
@@ -22,6 +23,8 @@ namespace coro::net {
                 return recv_status_closed;
             case RecvStatus::UdpNotBound:
                 return recv_status_udp_not_bound;
+            case RecvStatus::Timeout:
+                return recv_status_timeout;
             case RecvStatus::WouldBlock:
                 return recv_status_would_block;
             case RecvStatus::ConnectionRefused:
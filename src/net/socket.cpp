@@ -59,9 +59,14 @@ namespace coro::net {
     Socket make_accept_socket(const IpAddress &ip, uint16_t port, int backlog, SocketType type) {
         Socket sock = make_nonblocking_socket(type);
 
+        // SO_REUSEADDR 和 SO_REUSEPORT 是两个独立的选项，不能按位或在一次调用里设置
         int opt{1};
-        if (setsockopt(sock.fd(), SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
-            throw std::runtime_error{"Failed to setsockopt(SO_REUSEADDR | SO_REUSEPORT)"};
+        if (setsockopt(sock.fd(), SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+            throw std::runtime_error{"Failed to setsockopt(SO_REUSEADDR)"};
+        }
+        // 多个监听 socket 可以绑定同一个端口，由内核在它们之间分配新连接
+        if (setsockopt(sock.fd(), SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            throw std::runtime_error{"Failed to setsockopt(SO_REUSEPORT)"};
         }
 
         sockaddr_in server{};
@@ -1,8 +1,39 @@
 #include "coro/net/tcp/client.hpp"
 
+#include <sys/sendfile.h>
+
+#include <climits>
+#include <csignal>
+
 
 namespace coro::net::tcp {
 
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        // 截止时间剩余的等待时间；不超时返回 0，已经过期返回 nullopt
+        std::optional<std::chrono::milliseconds> remaining_until(std::optional<clock::time_point> deadline) {
+            if (!deadline) {
+                return std::chrono::milliseconds(0);
+            }
+            auto now = clock::now();
+            if (now >= *deadline) {
+                return std::nullopt;
+            }
+            // 向上取整，避免剩余不足 1ms 时变成 0（不超时）
+            return std::chrono::ceil<std::chrono::milliseconds>(*deadline - now);
+        }
+
+        std::optional<clock::time_point> make_deadline(std::chrono::milliseconds timeout) {
+            if (timeout <= std::chrono::milliseconds(0)) {
+                return std::nullopt;
+            }
+            return clock::now() + timeout;
+        }
+
+        bool would_block(long status) { return status == EAGAIN || status == EWOULDBLOCK; }
+    }
+
     Client::Client(std::shared_ptr<IoScheduler> scheduler, RemoteEndPoint remote_end_point)
         : m_scheduler(std::move(scheduler)), m_remote_endpoint(remote_end_point), m_socket(make_nonblocking_socket()) {
         if (m_scheduler == nullptr) {
@@ -13,14 +44,22 @@ namespace coro::net::tcp {
     Client::Client(const Client& other)
         : m_scheduler(other.m_scheduler),
           m_remote_endpoint(other.m_remote_endpoint),
-          m_socket(other.m_socket), m_connect_status(other.m_connect_status) {}
+          m_socket(other.m_socket), m_connect_status(other.m_connect_status) {
+        if (other.m_registration) {
+            register_socket();
+        }
+    }
 
     Client& Client::operator=(const Client& other) {
         if (std::addressof(other) != this) {
+            m_registration = nullptr;
             m_scheduler = other.m_scheduler;
             m_remote_endpoint = other.m_remote_endpoint;
             m_socket = other.m_socket;
             m_connect_status = other.m_connect_status;
+            if (other.m_registration) {
+                register_socket();
+            }
         }
         return *this;
     }
@@ -29,10 +68,13 @@ namespace coro::net::tcp {
         : m_scheduler(std::move(other.m_scheduler)),
           m_remote_endpoint(std::move(other.m_remote_endpoint)),
           m_socket(std::move(other.m_socket)),
-          m_connect_status(std::exchange(other.m_connect_status, std::nullopt)) {}
+          m_connect_status(std::exchange(other.m_connect_status, std::nullopt)),
+          m_registration(std::move(other.m_registration)) {}
 
     Client& Client::operator=(Client&& other) noexcept {
         if (std::addressof(other) != this) {
+            // 先注销旧的 fd 再关闭它
+            m_registration = std::move(other.m_registration);
             m_scheduler = std::move(other.m_scheduler);
             m_remote_endpoint = std::move(other.m_remote_endpoint);
             m_socket = std::move(other.m_socket);
@@ -43,7 +85,16 @@ namespace coro::net::tcp {
 
     Client::~Client() {}
 
+    void Client::register_socket() {
+        if (m_registration == nullptr && m_socket.is_valid()) {
+            m_registration = m_scheduler->register_fd(m_socket.fd());
+        }
+    }
+
     Task<PollStatus> Client::poll(PollOp op, std::chrono::milliseconds timeout) {
+        if (m_registration) {
+            return m_scheduler->poll(*m_registration, op, timeout);
+        }
         return m_scheduler->poll(m_socket, op, timeout);
     }
 
@@ -64,6 +115,9 @@ namespace coro::net::tcp {
         clientaddr.sin_port = htons(m_remote_endpoint.port);
         clientaddr.sin_addr = *reinterpret_cast<const in_addr*>(m_remote_endpoint.address.data().data());
 
+        // 未连接的 socket 注册时就会报告 EPOLLHUP 等事件，连接开始后需要清除这些过期的就绪状态
+        auto read_sequence = m_registration ? m_registration->sequence(PollOp::Read) : 0;
+        auto write_sequence = m_registration ? m_registration->sequence(PollOp::Write) : 0;
         auto cret = ::connect(m_socket.fd(), (struct sockaddr*)&clientaddr, sizeof(clientaddr));
         if (cret == 0) {
             co_return return_value(ConnectStatus::Connected);
@@ -71,8 +125,12 @@ namespace coro::net::tcp {
             // 连接未立即完成（非阻塞模式）
         } else if (cret == -1) {
             if (errno == EAGAIN || errno == EINPROGRESS) {
+                if (m_registration) {
+                    m_registration->clear_ready(PollOp::Read, read_sequence);
+                    m_registration->clear_ready(PollOp::Write, write_sequence);
+                }
                 // 等待可写事件
-                auto pstatus = co_await m_scheduler->poll(m_socket, PollOp::Write, timeout);
+                auto pstatus = co_await poll(PollOp::Write, timeout);
                 if (pstatus == PollStatus::Event) {
                     int result {0};
                     socklen_t len {sizeof(result)};
@@ -92,6 +150,226 @@ namespace coro::net::tcp {
         co_return return_value(ConnectStatus::Error);
     }
 
+    Task<std::pair<RecvStatus, std::span<char>>> Client::read_some(std::span<char> buffer,
+                                                                   std::chrono::milliseconds timeout) {
+        auto deadline = make_deadline(timeout);
+        bool hangup{false};
+        while (true) {
+            // 常驻注册时缓存的状态为未就绪，recv 必然 EAGAIN，直接等待
+            if (!m_registration || m_registration->ready(PollOp::Read)) {
+                auto [status, data] = recv_into(buffer);
+                if (!would_block(static_cast<long>(status))) {
+                    co_return {status, data};
+                }
+            }
+            if (hangup) {
+                // poll 报告了错误或挂断，但 recv 仍然没有数据也没有错误，不再等待
+                co_return {RecvStatus::Closed, std::span<char>{}};
+            }
+
+            auto wait = remaining_until(deadline);
+            if (!wait) {
+                co_return {RecvStatus::Timeout, std::span<char>{}};
+            }
+            auto pstatus = co_await poll(PollOp::Read, *wait);
+            if (pstatus == PollStatus::Timeout) {
+                co_return {RecvStatus::Timeout, std::span<char>{}};
+            }
+            hangup = pstatus != PollStatus::Event;
+        }
+    }
+
+    Task<std::pair<RecvStatus, std::size_t>> Client::read_exact(std::span<char> buffer,
+                                                                std::chrono::milliseconds timeout) {
+        auto deadline = make_deadline(timeout);
+        std::size_t total{0};
+        while (total < buffer.size()) {
+            auto wait = remaining_until(deadline);
+            if (!wait) {
+                co_return {RecvStatus::Timeout, total};
+            }
+            auto [status, data] = co_await read_some(buffer.subspan(total), *wait);
+            if (status != RecvStatus::Ok) {
+                co_return {status, total};
+            }
+            total += data.size();
+        }
+        co_return {RecvStatus::Ok, total};
+    }
+
+    Task<std::pair<SendStatus, std::size_t>> Client::write_all(std::span<const char> buffer,
+                                                               std::chrono::milliseconds timeout) {
+        auto deadline = make_deadline(timeout);
+        auto rest = buffer;
+        bool hangup{false};
+        while (!rest.empty()) {
+            if (!m_registration || m_registration->ready(PollOp::Write)) {
+                auto [status, unsent] = send_from(rest);
+                if (status == SendStatus::Ok) {
+                    rest = unsent;
+                    hangup = false;
+                    continue;
+                }
+                if (!would_block(static_cast<long>(status))) {
+                    co_return {status, buffer.size() - rest.size()};
+                }
+            }
+            if (hangup) {
+                co_return {SendStatus::Closed, buffer.size() - rest.size()};
+            }
+
+            auto wait = remaining_until(deadline);
+            if (!wait) {
+                co_return {SendStatus::Timeout, buffer.size() - rest.size()};
+            }
+            auto pstatus = co_await poll(PollOp::Write, *wait);
+            if (pstatus == PollStatus::Timeout) {
+                co_return {SendStatus::Timeout, buffer.size() - rest.size()};
+            }
+            hangup = pstatus != PollStatus::Event;
+        }
+        co_return {SendStatus::Ok, buffer.size()};
+    }
+
+    auto Client::sendv_from(std::span<const iovec> buffers) -> std::pair<SendStatus, std::size_t> {
+        msghdr message{};
+        message.msg_iov = const_cast<iovec*>(buffers.data());
+        message.msg_iovlen = std::min<std::size_t>(buffers.size(), IOV_MAX);
+        if (message.msg_iovlen == 0) {
+            return {SendStatus::Ok, 0};
+        }
+
+        auto sequence = m_registration ? m_registration->sequence(PollOp::Write) : 0;
+        auto bytes_sent = ::sendmsg(m_socket.fd(), &message, MSG_NOSIGNAL);
+        if (bytes_sent >= 0) {
+            return {SendStatus::Ok, static_cast<std::size_t>(bytes_sent)};
+        }
+        auto error = errno;
+        if (m_registration && would_block(error)) {
+            m_registration->clear_ready(PollOp::Write, sequence);
+        }
+        return {static_cast<SendStatus>(error), 0};
+    }
+
+    Task<std::pair<SendStatus, std::size_t>> Client::writev_all(std::span<iovec> buffers,
+                                                                std::chrono::milliseconds timeout) {
+        auto deadline = make_deadline(timeout);
+        std::size_t total{0};
+        bool hangup{false};
+        // 跳过已经发完（或者本来就为空）的段
+        auto skip_empty = [&] {
+            while (!buffers.empty() && buffers.front().iov_len == 0) {
+                buffers = buffers.subspan(1);
+            }
+        };
+
+        skip_empty();
+        while (!buffers.empty()) {
+            if (!m_registration || m_registration->ready(PollOp::Write)) {
+                auto [status, sent] = sendv_from(buffers);
+                if (status == SendStatus::Ok) {
+                    total += sent;
+                    while (sent > 0) {
+                        auto& front = buffers.front();
+                        auto n = std::min(sent, front.iov_len);
+                        front.iov_base = static_cast<char*>(front.iov_base) + n;
+                        front.iov_len -= n;
+                        sent -= n;
+                        skip_empty();
+                    }
+                    hangup = false;
+                    continue;
+                }
+                if (!would_block(static_cast<long>(status))) {
+                    co_return {status, total};
+                }
+            }
+            if (hangup) {
+                co_return {SendStatus::Closed, total};
+            }
+
+            auto wait = remaining_until(deadline);
+            if (!wait) {
+                co_return {SendStatus::Timeout, total};
+            }
+            auto pstatus = co_await poll(PollOp::Write, *wait);
+            if (pstatus == PollStatus::Timeout) {
+                co_return {SendStatus::Timeout, total};
+            }
+            hangup = pstatus != PollStatus::Event;
+        }
+        co_return {SendStatus::Ok, total};
+    }
+
+    auto Client::sendfile_from(int file_fd, off_t& offset, std::size_t count) -> std::pair<SendStatus, std::size_t> {
+        if (count == 0) {
+            return {SendStatus::Ok, 0};
+        }
+
+        // sendfile 没有 MSG_NOSIGNAL：调用期间屏蔽 SIGPIPE，对端已关闭时取走挂起的信号，不影响进程的信号处理
+        sigset_t pipe_set;
+        sigset_t old_set;
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+        auto sequence = m_registration ? m_registration->sequence(PollOp::Write) : 0;
+        auto bytes_sent = ::sendfile(m_socket.fd(), file_fd, &offset, count);
+        auto error = errno;
+        if (bytes_sent < 0 && error == EPIPE && !sigismember(&old_set, SIGPIPE)) {
+            timespec zero{};
+            sigtimedwait(&pipe_set, nullptr, &zero);
+        }
+        pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+
+        if (bytes_sent >= 0) {
+            return {SendStatus::Ok, static_cast<std::size_t>(bytes_sent)};
+        }
+        if (m_registration && would_block(error)) {
+            m_registration->clear_ready(PollOp::Write, sequence);
+        }
+        return {static_cast<SendStatus>(error), 0};
+    }
+
+    Task<std::pair<SendStatus, std::size_t>> Client::sendfile_all(int file_fd, off_t offset, std::size_t count,
+                                                                  std::chrono::milliseconds timeout) {
+        auto deadline = make_deadline(timeout);
+        std::size_t total{0};
+        bool hangup{false};
+
+        while (total < count) {
+            if (!m_registration || m_registration->ready(PollOp::Write)) {
+                auto [status, sent] = sendfile_from(file_fd, offset, count - total);
+                if (status == SendStatus::Ok) {
+                    if (sent == 0) {
+                        // 已经到达文件末尾，文件比预期的短
+                        co_return {SendStatus::Closed, total};
+                    }
+                    total += sent;
+                    hangup = false;
+                    continue;
+                }
+                if (!would_block(static_cast<long>(status))) {
+                    co_return {status, total};
+                }
+            }
+            if (hangup) {
+                co_return {SendStatus::Closed, total};
+            }
+
+            auto wait = remaining_until(deadline);
+            if (!wait) {
+                co_return {SendStatus::Timeout, total};
+            }
+            auto pstatus = co_await poll(PollOp::Write, *wait);
+            if (pstatus == PollStatus::Timeout) {
+                co_return {SendStatus::Timeout, total};
+            }
+            hangup = pstatus != PollStatus::Event;
+        }
+        co_return {SendStatus::Ok, total};
+    }
+
     Client::Client(std::shared_ptr<IoScheduler> scheduler, Socket socket, IpAddress remote_ip, uint16_t remote_port)
         : m_scheduler(std::move(scheduler)), m_socket(std::move(socket)),
           m_remote_endpoint{remote_ip, remote_port},
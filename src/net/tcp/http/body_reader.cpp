@@ -0,0 +1,233 @@
+#include "coro/net/tcp/http/body_reader.hpp"
+
+#include <algorithm>
+
+namespace coro::net::tcp::http {
+
+    namespace {
+        // chunk 扩展和 trailer 的总长度上限
+        constexpr std::size_t max_line_bytes = 8 * 1024;
+
+        int hex_value(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+    }
+
+    void BodyReader::start(std::string_view received, bool expect_continue) {
+        m_received = received;
+        m_input = received;
+        m_from_received = true;
+        m_expect_continue = expect_continue;
+        m_remaining = 0;
+        m_size_digits = 0;
+        m_line_bytes = 0;
+        m_bytes_read = 0;
+        m_error_status = 0;
+    }
+
+    void BodyReader::start_buffered(std::string_view body) {
+        start_content_length(body.size(), body, false);
+    }
+
+    void BodyReader::start_content_length(std::size_t length, std::string_view received, bool expect_continue) {
+        start(received, expect_continue);
+        m_remaining = length;
+        m_state = length > 0 ? State::Fixed : State::Done;
+    }
+
+    void BodyReader::start_chunked(std::string_view received, std::size_t max_body, bool expect_continue) {
+        start(received, expect_continue);
+        m_max_body = max_body;
+        m_state = State::ChunkSize;
+    }
+
+    std::size_t BodyReader::received_consumed() const noexcept {
+        return m_from_received ? static_cast<std::size_t>(m_input.data() - m_received.data()) : m_received.size();
+    }
+
+    Task<std::string_view> BodyReader::read() {
+        while (m_state != State::Done && m_state != State::Failed) {
+            if (m_input.empty() && !co_await fill()) {
+                co_return std::string_view{};
+            }
+            auto piece = m_state == State::Fixed ? take_fixed() : decode_chunked();
+            if (!piece.empty()) {
+                m_bytes_read += piece.size();
+                co_return piece;
+            }
+        }
+        co_return std::string_view{};
+    }
+
+    Task<bool> BodyReader::skip(std::size_t max_bytes) {
+        // 剩余的长度已知并且超过上限时不必再读
+        if (m_state == State::Fixed && m_remaining - std::min(m_remaining, m_input.size()) > max_bytes) {
+            co_return false;
+        }
+        std::size_t skipped{0};
+        while (m_state != State::Done && m_state != State::Failed) {
+            auto piece = co_await read();
+            skipped += piece.size();
+            if (skipped > max_bytes) {
+                co_return false;
+            }
+        }
+        co_return m_state == State::Done;
+    }
+
+    Task<bool> BodyReader::fill() {
+        if (m_expect_continue) {
+            m_expect_continue = false;
+            auto [status, sent] = co_await m_client.write_all(std::string_view{"HTTP/1.1 100 Continue\r\n\r\n"});
+            if (status != SendStatus::Ok) {
+                fail(0);
+                co_return false;
+            }
+        }
+        if (!m_buffer) {
+            m_buffer = std::make_unique<char[]>(m_buffer_size);
+        }
+        // 长度已知时不多读，之后的流水线请求留在 socket 中
+        auto size = m_state == State::Fixed ? std::min(m_buffer_size, m_remaining) : m_buffer_size;
+        auto [status, data] = co_await m_client.read_some(std::span<char>{m_buffer.get(), size});
+        if (status != RecvStatus::Ok) {
+            fail(0);
+            co_return false;
+        }
+        m_from_received = false;
+        m_input = {data.data(), data.size()};
+        co_return true;
+    }
+
+    std::string_view BodyReader::take_fixed() {
+        auto piece = m_input.substr(0, std::min(m_remaining, m_input.size()));
+        m_input.remove_prefix(piece.size());
+        m_remaining -= piece.size();
+        if (m_remaining == 0) {
+            m_state = State::Done;
+        }
+        return piece;
+    }
+
+    std::string_view BodyReader::decode_chunked() {
+        // 逐字节处理框架，数据部分整段返回；chunk 可以在任意位置被读取边界切开
+        while (!m_input.empty()) {
+            char c = m_input.front();
+            switch (m_state) {
+                case State::ChunkSize: {
+                    int digit = hex_value(c);
+                    if (digit >= 0) {
+                        if (m_remaining > (m_max_body >> 4)) {
+                            fail(413);
+                            return {};
+                        }
+                        m_remaining = m_remaining << 4 | static_cast<std::size_t>(digit);
+                        ++m_size_digits;
+                    } else if (m_size_digits == 0) {
+                        fail(400);
+                        return {};
+                    } else if (c == ';' || c == ' ' || c == '\t') {
+                        m_state = State::ChunkExtension;
+                    } else if (c == '\r') {
+                        m_state = State::ChunkSizeLf;
+                    } else {
+                        fail(400);
+                        return {};
+                    }
+                    break;
+                }
+                case State::ChunkExtension:
+                    // 扩展的内容忽略
+                    if (c == '\r') {
+                        m_state = State::ChunkSizeLf;
+                    } else if (c == '\n' || ++m_line_bytes > max_line_bytes) {
+                        fail(400);
+                        return {};
+                    }
+                    break;
+                case State::ChunkSizeLf:
+                    if (c != '\n') {
+                        fail(400);
+                        return {};
+                    }
+                    if (m_remaining == 0) {
+                        m_state = State::TrailerStart;
+                    } else if (m_bytes_read + m_remaining > m_max_body) {
+                        fail(413);
+                        return {};
+                    } else {
+                        m_state = State::ChunkData;
+                    }
+                    break;
+                case State::ChunkData: {
+                    auto piece = m_input.substr(0, std::min(m_remaining, m_input.size()));
+                    m_input.remove_prefix(piece.size());
+                    m_remaining -= piece.size();
+                    if (m_remaining == 0) {
+                        m_state = State::ChunkDataCr;
+                    }
+                    return piece;
+                }
+                case State::ChunkDataCr:
+                    if (c != '\r') {
+                        fail(400);
+                        return {};
+                    }
+                    m_state = State::ChunkDataLf;
+                    break;
+                case State::ChunkDataLf:
+                    if (c != '\n') {
+                        fail(400);
+                        return {};
+                    }
+                    m_state = State::ChunkSize;
+                    m_size_digits = 0;
+                    break;
+                case State::TrailerStart:
+                    // trailer 字段忽略，空行结束整个正文
+                    if (c == '\n') {
+                        fail(400);
+                        return {};
+                    }
+                    m_state = c == '\r' ? State::FinalLf : State::Trailer;
+                    break;
+                case State::Trailer:
+                    if (c == '\r') {
+                        m_state = State::TrailerLf;
+                    } else if (c == '\n' || ++m_line_bytes > max_line_bytes) {
+                        fail(400);
+                        return {};
+                    }
+                    break;
+                case State::TrailerLf:
+                    if (c != '\n') {
+                        fail(400);
+                        return {};
+                    }
+                    m_state = State::TrailerStart;
+                    break;
+                case State::FinalLf:
+                    if (c != '\n') {
+                        fail(400);
+                        return {};
+                    }
+                    m_input.remove_prefix(1);
+                    m_state = State::Done;
+                    return {};
+                default:
+                    return {};
+            }
+            m_input.remove_prefix(1);
+        }
+        return {};
+    }
+
+    void BodyReader::fail(int status) {
+        m_state = State::Failed;
+        m_error_status = status;
+    }
+
+} // namespace coro::net::tcp::http
@@ -1,105 +1,381 @@
 #include "coro/net/tcp/http/http_server.hpp"
+#include "coro/when_all.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
 
 namespace coro::net::tcp::http {
 
     HttpServer::HttpServer(std::shared_ptr<IoScheduler> scheduler, Server::LocalEndPoint local_end_point)
-        : m_scheduler(std::move(scheduler)), m_server(m_scheduler, local_end_point) {}
+        : m_group(std::move(scheduler), local_end_point) {}
+
+    HttpServer::HttpServer(ServerGroup::Options opts) : m_group(opts) {}
+
+    void HttpServer::route(Method method, std::string_view path, Handler handler) {
+        if (!handler) {
+            throw std::invalid_argument("HttpServer: empty handler for " + std::string{path});
+        }
+        m_router.add(method, path, static_cast<Router::value_type>(m_routes.size()));
+        m_routes.push_back({std::move(handler), nullptr});
+    }
+
+    void HttpServer::route(Method method, std::string_view path, Handler handler, ConcurrencyLimit limit) {
+        route(method, path, std::move(handler));
+        m_routes.back().limit = std::make_unique<Semaphore>(limit.max_concurrent);
+        m_routes.back().queue_timeout = limit.queue_timeout;
+    }
 
-    // 注册路由处理函数
     void HttpServer::Get(const std::string& path, Handler handler) {
-        m_routes["GET"][path] = handler;
+        route(Method::Get, path, std::move(handler));
+    }
+
+    void HttpServer::Get(const std::string& path, Handler handler, std::shared_ptr<ResponseCache> cache) {
+        // 包装之后不再为空，先检查
+        if (!handler) {
+            throw std::invalid_argument("HttpServer: empty handler for " + path);
+        }
+        route(Method::Get, path, ResponseCache::wrap(std::move(cache), std::move(handler)));
     }
 
     void HttpServer::Post(const std::string& path, Handler handler) {
-        m_routes["POST"][path] = handler;
+        route(Method::Post, path, std::move(handler));
+    }
+
+    void HttpServer::serve_static(std::string_view prefix, StaticFiles::Options opts) {
+        // 文件缓存由所有 reactor 共享
+        auto files = std::make_shared<StaticFiles>(std::move(opts));
+        while (prefix.ends_with('/')) {
+            prefix.remove_suffix(1);
+        }
+        route(Method::Get, std::string{prefix} + "/*path", [files](Request& req, Response& resp) {
+            files->serve(req.param("path").value_or(""), req, resp);
+        });
     }
 
     Task<> HttpServer::start() {
-        co_await m_server.poll();
+        // 之后路由表只读，各个 reactor 可以同时查找
+        m_router.freeze();
+        std::vector<Task<>> loops;
+        for (std::size_t i = 0; i < m_group.size(); ++i) {
+            loops.push_back(accept_loop(i));
+        }
+        co_await when_all(std::move(loops));
+    }
+
+    Task<> HttpServer::accept_loop(std::size_t reactor) {
+        auto& scheduler = m_group.scheduler(reactor);
+        auto& server = m_group.server(reactor);
+        co_await scheduler->schedule();
+
+        std::vector<Client> clients;
         while (true) {
-            auto pstatus = co_await m_server.poll();
+            auto pstatus = co_await server.poll();
             if (pstatus == PollStatus::Event) {
-                Client client = m_server.accept();
-                if (client.socket().is_valid()) {
-                    m_scheduler->spawn(handle_client(std::move(client)));
+                // 一次唤醒取走连接队列中的所有连接，连接留在接受它的 reactor 上
+                server.accept_batch(clients);
+                for (auto& client : clients) {
+                    scheduler->spawn(handle_client(std::move(client), reactor));
                 }
+                clients.clear();
+            } else if (pstatus != PollStatus::Timeout) {
+                co_return;
             }
         }
     }
 
-    Task<> HttpServer::handle_client(Client client) {
-        std::vector<char> buffer(4096);
-        while (true) {
-            co_await client.poll(PollOp::Read);
-            auto [rstatus, data] = client.recv(buffer);
-            if (rstatus != RecvStatus::Ok)
-                break;
-            std::string raw_request(data.data(), data.size());
-            Request req = Request::parse(raw_request);
-            Response resp;
-
-            auto method_handlers = m_routes.find(req.method);
-            if (method_handlers != m_routes.end()) {
-                auto handler = method_handlers->second.find(req.path);
-                if (handler != method_handlers->second.end()) {
-                    co_await handler->second(req, resp);
-                } else {
-                    resp.status_code = 404;
-                    resp.body = "Not Found";
+    namespace {
+        // 已经处理、还没有发送的响应：头部在连接的头部缓冲区中，正文留在 Response 里
+        struct PendingResponse {
+            size_t m_head_offset;
+            size_t m_head_size;
+            Response m_response;
+        };
+
+        /**
+         * 把积攒的响应用一次 writev 发出去，每个响应是头部和正文两段，正文不拷贝；失败时返回 false。
+         * 文件正文用 sendfile 发送，它之前的部分先用 writev 发出。
+         * 发送后清空 pending 和 head（保留容量），释放这批响应在 arena 中占用的内存，供下一批响应复用；
+         * 调用时除了 pending 中的（和已经被移走的）响应，不能有其他从 arena 分配过内存的 Response
+         */
+        Task<bool> flush_responses(Client& client, std::string& head, std::vector<PendingResponse>& pending,
+                                   std::vector<iovec>& iov, std::pmr::monotonic_buffer_resource& arena) {
+            if (pending.empty()) {
+                co_return true;
+            }
+            // 头部缓冲区在追加时可能搬移，发送前才生成 iovec
+            bool ok{true};
+            iov.clear();
+            for (auto& p : pending) {
+                iov.push_back({head.data() + p.m_head_offset, p.m_head_size});
+                if (!p.m_response.body.empty() && !p.m_response.file) {
+                    iov.push_back({p.m_response.body.data(), p.m_response.body.size()});
+                }
+                if (const auto& file = p.m_response.file; file && file->length > 0) {
+                    auto [status, sent] = co_await client.writev_all(iov);
+                    iov.clear();
+                    if (status != SendStatus::Ok) {
+                        ok = false;
+                        break;
+                    }
+                    auto [file_status, file_sent] = co_await client.sendfile_all(file->fd, file->offset, file->length);
+                    if (file_status != SendStatus::Ok) {
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+            if (ok && !iov.empty()) {
+                auto [status, sent] = co_await client.writev_all(iov);
+                ok = status == SendStatus::Ok;
+            }
+            pending.clear();
+            head.clear();
+            arena.release();
+            co_return ok;
+        }
+
+        // 处理一个请求期间持有的路由并发许可，请求处理完或者连接关闭时归还
+        class RoutePermit {
+        public:
+            RoutePermit() = default;
+            RoutePermit(const RoutePermit&) = delete;
+            RoutePermit& operator=(const RoutePermit&) = delete;
+            ~RoutePermit() {
+                if (m_semaphore != nullptr) {
+                    m_semaphore->release();
                 }
-            } else {
-                resp.status_code = 405;
-                resp.body = "Method Not Allowed";
             }
 
-            std::string response_str = resp.to_string();
-            co_await client.poll(PollOp::Write);
-            client.send(std::span<const char>{response_str.data(), response_str.size()});
+            void hold(Semaphore& semaphore) noexcept { m_semaphore = &semaphore; }
+
+        private:
+            Semaphore* m_semaphore{nullptr};
+        };
+
+        // with_body 为 false 时（HEAD 请求）头部照常写出正文的长度，但不发送正文
+        void queue_response(std::string& head, std::vector<PendingResponse>& pending, Response&& resp,
+                            bool chunked = true, bool with_body = true) {
+            auto offset = head.size();
+            resp.write_head(head, chunked);
+            if (!with_body) {
+                resp.body.clear();
+                resp.file.reset();
+                resp.stream = nullptr;
+            }
+            pending.push_back({offset, head.size() - offset, std::move(resp)});
+        }
+    }
+
+    void HttpServer::stop() {
+        for (std::size_t i = 0; i < m_group.size(); ++i) {
+            m_group.server(i).shutdown();
+        }
+    }
+
+    HttpServer::Route* HttpServer::find_route(Request& req, Response& resp) {
+        auto method = parse_method(req.method);
+        auto match = m_router.match(method, req.path, req.params);
+        if (match.status == Router::Status::MethodNotAllowed && method == Method::Head) {
+            // 没有单独注册 HEAD 路由时由 GET 路由处理，发送时去掉正文
+            match = m_router.match(Method::Get, req.path, req.params);
         }
+        if (match.status == Router::Status::NotFound) {
+            resp.status_code = 404;
+            resp.body = "Not Found";
+            return nullptr;
+        }
+        if (match.status == Router::Status::MethodNotAllowed) {
+            resp.status_code = 405;
+            resp.body = "Method Not Allowed";
+            return nullptr;
+        }
+        return &m_routes[match.value];
     }
 
-    Request Request::parse(const std::string& raw_request) {
+    Task<> HttpServer::handle_client(Client client, std::size_t reactor) {
+        constexpr size_t read_size = 4096;
+        // 积攒的响应超过这个大小时先发出去，限制流水线请求占用的内存
+        constexpr size_t max_pending_bytes = 64 * 1024;
+        // 处理函数没有读完的正文在这个大小以内时跳过，继续处理之后的请求，否则关闭连接
+        constexpr size_t max_skip_bytes = 256 * 1024;
+
+        auto& scheduler = *m_group.scheduler(reactor);
+        RequestParser parser;
         Request req;
-        std::istringstream iss(raw_request);
-        std::string line;
+        BodyReader body_reader{client};
+        // 连接的接收缓冲区，req 中的 string_view 都指向这里
+        std::string buffer;
+        size_t start{0};  // 当前请求在 buffer 中的起始位置
+        // 已经处理、还没有发送的响应，按请求的顺序排列；连接上所有响应的头部都写在 head 中
+        std::string head;
+        std::vector<PendingResponse> pending;
+        size_t pending_bytes{0};
+        std::vector<iovec> iov;
+        // 响应的头部表和正文从这里分配，每批响应发出之后整体释放；初始缓冲区放在协程帧中，
+        // 一批响应不超过它时处理请求不分配堆内存，超过时向全局 new 申请，同样在释放时归还
+        alignas(std::max_align_t) std::byte arena_buffer[16 * 1024];
+        std::pmr::monotonic_buffer_resource arena{arena_buffer, sizeof(arena_buffer)};
+
+        while (true) {
+            auto result = parser.parse(std::string_view{buffer}.substr(start), req);
+            if (result == RequestParser::Result::Incomplete) {
+                // 缓冲区中的完整请求都处理完了，响应合并成一次 writev，然后再读
+                if (!co_await flush_responses(client, head, pending, iov, arena)) {
+                    co_return;
+                }
+                pending_bytes = 0;
 
-        // 解析请求行
-        std::getline(iss, line);
-        std::istringstream line_stream(line);
-        line_stream >> req.method >> req.path;
+                // 已经处理完的请求从缓冲区中移除
+                if (start > 0) {
+                    buffer.erase(0, start);
+                    start = 0;
+                }
+                auto size = buffer.size();
+                buffer.resize(size + std::max(read_size, buffer.capacity() - size));
+                auto [rstatus, data] = co_await client.read_some(std::span<char>{buffer}.subspan(size));
+                buffer.resize(size + data.size());
+                if (rstatus != RecvStatus::Ok) {
+                    co_return;
+                }
+                continue;
+            }
 
-        // 解析头部
-        while (std::getline(iss, line) && line != "\r") {
-            size_t colon = line.find(':');
-            if (colon != std::string::npos) {
-                std::string key = line.substr(0, colon);
-                std::string value = line.substr(colon + 2, line.size() - colon - 3); // 去除\r和空格
-                req.headers[key] = value;
+            if (result == RequestParser::Result::Error) {
+                // 无法确定请求的边界，先发出之前的响应，再回复错误并关闭连接
+                Response resp{&arena};
+                resp.status_code = parser.error_status();
+                resp.headers["Connection"] = "close";
+                queue_response(head, pending, std::move(resp));
+                co_await flush_responses(client, head, pending, iov, arena);
+                co_return;
+            }
 
-                if (key == "Content-Length") {
-                    req.content_length = std::stoul(value);
+            if (parser.body_streamed()) {
+                // 处理函数读取正文时可能要先回复 100 Continue，之前的响应必须先发出去。
+                // 发送之后 arena 整体释放，这个请求的响应在这之后才构造
+                if (!co_await flush_responses(client, head, pending, iov, arena)) {
+                    co_return;
                 }
+                pending_bytes = 0;
             }
-        }
 
-        // 解析正文
-        size_t header_end = raw_request.find("\r\n\r\n");
-        if (header_end != std::string::npos) {
-            req.body = raw_request.substr(header_end + 4, req.content_length);
-        }
+            Response resp{&arena};
+            if (parser.body_streamed()) {
+                auto received = std::string_view{buffer}.substr(start + parser.consumed());
+                auto expect = req.header("Expect");
+                bool expect_continue = req.version == "HTTP/1.1" && expect && iequals(*expect, "100-continue");
+                if (parser.chunked()) {
+                    body_reader.start_chunked(received, parser.limits().max_body, expect_continue);
+                } else {
+                    body_reader.start_content_length(req.content_length, received, expect_continue);
+                }
+            } else {
+                body_reader.start_buffered(req.body);
+            }
+            req.body_reader = &body_reader;
 
-        return req;
-    }
+            RoutePermit permit;
+            if (auto* route = find_route(req, resp)) {
+                // 达到路由的并发上限时排队等待，不排队或者等待超时时拒绝
+                bool admitted = !route->limit || route->limit->try_acquire() ||
+                                (route->queue_timeout > std::chrono::milliseconds(0) &&
+                                 co_await route->limit->acquire_for(scheduler, route->queue_timeout));
+                if (!admitted) {
+                    resp.status_code = 503;
+                    resp.body = "Service Unavailable";
+                } else {
+                    if (route->limit) {
+                        permit.hold(*route->limit);
+                    }
+                    if (route->handler.is_sync()) {
+                        // 返回 void 的处理函数直接调用，不创建协程帧
+                        route->handler.call_sync(req, resp);
+                    } else {
+                        co_await route->handler(req, resp);
+                    }
+                }
+            }
+
+            // 跳过处理函数没有读完的正文，才能找到下一个请求的开头；正文已经读完时不必进入协程
+            bool body_complete = body_reader.done() || co_await body_reader.skip(max_skip_bytes);
+            if (body_reader.failed()) {
+                if (body_reader.error_status() == 0) {
+                    co_return;
+                }
+                // 正文的编码错误或者超长，处理函数的响应作废
+                resp = Response{&arena};
+                resp.status_code = body_reader.error_status();
+                resp.headers["Connection"] = "close";
+            } else if (!body_complete) {
+                resp.headers["Connection"] = "close";
+            }
+
+            // 处理函数可以通过 Connection: close 要求关闭连接
+            bool keep_alive = req.keep_alive();
+            if (auto connection = resp.headers.find("Connection"); connection != resp.headers.end()) {
+                keep_alive = keep_alive && !iequals(connection->second, "close");
+            } else if (!keep_alive) {
+                resp.headers["Connection"] = "close";
+            } else if (req.version == "HTTP/1.0") {
+                resp.headers["Connection"] = "keep-alive";
+            }
+
+            // HEAD 的响应没有正文，流式正文也不调用
+            bool with_body = parse_method(req.method) != Method::Head;
+            if (resp.stream && resp.allows_body() && with_body) {
+                // HTTP/1.0 不支持 chunked，流式正文只能由关闭连接结束
+                bool chunked = req.version != "HTTP/1.0";
+                if (!chunked) {
+                    keep_alive = false;
+                    resp.headers["Connection"] = "close";
+                }
+                resp.body.clear();
+                resp.file.reset();
+                // 先发出之前积攒的响应和这个响应的头部，再由处理函数逐段发送正文，发送期间 req 仍然有效
+                queue_response(head, pending, std::move(resp), chunked);
+                auto stream = std::move(pending.back().m_response.stream);
+                if (!co_await flush_responses(client, head, pending, iov, arena)) {
+                    co_return;
+                }
+                pending_bytes = 0;
+                ResponseWriter writer{client, chunked};
+                co_await stream(writer);
+                if (!co_await writer.finish()) {
+                    co_return;
+                }
+            } else {
+                bool chunked = req.version != "HTTP/1.0";
+                if (with_body) {
+                    resp.stream = nullptr;
+                }
+                queue_response(head, pending, std::move(resp), chunked, with_body);
+                pending_bytes += pending.back().m_head_size + pending.back().m_response.body.size();
+            }
+            start += parser.consumed();
+            if (parser.body_streamed()) {
+                // 正文从 socket 读取时，连接缓冲区中的数据已经用完，读取器多读到的是之后的请求
+                start += body_reader.received_consumed();
+                if (auto leftover = body_reader.leftover(); !leftover.empty()) {
+                    buffer.erase(0, start);
+                    start = 0;
+                    buffer.append(leftover);
+                }
+            }
+            parser.reset();
 
-    // Response生成实现
-    std::string Response::to_string() const {
-        std::ostringstream oss;
-        oss << "HTTP/1.1 " << status_code << " OK\r\n";
-        for (const auto& [key, value] : headers) {
-            oss << key << ": " << value << "\r\n";
+            if (!keep_alive) {
+                // 之后的流水线请求不再处理
+                co_await flush_responses(client, head, pending, iov, arena);
+                co_return;
+            }
+            if (pending_bytes >= max_pending_bytes) {
+                if (!co_await flush_responses(client, head, pending, iov, arena)) {
+                    co_return;
+                }
+                pending_bytes = 0;
+            }
         }
-        oss << "Content-Length: " << body.size() << "\r\n";
-        oss << "\r\n" << body;
-        return oss.str();
     }
 }
\ No newline at end of file
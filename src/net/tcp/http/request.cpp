@@ -0,0 +1,99 @@
+#include "coro/net/tcp/http/request.hpp"
+
+namespace coro::net::tcp::http {
+
+    bool iequals(std::string_view lhs, std::string_view rhs) noexcept {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            auto a = static_cast<unsigned char>(lhs[i]);
+            auto b = static_cast<unsigned char>(rhs[i]);
+            // 只对字母折叠大小写
+            if (a != b && ((a | 0x20) != (b | 0x20) || (a | 0x20) < 'a' || (a | 0x20) > 'z')) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Method parse_method(std::string_view method) noexcept {
+        // 方法名区分大小写（RFC 9110 9.1）
+        switch (method.size()) {
+            case 3:
+                if (method == "GET") return Method::Get;
+                if (method == "PUT") return Method::Put;
+                break;
+            case 4:
+                if (method == "POST") return Method::Post;
+                if (method == "HEAD") return Method::Head;
+                break;
+            case 5:
+                if (method == "PATCH") return Method::Patch;
+                if (method == "TRACE") return Method::Trace;
+                break;
+            case 6:
+                if (method == "DELETE") return Method::Delete;
+                break;
+            case 7:
+                if (method == "OPTIONS") return Method::Options;
+                if (method == "CONNECT") return Method::Connect;
+                break;
+            default:
+                break;
+        }
+        return Method::Unknown;
+    }
+
+    std::optional<std::string_view> Request::header(std::string_view name) const {
+        for (const auto& h : headers) {
+            if (iequals(h.name, name)) {
+                return h.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool Request::keep_alive() const {
+        bool keep = version == "HTTP/1.1";
+        for (const auto& h : headers) {
+            if (!iequals(h.name, "Connection")) {
+                continue;
+            }
+            // Connection 的值是逗号分隔的选项列表
+            auto value = h.value;
+            while (!value.empty()) {
+                auto comma = value.find(',');
+                auto option = value.substr(0, comma);
+                while (!option.empty() && (option.front() == ' ' || option.front() == '\t')) {
+                    option.remove_prefix(1);
+                }
+                while (!option.empty() && (option.back() == ' ' || option.back() == '\t')) {
+                    option.remove_suffix(1);
+                }
+                if (iequals(option, "close")) {
+                    return false;
+                }
+                if (iequals(option, "keep-alive")) {
+                    keep = true;
+                }
+                value = comma == std::string_view::npos ? std::string_view{} : value.substr(comma + 1);
+            }
+        }
+        return keep;
+    }
+
+    void Request::clear() {
+        method = {};
+        target = {};
+        path = {};
+        query = {};
+        version = {};
+        headers.clear();
+        body = {};
+        content_length = 0;
+        params.clear();
+        body_reader = nullptr;
+    }
+
+} // namespace coro::net::tcp::http
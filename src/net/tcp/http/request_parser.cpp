@@ -0,0 +1,230 @@
+#include "coro/net/tcp/http/request_parser.hpp"
+
+#include "coro/net/tcp/http/scan.hpp"
+
+namespace coro::net::tcp::http {
+
+    namespace {
+        bool is_ows(char c) { return c == ' ' || c == '\t'; }
+    }
+
+    RequestParser::Result RequestParser::parse(std::string_view data, Request& request) {
+        while (true) {
+            switch (m_state) {
+                case State::RequestLine:
+                case State::Headers: {
+                    // 一次扫描同时找到行尾并检查控制字符：行内只允许 HTAB，第一个控制字符必须是 CRLF 的 CR
+                    auto cr = m_scan + detail::find_control(data.substr(m_scan));
+                    auto line_limit = m_state == State::RequestLine ? m_limits.max_request_line
+                                                                     : m_limits.max_header_bytes;
+                    if (cr + 1 >= data.size()) {
+                        if (cr < data.size() && data[cr] != '\r') {
+                            return fail(400);
+                        }
+                        // 行尾还没有收全，下次从 CR（或者数据末尾）继续扫描
+                        m_scan = std::min(cr, data.size());
+                        if (m_state == State::RequestLine && data.size() - m_line_start > line_limit) {
+                            return fail(414);
+                        }
+                        if (data.size() > m_limits.max_header_bytes) {
+                            return fail(431);
+                        }
+                        return Result::Incomplete;
+                    }
+                    auto end = cr + 1;
+                    if (m_state == State::RequestLine && end - m_line_start > line_limit) {
+                        return fail(414);
+                    }
+                    if (end + 1 > m_limits.max_header_bytes) {
+                        return fail(431);
+                    }
+                    // 只接受 CRLF 结尾的行，裸 LF 和其他控制字符都是错误
+                    if (data[cr] != '\r' || data[end] != '\n') {
+                        return fail(400);
+                    }
+
+                    auto line_end = cr;
+                    if (m_state == State::RequestLine) {
+                        // 请求行之前的空行忽略（RFC 9112 2.2）
+                        if (line_end != m_line_start) {
+                            if (!parse_request_line(data, line_end)) {
+                                return Result::Error;
+                            }
+                            m_state = State::Headers;
+                        }
+                    } else if (line_end == m_line_start) {
+                        m_header_end = end + 1;
+                        if (!finish_headers(data)) {
+                            return Result::Error;
+                        }
+                        m_state = State::Body;
+                    } else if (!parse_header_line(data, line_end)) {
+                        return Result::Error;
+                    }
+                    m_line_start = m_scan = end + 1;
+                    break;
+                }
+                case State::Body:
+                    if (!m_body_streamed && data.size() - m_header_end < m_content_length) {
+                        return Result::Incomplete;
+                    }
+                    m_state = State::Done;
+                    break;
+                case State::Done:
+                    fill(data, request);
+                    return Result::Complete;
+                case State::Error:
+                    return Result::Error;
+            }
+        }
+    }
+
+    void RequestParser::reset() {
+        m_state = State::RequestLine;
+        m_line_start = 0;
+        m_scan = 0;
+        m_header_end = 0;
+        m_method = {};
+        m_target = {};
+        m_version = {};
+        m_headers.clear();
+        m_content_length = 0;
+        m_has_content_length = false;
+        m_chunked = false;
+        m_body_streamed = false;
+        m_error_status = 0;
+    }
+
+    bool RequestParser::parse_request_line(std::string_view data, std::size_t end) {
+        // method SP request-target SP HTTP-version，控制字符已经在查找行尾时排除
+        auto line = data.substr(m_line_start, end - m_line_start);
+        auto first = detail::find_non_token(line);
+        auto second = first < line.size() ? line.find(' ', first + 1) : std::string_view::npos;
+        if (first == 0 || second == std::string_view::npos || line[first] != ' ') {
+            fail(400);
+            return false;
+        }
+
+        auto method = line.substr(0, first);
+        auto target = line.substr(first + 1, second - first - 1);
+        auto version = line.substr(second + 1);
+        if (target.empty() || target.find('\t') != std::string_view::npos) {
+            fail(400);
+            return false;
+        }
+        if (version != "HTTP/1.1" && version != "HTTP/1.0") {
+            fail(version.starts_with("HTTP/") ? 505 : 400);
+            return false;
+        }
+
+        auto base = static_cast<std::uint32_t>(m_line_start);
+        m_method = {base, static_cast<std::uint32_t>(method.size())};
+        m_target = {static_cast<std::uint32_t>(base + first + 1), static_cast<std::uint32_t>(target.size())};
+        m_version = {static_cast<std::uint32_t>(base + second + 1), static_cast<std::uint32_t>(version.size())};
+        return true;
+    }
+
+    bool RequestParser::parse_header_line(std::string_view data, std::size_t end) {
+        if (m_headers.size() >= m_limits.max_headers) {
+            fail(431);
+            return false;
+        }
+
+        auto line = data.substr(m_line_start, end - m_line_start);
+        // 名字之后必须紧跟冒号：名字和冒号之间的空白、以空白开头的续行（obs-fold）都不接受
+        auto colon = detail::find_non_token(line);
+        if (colon == 0 || colon == line.size() || line[colon] != ':') {
+            fail(400);
+            return false;
+        }
+
+        auto value_begin = colon + 1;
+        auto value_end = line.size();
+        while (value_begin < value_end && is_ows(line[value_begin])) {
+            ++value_begin;
+        }
+        while (value_end > value_begin && is_ows(line[value_end - 1])) {
+            --value_end;
+        }
+        auto value = line.substr(value_begin, value_end - value_begin);
+
+        auto base = static_cast<std::uint32_t>(m_line_start);
+        m_headers.push_back({{base, static_cast<std::uint32_t>(colon)},
+                             {static_cast<std::uint32_t>(base + value_begin), static_cast<std::uint32_t>(value.size())}});
+        return true;
+    }
+
+    bool RequestParser::finish_headers(std::string_view data) {
+        for (const auto& h : m_headers) {
+            auto name = h.name.view(data);
+            if (iequals(name, "Content-Length")) {
+                auto value = h.value.view(data);
+                std::size_t length{0};
+                if (value.empty()) {
+                    fail(400);
+                    return false;
+                }
+                for (char c : value) {
+                    if (c < '0' || c > '9') {
+                        fail(400);
+                        return false;
+                    }
+                    length = length * 10 + static_cast<std::size_t>(c - '0');
+                    if (length > m_limits.max_body) {
+                        fail(413);
+                        return false;
+                    }
+                }
+                // 重复的 Content-Length 必须一致，否则无法确定请求的边界
+                if (m_has_content_length && length != m_content_length) {
+                    fail(400);
+                    return false;
+                }
+                m_content_length = length;
+                m_has_content_length = true;
+            } else if (iequals(name, "Transfer-Encoding")) {
+                // 只支持单独的 chunked，其他编码无法解码
+                if (m_chunked || !iequals(h.value.view(data), "chunked")) {
+                    fail(501);
+                    return false;
+                }
+                m_chunked = true;
+            }
+        }
+        // 两者同时出现时请求的边界有歧义（请求走私），拒绝（RFC 9112 6.3）
+        if (m_chunked && m_has_content_length) {
+            fail(400);
+            return false;
+        }
+        m_body_streamed = m_chunked || m_content_length > m_limits.max_buffered_body;
+        return true;
+    }
+
+    void RequestParser::fill(std::string_view data, Request& request) const {
+        request.clear();
+        request.method = m_method.view(data);
+        request.target = m_target.view(data);
+        request.version = m_version.view(data);
+
+        auto question = request.target.find('?');
+        request.path = request.target.substr(0, question);
+        if (question != std::string_view::npos) {
+            request.query = request.target.substr(question + 1);
+        }
+
+        for (const auto& h : m_headers) {
+            request.headers.push_back({h.name.view(data), h.value.view(data)});
+        }
+        request.content_length = m_content_length;
+        if (!m_body_streamed) {
+            request.body = data.substr(m_header_end, m_content_length);
+        }
+    }
+
+    RequestParser::Result RequestParser::fail(int status) {
+        m_state = State::Error;
+        m_error_status = status;
+        return Result::Error;
+    }
+
+} // namespace coro::net::tcp::http
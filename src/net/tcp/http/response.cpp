@@ -0,0 +1,145 @@
+#include "coro/net/tcp/http/response.hpp"
+
+#include "coro/net/tcp/http/request.hpp"
+
+#include <array>
+#include <charconv>
+#include <ctime>
+
+namespace coro::net::tcp::http {
+
+    namespace {
+        constexpr int min_status = 100;
+        constexpr int max_status = 599;
+
+        constexpr std::array<std::string_view, max_status - min_status + 1> make_reason_table() {
+            std::array<std::string_view, max_status - min_status + 1> table{};
+            auto set = [&](int code, std::string_view reason) { table[code - min_status] = reason; };
+            set(100, "Continue");
+            set(101, "Switching Protocols");
+            set(200, "OK");
+            set(201, "Created");
+            set(202, "Accepted");
+            set(203, "Non-Authoritative Information");
+            set(204, "No Content");
+            set(205, "Reset Content");
+            set(206, "Partial Content");
+            set(300, "Multiple Choices");
+            set(301, "Moved Permanently");
+            set(302, "Found");
+            set(303, "See Other");
+            set(304, "Not Modified");
+            set(307, "Temporary Redirect");
+            set(308, "Permanent Redirect");
+            set(400, "Bad Request");
+            set(401, "Unauthorized");
+            set(402, "Payment Required");
+            set(403, "Forbidden");
+            set(404, "Not Found");
+            set(405, "Method Not Allowed");
+            set(406, "Not Acceptable");
+            set(407, "Proxy Authentication Required");
+            set(408, "Request Timeout");
+            set(409, "Conflict");
+            set(410, "Gone");
+            set(411, "Length Required");
+            set(412, "Precondition Failed");
+            set(413, "Content Too Large");
+            set(414, "URI Too Long");
+            set(415, "Unsupported Media Type");
+            set(416, "Range Not Satisfiable");
+            set(417, "Expectation Failed");
+            set(421, "Misdirected Request");
+            set(422, "Unprocessable Content");
+            set(426, "Upgrade Required");
+            set(428, "Precondition Required");
+            set(429, "Too Many Requests");
+            set(431, "Request Header Fields Too Large");
+            set(500, "Internal Server Error");
+            set(501, "Not Implemented");
+            set(502, "Bad Gateway");
+            set(503, "Service Unavailable");
+            set(504, "Gateway Timeout");
+            set(505, "HTTP Version Not Supported");
+            return table;
+        }
+        constexpr auto reason_table = make_reason_table();
+
+        void append_number(std::string& out, std::size_t value) {
+            char digits[20];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, end);
+        }
+
+        // 每个线程（每个 reactor）缓存一份，秒数变化时才重新格式化
+        struct DateCache {
+            std::time_t m_second{-1};
+            char m_buffer[32]{};
+            std::size_t m_size{0};
+        };
+        thread_local DateCache t_date_cache;
+    }
+
+    std::string_view reason_phrase(int status_code) noexcept {
+        if (status_code < min_status || status_code > max_status) {
+            return {};
+        }
+        return reason_table[status_code - min_status];
+    }
+
+    std::string_view http_date() noexcept {
+        auto& cache = t_date_cache;
+        auto now = std::time(nullptr);
+        if (now != cache.m_second) {
+            std::tm tm{};
+            gmtime_r(&now, &tm);
+            cache.m_size = std::strftime(cache.m_buffer, sizeof(cache.m_buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+            cache.m_second = now;
+        }
+        return {cache.m_buffer, cache.m_size};
+    }
+
+    void Response::write_head(std::string& out, bool chunked) const {
+        // 状态码固定 3 位
+        char code[3] = {static_cast<char>('0' + status_code / 100 % 10), static_cast<char>('0' + status_code / 10 % 10),
+                        static_cast<char>('0' + status_code % 10)};
+        out.append("HTTP/1.1 ");
+        out.append(code, sizeof(code));
+        out.push_back(' ');
+        out.append(reason_phrase(status_code));
+        out.append("\r\n");
+
+        bool has_date{false};
+        for (const auto& [key, value] : headers) {
+            has_date = has_date || iequals(key, "Date");
+            out.append(key);
+            out.append(": ");
+            out.append(value);
+            out.append("\r\n");
+        }
+        if (!has_date) {
+            out.append("Date: ");
+            out.append(http_date());
+            out.append("\r\n");
+        }
+        bool has_body = allows_body();
+        if (has_body && stream) {
+            if (chunked) {
+                out.append("Transfer-Encoding: chunked\r\n");
+            }
+        } else if (has_body) {
+            out.append("Content-Length: ");
+            append_number(out, content_length());
+            out.append("\r\n");
+        }
+        out.append("\r\n");
+    }
+
+    std::string Response::to_string() const {
+        std::string out;
+        write_head(out);
+        out.append(body);
+        return out;
+    }
+
+} // namespace coro::net::tcp::http
@@ -0,0 +1,71 @@
+#include "coro/net/tcp/http/response_cache.hpp"
+
+namespace coro::net::tcp::http {
+
+    ResponseCache::ResponseCache(std::shared_ptr<IoScheduler> scheduler, Options opts)
+        : m_vary_headers(std::move(opts.vary_headers)),
+          m_cache(std::move(scheduler), Cache::Options{opts.capacity, opts.shards, opts.ttl}) {}
+
+    Handler ResponseCache::wrap(std::shared_ptr<ResponseCache> cache, Handler handler) {
+        return [cache = std::move(cache), handler = std::move(handler)](Request& req, Response& resp) mutable {
+            return cache->serve(req, resp, handler);
+        };
+    }
+
+    Task<> ResponseCache::serve(Request& req, Response& resp, Handler& handler) {
+        bool called{false};
+        auto entry = co_await m_cache.get_or_load_if(make_key(req),
+                                                     [&] { return load(req, resp, handler, called); });
+        if (called) {
+            // 这个请求执行了处理函数，响应已经填写好
+            co_return;
+        }
+        if (!entry) {
+            // 合并到的那次响应不能缓存，自己处理
+            co_await handler(req, resp);
+            co_return;
+        }
+        const auto& cached = **entry;
+        resp.status_code = cached.status_code;
+        for (const auto& [name, value] : cached.headers) {
+            resp.headers[std::pmr::string{name, resp.headers.get_allocator()}] = value;
+        }
+        resp.headers["X-Cache"] = "HIT";
+        resp.body.assign(cached.body);
+    }
+
+    std::string ResponseCache::make_key(const Request& req) const {
+        // 头部的值中不会有 '\0'，用它分隔；没有的头部和空值区分开
+        std::string key{req.target};
+        for (const auto& name : m_vary_headers) {
+            key.push_back('\0');
+            if (auto value = req.header(name)) {
+                key.push_back('1');
+                key.append(*value);
+            } else {
+                key.push_back('0');
+            }
+        }
+        return key;
+    }
+
+    Task<std::optional<std::shared_ptr<const ResponseCache::Entry>>> ResponseCache::load(Request& req, Response& resp,
+                                                                                         Handler& handler,
+                                                                                         bool& called) {
+        called = true;
+        co_await handler(req, resp);
+        if (resp.status_code != 200 || resp.file || resp.stream) {
+            co_return std::nullopt;
+        }
+        auto entry = std::make_shared<Entry>();
+        entry->status_code = resp.status_code;
+        for (const auto& [name, value] : resp.headers) {
+            if (!iequals(name, "Date")) {
+                entry->headers.emplace_back(name, value);
+            }
+        }
+        entry->body.assign(resp.body);
+        co_return std::shared_ptr<const Entry>{std::move(entry)};
+    }
+
+} // namespace coro::net::tcp::http
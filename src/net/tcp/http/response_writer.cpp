@@ -0,0 +1,47 @@
+#include "coro/net/tcp/http/response_writer.hpp"
+
+#include <charconv>
+
+namespace coro::net::tcp::http {
+
+    Task<bool> ResponseWriter::write(std::string_view data) {
+        // 空的 chunk 表示正文结束，不能发送
+        if (!m_ok || m_finished || data.empty()) {
+            co_return m_ok && !m_finished;
+        }
+
+        if (!m_chunked) {
+            auto [status, sent] = co_await m_client.write_all(data);
+            m_ok = status == SendStatus::Ok;
+        } else {
+            // 长度行、数据、CRLF 用一次 writev 发送，数据不拷贝
+            char size_line[20];
+            auto [end, ec] = std::to_chars(size_line, size_line + sizeof(size_line) - 2, data.size(), 16);
+            *end++ = '\r';
+            *end++ = '\n';
+            char crlf[2] = {'\r', '\n'};
+            iovec iov[3] = {{size_line, static_cast<std::size_t>(end - size_line)},
+                            {const_cast<char*>(data.data()), data.size()},
+                            {crlf, sizeof(crlf)}};
+            auto [status, sent] = co_await m_client.writev_all(iov);
+            m_ok = status == SendStatus::Ok;
+        }
+        if (m_ok) {
+            m_bytes_written += data.size();
+        }
+        co_return m_ok;
+    }
+
+    Task<bool> ResponseWriter::finish() {
+        if (!m_ok || m_finished) {
+            co_return m_ok;
+        }
+        m_finished = true;
+        if (m_chunked) {
+            auto [status, sent] = co_await m_client.write_all(std::string_view{"0\r\n\r\n"});
+            m_ok = status == SendStatus::Ok;
+        }
+        co_return m_ok;
+    }
+
+} // namespace coro::net::tcp::http
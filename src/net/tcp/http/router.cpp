@@ -0,0 +1,258 @@
+#include "coro/net/tcp/http/router.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace coro::net::tcp::http {
+
+    // 构建阶段的树，freeze 时压平成 Router::Node 数组
+    struct Router::BuildNode {
+        std::string prefix;  // 静态前缀，参数和通配节点为空
+        std::vector<std::unique_ptr<BuildNode>> children;  // 静态子节点，按前缀的第一个字节排序
+        std::unique_ptr<BuildNode> param_child;
+        std::unique_ptr<BuildNode> wildcard_child;
+        std::string name;  // 参数和通配节点的名字
+        std::array<value_type, method_count> values;
+        bool has_values{false};
+
+        BuildNode() { values.fill(npos); }
+    };
+
+    Router::Router() : m_build_root(std::make_unique<BuildNode>()) {}
+    Router::~Router() = default;
+    Router::Router(Router&&) noexcept = default;
+    Router& Router::operator=(Router&&) noexcept = default;
+
+    namespace {
+        [[noreturn]] void bad_route(std::string_view pattern, const char* reason) {
+            throw std::runtime_error("Router: " + std::string{pattern} + ": " + reason);
+        }
+
+        // 下一个参数或通配段的位置（段首的 ':' 或 '*'），没有时返回 s.size()
+        std::size_t find_capture(std::string_view s) noexcept {
+            for (std::size_t i = 1; i < s.size(); ++i) {
+                if ((s[i] == ':' || s[i] == '*') && s[i - 1] == '/') {
+                    return i;
+                }
+            }
+            return s.size();
+        }
+    }
+
+    void Router::add(Method method, std::string_view pattern, value_type value) {
+        if (frozen()) {
+            bad_route(pattern, "add after freeze");
+        }
+        if (method == Method::Unknown) {
+            bad_route(pattern, "unknown method");
+        }
+        if (value == npos) {
+            bad_route(pattern, "value out of range");
+        }
+        if (pattern.empty() || pattern.front() != '/') {
+            bad_route(pattern, "pattern must start with '/'");
+        }
+
+        BuildNode* node = m_build_root.get();
+        std::size_t param_count = 0;
+        std::string_view rest = pattern;
+        while (!rest.empty()) {
+            // rest 总是以 '/' 开头，':' 和 '*' 只在段首有特殊含义
+            auto text = rest.substr(0, find_capture(rest));
+            rest.remove_prefix(text.size());
+
+            // 静态部分插入基数树，需要时拆分已有节点的前缀
+            while (!text.empty()) {
+                auto& children = node->children;
+                auto it = std::lower_bound(children.begin(), children.end(), text.front(),
+                                           [](const auto& child, char c) { return child->prefix.front() < c; });
+                if (it == children.end() || (*it)->prefix.front() != text.front()) {
+                    auto child = std::make_unique<BuildNode>();
+                    child->prefix = std::string{text};
+                    node = children.insert(it, std::move(child))->get();
+                    break;
+                }
+                auto& child = *it;
+                std::size_t common = 0;
+                while (common < child->prefix.size() && common < text.size() && child->prefix[common] == text[common]) {
+                    ++common;
+                }
+                if (common < child->prefix.size()) {
+                    auto split = std::make_unique<BuildNode>();
+                    split->prefix = child->prefix.substr(0, common);
+                    child->prefix.erase(0, common);
+                    split->children.push_back(std::move(child));
+                    child = std::move(split);
+                }
+                node = child.get();
+                text.remove_prefix(common);
+            }
+            if (rest.empty()) {
+                break;
+            }
+
+            char kind = rest.front();
+            auto name_end = std::min(rest.find('/'), rest.size());
+            auto name = rest.substr(1, name_end - 1);
+            if (name.empty()) {
+                bad_route(pattern, "empty parameter name");
+            }
+            if (++param_count > PathParams::capacity) {
+                bad_route(pattern, "too many parameters");
+            }
+            auto& child = kind == ':' ? node->param_child : node->wildcard_child;
+            if (kind == '*' && name_end != rest.size()) {
+                bad_route(pattern, "wildcard must be the last segment");
+            }
+            if (!child) {
+                child = std::make_unique<BuildNode>();
+                child->name = std::string{name};
+            } else if (child->name != name) {
+                // 同一位置的参数在不同路由中必须同名，否则匹配结果有歧义
+                bad_route(pattern, "conflicting parameter name");
+            }
+            node = child.get();
+            rest.remove_prefix(name_end);
+        }
+
+        auto& slot = node->values[static_cast<std::size_t>(method)];
+        if (slot != npos) {
+            bad_route(pattern, "duplicate route");
+        }
+        slot = value;
+        node->has_values = true;
+        ++m_route_count;
+    }
+
+    void Router::freeze() {
+        if (frozen()) {
+            return;
+        }
+        // 按层次顺序压平，每个节点的静态子节点连续存放，匹配时只需要扫描一小段首字节数组
+        m_nodes.clear();
+        m_first_bytes.clear();
+        m_values.clear();
+        m_strings.clear();
+
+        auto intern = [this](const std::string& s) {
+            auto offset = static_cast<std::uint32_t>(m_strings.size());
+            m_strings += s;
+            return std::pair{offset, static_cast<std::uint32_t>(s.size())};
+        };
+
+        std::deque<std::pair<const BuildNode*, std::uint32_t>> queue;
+        m_nodes.emplace_back();
+        m_first_bytes.push_back('\0');
+        queue.emplace_back(m_build_root.get(), 0);
+        while (!queue.empty()) {
+            auto [build, index] = queue.front();
+            queue.pop_front();
+
+            Node node;
+            std::tie(node.m_prefix_offset, node.m_prefix_size) = intern(build->prefix);
+            std::tie(node.m_name_offset, node.m_name_size) = intern(build->name);
+            if (build->has_values) {
+                node.m_values = static_cast<std::uint32_t>(m_values.size());
+                m_values.insert(m_values.end(), build->values.begin(), build->values.end());
+            }
+
+            auto append = [&](const BuildNode* child) {
+                auto child_index = static_cast<std::uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+                m_first_bytes.push_back(child->prefix.empty() ? '\0' : child->prefix.front());
+                queue.emplace_back(child, child_index);
+                return child_index;
+            };
+            node.m_children_begin = static_cast<std::uint32_t>(m_nodes.size());
+            node.m_children_count = static_cast<std::uint32_t>(build->children.size());
+            for (const auto& child : build->children) {
+                append(child.get());
+            }
+            if (build->param_child) {
+                node.m_param_child = append(build->param_child.get());
+            }
+            if (build->wildcard_child) {
+                node.m_wildcard_child = append(build->wildcard_child.get());
+            }
+            m_nodes[index] = node;
+        }
+
+        m_nodes.shrink_to_fit();
+        m_first_bytes.shrink_to_fit();
+        m_values.shrink_to_fit();
+        m_strings.shrink_to_fit();
+        m_build_root.reset();
+    }
+
+    bool Router::take_value(const Node& node, MatchState& state) const noexcept {
+        if (node.m_values == npos) {
+            return false;
+        }
+        auto value = m_values[node.m_values + static_cast<std::size_t>(state.method)];
+        if (value == npos) {
+            state.path_matched = true;
+            return false;
+        }
+        state.value = value;
+        return true;
+    }
+
+    bool Router::match_node(std::uint32_t index, std::string_view rest, MatchState& state) const {
+        const auto& node = m_nodes[index];
+        if (rest.empty() && take_value(node, state)) {
+            return true;
+        }
+
+        // 静态子节点优先
+        if (!rest.empty()) {
+            auto begin = m_first_bytes.data() + node.m_children_begin;
+            auto end = begin + node.m_children_count;
+            auto it = std::find(begin, end, rest.front());
+            if (it != end) {
+                auto child_index = static_cast<std::uint32_t>(it - m_first_bytes.data());
+                const auto& child = m_nodes[child_index];
+                auto prefix = string_at(child.m_prefix_offset, child.m_prefix_size);
+                if (rest.starts_with(prefix) && match_node(child_index, rest.substr(prefix.size()), state)) {
+                    return true;
+                }
+            }
+        }
+
+        // 参数匹配到下一个 '/' 为止，不能为空
+        if (node.m_param_child != npos && !rest.empty() && rest.front() != '/') {
+            auto end = std::min(rest.find('/'), rest.size());
+            const auto& child = m_nodes[node.m_param_child];
+            state.params.push(string_at(child.m_name_offset, child.m_name_size), rest.substr(0, end));
+            if (match_node(node.m_param_child, rest.substr(end), state)) {
+                return true;
+            }
+            state.params.pop();
+        }
+
+        // 通配匹配剩余的全部路径，可以为空
+        if (node.m_wildcard_child != npos) {
+            const auto& child = m_nodes[node.m_wildcard_child];
+            if (take_value(child, state)) {
+                state.params.push(string_at(child.m_name_offset, child.m_name_size), rest);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Router::Match Router::match(Method method, std::string_view path, PathParams& params) const {
+        if (!frozen() || m_nodes.empty()) {
+            return {Status::NotFound, 0};
+        }
+        MatchState state{method, params, 0, false};
+        if (match_node(0, path, state)) {
+            return {Status::Found, state.value};
+        }
+        // 失败的分支已经弹出了自己的参数，params 保持不变
+        return {state.path_matched ? Status::MethodNotAllowed : Status::NotFound, 0};
+    }
+
+} // namespace coro::net::tcp::http
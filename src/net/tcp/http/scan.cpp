@@ -0,0 +1,227 @@
+#include "coro/net/tcp/http/scan.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CORO_HTTP_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace coro::net::tcp::http::detail {
+
+    namespace {
+        constexpr std::array<bool, 256> make_token_table() {
+            std::array<bool, 256> table{};
+            for (int c = '0'; c <= '9'; ++c) table[c] = true;
+            for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+            for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+            for (char c : std::string_view{"!#$%&'*+-.^_`|~"}) table[static_cast<unsigned char>(c)] = true;
+            return table;
+        }
+        constexpr auto token_table = make_token_table();
+
+        constexpr bool is_control(unsigned char c) { return (c < 0x20 && c != '\t') || c == 0x7f; }
+
+        std::size_t find_control_scalar(const char* data, std::size_t size) noexcept {
+            for (std::size_t i = 0; i < size; ++i) {
+                if (is_control(static_cast<unsigned char>(data[i]))) {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        std::size_t find_non_token_scalar(const char* data, std::size_t size) noexcept {
+            for (std::size_t i = 0; i < size; ++i) {
+                if (!token_table[static_cast<unsigned char>(data[i])]) {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+#ifdef CORO_HTTP_SCAN_X86
+        // pcmpestri 的范围比较：[0x00, 0x08] [0x0a, 0x1f] [0x7f, 0x7f]
+        alignas(16) constexpr char control_ranges[16] = {0x00, 0x08, 0x0a, 0x1f, 0x7f, 0x7f};
+        constexpr int control_ranges_size = 6;
+
+        // tchar 最多只能放 8 个范围，'~' 放不下，由循环单独放过
+        alignas(16) constexpr char token_ranges[16] = {'!', '!', '#', '\'', '*', '+', '-', '.',
+                                                       '0', '9', 'A', 'Z', '^', 'z', '|', '|'};
+
+        __attribute__((target("sse4.2")))
+        std::size_t find_control_sse42(const char* data, std::size_t size) noexcept {
+            auto ranges = _mm_load_si128(reinterpret_cast<const __m128i*>(control_ranges));
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                int index = _mm_cmpestri(ranges, control_ranges_size, v, 16,
+                                         _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+                if (index != 16) {
+                    return i + index;
+                }
+            }
+            return i + find_control_scalar(data + i, size - i);
+        }
+
+        __attribute__((target("sse4.2")))
+        std::size_t find_non_token_sse42(const char* data, std::size_t size) noexcept {
+            auto ranges = _mm_load_si128(reinterpret_cast<const __m128i*>(token_ranges));
+            std::size_t i = 0;
+            while (i + 16 <= size) {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                int index = _mm_cmpestri(ranges, 16, v, 16,
+                                         _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY |
+                                             _SIDD_LEAST_SIGNIFICANT);
+                if (index == 16) {
+                    i += 16;
+                } else if (data[i + index] == '~') {
+                    i += index + 1;
+                } else {
+                    return i + index;
+                }
+            }
+            return i + find_non_token_scalar(data + i, size - i);
+        }
+
+        // tchar 的 pshufb 查找表：低 4 位查出允许的高 4 位集合，高 4 位查出对应的位，两者相与非 0 即为 tchar
+        constexpr std::array<std::uint8_t, 32> make_token_lo_table() {
+            std::array<std::uint8_t, 32> table{};
+            for (int lo = 0; lo < 16; ++lo) {
+                std::uint8_t bits = 0;
+                for (int hi = 0; hi < 8; ++hi) {
+                    if (token_table[hi << 4 | lo]) {
+                        bits |= static_cast<std::uint8_t>(1u << hi);
+                    }
+                }
+                // 两个 128 位通道各一份
+                table[lo] = table[lo + 16] = bits;
+            }
+            return table;
+        }
+        constexpr std::array<std::uint8_t, 32> make_token_hi_table() {
+            std::array<std::uint8_t, 32> table{};
+            for (int hi = 0; hi < 8; ++hi) {
+                table[hi] = table[hi + 16] = static_cast<std::uint8_t>(1u << hi);
+            }
+            return table;
+        }
+        alignas(32) constexpr auto token_lo_table = make_token_lo_table();
+        alignas(32) constexpr auto token_hi_table = make_token_hi_table();
+
+        __attribute__((target("avx2")))
+        std::size_t find_control_avx2(const char* data, std::size_t size) noexcept {
+            const auto max_control = _mm256_set1_epi8(0x1f);
+            const auto tab = _mm256_set1_epi8('\t');
+            const auto del = _mm256_set1_epi8(0x7f);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                // 无符号比较 v <= 0x1f
+                auto low = _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_control), v);
+                auto control = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(v, tab), low),
+                                               _mm256_cmpeq_epi8(v, del));
+                auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(control));
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(__builtin_ctz(mask));
+                }
+            }
+            return i + find_control_sse42(data + i, size - i);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t find_non_token_avx2(const char* data, std::size_t size) noexcept {
+            const auto lo_table = _mm256_load_si256(reinterpret_cast<const __m256i*>(token_lo_table.data()));
+            const auto hi_table = _mm256_load_si256(reinterpret_cast<const __m256i*>(token_hi_table.data()));
+            const auto nibble = _mm256_set1_epi8(0x0f);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                auto lo = _mm256_and_si256(v, nibble);
+                auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+                // 高 4 位 >= 8（非 ASCII）时查出 0，不是 tchar
+                auto bits = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo), _mm256_shuffle_epi8(hi_table, hi));
+                auto invalid = _mm256_cmpeq_epi8(bits, _mm256_setzero_si256());
+                auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(invalid));
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(__builtin_ctz(mask));
+                }
+            }
+            return i + find_non_token_sse42(data + i, size - i);
+        }
+#endif
+
+        struct Kernels {
+            ScanLevel level;
+            std::size_t (*find_control)(const char*, std::size_t) noexcept;
+            std::size_t (*find_non_token)(const char*, std::size_t) noexcept;
+        };
+
+        constexpr Kernels scalar_kernels{ScanLevel::Scalar, find_control_scalar, find_non_token_scalar};
+#ifdef CORO_HTTP_SCAN_X86
+        constexpr Kernels sse42_kernels{ScanLevel::Sse42, find_control_sse42, find_non_token_sse42};
+        constexpr Kernels avx2_kernels{ScanLevel::Avx2, find_control_avx2, find_non_token_avx2};
+#endif
+
+        ScanLevel best_level() noexcept {
+#ifdef CORO_HTTP_SCAN_X86
+            // 静态初始化阶段调用 __builtin_cpu_supports 之前需要先初始化
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return ScanLevel::Avx2;
+            }
+            if (__builtin_cpu_supports("sse4.2")) {
+                return ScanLevel::Sse42;
+            }
+#endif
+            return ScanLevel::Scalar;
+        }
+
+        const Kernels* kernels_for(ScanLevel level) noexcept {
+            level = std::min(level, best_level());
+#ifdef CORO_HTTP_SCAN_X86
+            if (level == ScanLevel::Avx2) {
+                return &avx2_kernels;
+            }
+            if (level == ScanLevel::Sse42) {
+                return &sse42_kernels;
+            }
+#endif
+            return &scalar_kernels;
+        }
+
+        std::atomic<const Kernels*> g_kernels{kernels_for(ScanLevel::Avx2)};
+    }
+
+    std::size_t find_control(const char* data, std::size_t size) noexcept {
+        return g_kernels.load(std::memory_order_relaxed)->find_control(data, size);
+    }
+
+    std::size_t find_non_token(const char* data, std::size_t size) noexcept {
+        return g_kernels.load(std::memory_order_relaxed)->find_non_token(data, size);
+    }
+
+    ScanLevel scan_level() noexcept { return g_kernels.load(std::memory_order_relaxed)->level; }
+
+    ScanLevel set_scan_level(ScanLevel level) noexcept {
+        auto* kernels = kernels_for(level);
+        g_kernels.store(kernels, std::memory_order_relaxed);
+        return kernels->level;
+    }
+
+    const char* to_string(ScanLevel level) noexcept {
+        switch (level) {
+            case ScanLevel::Avx2:
+                return "avx2";
+            case ScanLevel::Sse42:
+                return "sse4.2";
+            case ScanLevel::Scalar:
+            default:
+                return "scalar";
+        }
+    }
+
+} // namespace coro::net::tcp::http::detail
@@ -0,0 +1,433 @@
+#include "coro/net/tcp/http/static_files.hpp"
+
+#include <fcntl.h>
+#include <linux/openat2.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <optional>
+#include <system_error>
+
+namespace coro::net::tcp::http {
+
+    namespace {
+        constexpr std::uint32_t watch_mask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO |
+                                             IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF;
+
+        struct MimeType {
+            std::string_view extension;
+            std::string_view type;
+        };
+
+        constexpr std::array<MimeType, 20> mime_types{{
+            {"html", "text/html; charset=utf-8"},
+            {"htm", "text/html; charset=utf-8"},
+            {"css", "text/css; charset=utf-8"},
+            {"js", "text/javascript; charset=utf-8"},
+            {"mjs", "text/javascript; charset=utf-8"},
+            {"json", "application/json"},
+            {"map", "application/json"},
+            {"txt", "text/plain; charset=utf-8"},
+            {"xml", "application/xml"},
+            {"svg", "image/svg+xml"},
+            {"png", "image/png"},
+            {"jpg", "image/jpeg"},
+            {"jpeg", "image/jpeg"},
+            {"gif", "image/gif"},
+            {"webp", "image/webp"},
+            {"ico", "image/x-icon"},
+            {"wasm", "application/wasm"},
+            {"woff", "font/woff"},
+            {"woff2", "font/woff2"},
+            {"pdf", "application/pdf"},
+        }};
+
+        std::string_view content_type_for(std::string_view path) {
+            auto slash = path.rfind('/');
+            auto dot = path.rfind('.');
+            if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+                return "application/octet-stream";
+            }
+            auto extension = path.substr(dot + 1);
+            for (const auto& mime : mime_types) {
+                if (iequals(mime.extension, extension)) {
+                    return mime.type;
+                }
+            }
+            return "application/octet-stream";
+        }
+
+        int hex_value(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        // 解码 URL 路径，去掉开头的 '/'，拒绝 NUL 和 ".." 段；符号链接由 open_beneath 限制在根目录下
+        std::optional<std::string> decode_path(std::string_view path) {
+            std::string out;
+            out.reserve(path.size());
+            for (std::size_t i = 0; i < path.size(); ++i) {
+                char c = path[i];
+                if (c == '%') {
+                    int hi = i + 2 < path.size() ? hex_value(path[i + 1]) : -1;
+                    int lo = hi >= 0 ? hex_value(path[i + 2]) : -1;
+                    if (lo < 0) {
+                        return std::nullopt;
+                    }
+                    c = static_cast<char>(hi << 4 | lo);
+                    i += 2;
+                }
+                if (c == '\0') {
+                    return std::nullopt;
+                }
+                out.push_back(c);
+            }
+
+            auto begin = out.find_first_not_of('/');
+            out.erase(0, std::min(begin, out.size()));
+            std::string_view rest{out};
+            while (!rest.empty()) {
+                auto slash = std::min(rest.find('/'), rest.size());
+                if (rest.substr(0, slash) == "..") {
+                    return std::nullopt;
+                }
+                rest.remove_prefix(std::min(slash + 1, rest.size()));
+            }
+            return out;
+        }
+
+        /**
+         * 打开 root_fd 下的 path，解析结果不能离开根目录：openat2 的 RESOLVE_BENEATH 拒绝绝对路径和指向外面的符号链接。
+         * 内核不支持 openat2（5.6 之前）时逐段用 O_NOFOLLOW 打开，路径中有任何符号链接都拒绝
+         */
+        int open_beneath(int root_fd, const std::string& path) {
+            constexpr int flags = O_RDONLY | O_CLOEXEC | O_NOCTTY;
+            open_how how{};
+            how.flags = flags;
+            how.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+            int fd = static_cast<int>(::syscall(__NR_openat2, root_fd, path.c_str(), &how, sizeof(how)));
+            if (fd >= 0 || errno != ENOSYS) {
+                return fd;
+            }
+
+            int dir = root_fd;
+            std::string_view rest{path};
+            std::string component;
+            while (true) {
+                auto slash = rest.find('/');
+                component.assign(rest.substr(0, slash));
+                if (slash == std::string_view::npos) {
+                    fd = ::openat(dir, component.c_str(), flags | O_NOFOLLOW);
+                    break;
+                }
+                rest.remove_prefix(slash + 1);
+                if (component.empty() || component == ".") {
+                    continue;
+                }
+                // O_PATH 加 O_NOFOLLOW 打开符号链接本身，O_DIRECTORY 使它失败
+                int next = ::openat(dir, component.c_str(), O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+                if (dir != root_fd) {
+                    ::close(dir);
+                }
+                if (next < 0) {
+                    return -1;
+                }
+                dir = next;
+            }
+            if (dir != root_fd) {
+                auto error = errno;
+                ::close(dir);
+                errno = error;
+            }
+            return fd;
+        }
+
+        void append_hex(std::string& out, unsigned long long value) {
+            char buffer[16];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+            out.append(buffer, end);
+        }
+
+        // 比较时忽略弱标记 "W/"（RFC 9110 8.8.3.2 的弱比较）
+        std::string_view opaque_tag(std::string_view tag) {
+            return tag.starts_with("W/") ? tag.substr(2) : tag;
+        }
+
+        // If-None-Match 是否与 etag 匹配："*" 或者逗号分隔的列表中的任意一个
+        bool none_match(std::string_view header, std::string_view etag) {
+            while (!header.empty()) {
+                auto comma = std::min(header.find(','), header.size());
+                auto tag = header.substr(0, comma);
+                while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) tag.remove_prefix(1);
+                while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) tag.remove_suffix(1);
+                if (tag == "*" || opaque_tag(tag) == opaque_tag(etag)) {
+                    return true;
+                }
+                header.remove_prefix(std::min(comma + 1, header.size()));
+            }
+            return false;
+        }
+
+        std::optional<std::size_t> parse_number(std::string_view s) {
+            std::size_t value{0};
+            auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+            if (ec != std::errc{} || end != s.data() + s.size() || s.empty()) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        struct ByteRange {
+            std::size_t first;
+            std::size_t length;
+        };
+
+        enum class RangeResult {
+            Ignore,           // 没有 Range、格式不支持或者有多个范围：发送完整的文件
+            Partial,          // 206
+            Unsatisfiable,    // 416
+        };
+
+        // 只支持单个范围 "bytes=a-b"、"bytes=a-"、"bytes=-n"
+        RangeResult parse_range(std::string_view header, std::size_t size, ByteRange& range) {
+            if (!header.starts_with("bytes=") || header.find(',') != std::string_view::npos) {
+                return RangeResult::Ignore;
+            }
+            header.remove_prefix(6);
+            auto dash = header.find('-');
+            if (dash == std::string_view::npos) {
+                return RangeResult::Ignore;
+            }
+            auto first = header.substr(0, dash);
+            auto last = header.substr(dash + 1);
+            if (first.empty()) {
+                auto suffix = parse_number(last);
+                if (!suffix) {
+                    return RangeResult::Ignore;
+                }
+                if (*suffix == 0 || size == 0) {
+                    return RangeResult::Unsatisfiable;
+                }
+                auto length = std::min(*suffix, size);
+                range = {size - length, length};
+                return RangeResult::Partial;
+            }
+            auto begin = parse_number(first);
+            auto end = last.empty() ? std::optional<std::size_t>{size - 1} : parse_number(last);
+            if (!begin || !end || (!last.empty() && *end < *begin)) {
+                return RangeResult::Ignore;
+            }
+            if (*begin >= size) {
+                return RangeResult::Unsatisfiable;
+            }
+            range = {*begin, std::min(*end, size - 1) - *begin + 1};
+            return RangeResult::Partial;
+        }
+    }
+
+    StaticFiles::OpenFile::~OpenFile() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    StaticFiles::StaticFiles(Options opts) : m_opts(std::move(opts)) {
+        m_root_fd = ::open(m_opts.root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (m_root_fd < 0) {
+            throw std::system_error(errno, std::system_category(), "StaticFiles: cannot open " + m_opts.root);
+        }
+        // 没有 inotify 时不缓存，每个请求都重新打开文件
+        m_inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    StaticFiles::~StaticFiles() {
+        if (m_inotify_fd >= 0) {
+            ::close(m_inotify_fd);
+        }
+        ::close(m_root_fd);
+    }
+
+    std::size_t StaticFiles::cached() const {
+        std::lock_guard lock{m_mutex};
+        return m_entries.size();
+    }
+
+    std::shared_ptr<const StaticFiles::OpenFile> StaticFiles::open(const std::string& path) {
+        int fd = open_beneath(m_root_fd, path);
+        if (fd < 0) {
+            return nullptr;
+        }
+        auto file = std::make_shared<OpenFile>();
+        file->fd = fd;
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            return nullptr;
+        }
+        file->size = static_cast<std::size_t>(st.st_size);
+        // 大小和纳秒精度的修改时间足以区分同一路径上的不同版本
+        file->etag.push_back('"');
+        append_hex(file->etag, static_cast<unsigned long long>(st.st_size));
+        file->etag.push_back('-');
+        append_hex(file->etag, static_cast<unsigned long long>(st.st_mtim.tv_sec) * 1'000'000'000ull +
+                                   static_cast<unsigned long long>(st.st_mtim.tv_nsec));
+        file->etag.push_back('"');
+        file->content_type = content_type_for(path);
+        auto slash = path.rfind('/');
+        file->dir = slash == std::string::npos ? std::string{} : path.substr(0, slash);
+        return file;
+    }
+
+    std::shared_ptr<const StaticFiles::OpenFile> StaticFiles::lookup(const std::string& path) {
+        if (m_inotify_fd < 0 || m_opts.max_open_files == 0) {
+            return open(path);
+        }
+
+        std::lock_guard lock{m_mutex};
+        drain_events();
+        if (auto it = m_entries.find(path); it != m_entries.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return it->second.file;
+        }
+
+        // 先监视目录再打开文件，打开之后的修改一定会产生事件
+        auto slash = path.rfind('/');
+        auto dir = slash == std::string::npos ? std::string{} : path.substr(0, slash);
+        if (!watch(dir)) {
+            // 收不到失效通知的文件不缓存
+            return open(path);
+        }
+        auto file = open(path);
+        if (!file) {
+            unwatch(dir);
+            return nullptr;
+        }
+        if (m_entries.size() >= m_opts.max_open_files) {
+            erase(m_entries.find(m_lru.back()));
+        }
+        m_lru.push_front(path);
+        m_entries.emplace(path, Entry{file, m_lru.begin()});
+        return file;
+    }
+
+    bool StaticFiles::watch(const std::string& dir) {
+        if (auto it = m_watches.find(dir); it != m_watches.end()) {
+            ++it->second.files;
+            return true;
+        }
+        auto full = dir.empty() ? m_opts.root : m_opts.root + "/" + dir;
+        int wd = ::inotify_add_watch(m_inotify_fd, full.c_str(), watch_mask);
+        if (wd < 0) {
+            return false;
+        }
+        m_watch_dirs[wd] = dir;
+        m_watches.emplace(dir, Watch{wd, 1});
+        return true;
+    }
+
+    void StaticFiles::unwatch(const std::string& dir) {
+        auto it = m_watches.find(dir);
+        if (it == m_watches.end() || --it->second.files > 0) {
+            return;
+        }
+        ::inotify_rm_watch(m_inotify_fd, it->second.wd);
+        m_watch_dirs.erase(it->second.wd);
+        m_watches.erase(it);
+    }
+
+    void StaticFiles::erase(std::unordered_map<std::string, Entry>::iterator it) {
+        auto dir = it->second.file->dir;
+        m_lru.erase(it->second.lru);
+        m_entries.erase(it);
+        unwatch(dir);
+    }
+
+    void StaticFiles::drain_events() {
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            auto size = ::read(m_inotify_fd, buffer, sizeof(buffer));
+            if (size <= 0) {
+                return;
+            }
+            for (char* p = buffer; p < buffer + size;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                auto dir = m_watch_dirs.find(event->wd);
+                // 目录本身被移动或删除、子目录改名、事件队列溢出时无法确定受影响的文件，清空缓存
+                bool all = (event->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF)) ||
+                           ((event->mask & IN_ISDIR) && (event->mask & (IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE)));
+                if (all) {
+                    while (!m_entries.empty()) {
+                        erase(m_entries.begin());
+                    }
+                    continue;
+                }
+                if (dir == m_watch_dirs.end() || event->len == 0) {
+                    continue;
+                }
+                std::string_view name{event->name};
+                auto key = dir->second.empty() ? std::string{name} : dir->second + "/" + std::string{name};
+                if (auto it = m_entries.find(key); it != m_entries.end()) {
+                    erase(it);
+                }
+            }
+        }
+    }
+
+    void StaticFiles::serve(std::string_view path, const Request& req, Response& resp) {
+        auto decoded = decode_path(path);
+        if (!decoded) {
+            resp.status_code = 404;
+            resp.body = "Not Found";
+            return;
+        }
+        if (decoded->empty() || decoded->back() == '/') {
+            decoded->append(m_opts.index_file);
+        }
+        auto file = lookup(*decoded);
+        if (!file) {
+            resp.status_code = 404;
+            resp.body = "Not Found";
+            return;
+        }
+
+        resp.headers["ETag"] = file->etag;
+        resp.headers["Accept-Ranges"] = "bytes";
+        if (auto tags = req.header("If-None-Match"); tags && none_match(*tags, file->etag)) {
+            resp.status_code = 304;
+            return;
+        }
+        resp.headers["Content-Type"] = std::string{file->content_type};
+
+        ByteRange range{0, file->size};
+        auto range_result = RangeResult::Ignore;
+        if (auto header = req.header("Range")) {
+            // If-Range 与当前版本不一致时忽略 Range，发送完整的新版本
+            auto if_range = req.header("If-Range");
+            if (!if_range || *if_range == file->etag) {
+                range_result = parse_range(*header, file->size, range);
+            }
+        }
+        if (range_result == RangeResult::Unsatisfiable) {
+            resp.status_code = 416;
+            resp.headers["Content-Range"] = "bytes */" + std::to_string(file->size);
+            return;
+        }
+        if (range_result == RangeResult::Partial) {
+            resp.status_code = 206;
+            resp.headers["Content-Range"] = "bytes " + std::to_string(range.first) + "-" +
+                                            std::to_string(range.first + range.length - 1) + "/" +
+                                            std::to_string(file->size);
+        }
+        resp.file = FileBody{file, file->fd, static_cast<off_t>(range.first), range.length};
+    }
+
+} // namespace coro::net::tcp::http
@@ -9,14 +9,25 @@ namespace coro::net::tcp {
         if (m_scheduler == nullptr) {
             throw std::runtime_error{"Server's IoScheduler cannot be nullptr"};
         }
+        if (m_local_end_point.port == 0) {
+            // 端口由内核分配，读回实际绑定的端口
+            sockaddr_in addr{};
+            socklen_t len = sizeof(addr);
+            if (::getsockname(m_accept_socket.fd(), reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+                throw std::runtime_error{"Failed to getsockname."};
+            }
+            m_local_end_point.port = ntohs(addr.sin_port);
+        }
     }
 
     Server::Server(Server&& other) noexcept
         : m_scheduler(std::move(other.m_scheduler)),
-          m_local_end_point(std::move(other.m_local_end_point)), m_accept_socket(std::move(other.m_accept_socket)) {}
+          m_local_end_point(std::move(other.m_local_end_point)), m_accept_socket(std::move(other.m_accept_socket)),
+          m_registration(std::move(other.m_registration)) {}
 
     Server& Server::operator=(Server&& other) noexcept {
         if (std::addressof(other) != this) {
+            m_registration = std::move(other.m_registration);
             m_scheduler = std::move(other.m_scheduler);
             m_local_end_point = std::move(other.m_local_end_point);
             m_accept_socket = std::move(other.m_accept_socket);
@@ -24,20 +35,74 @@ namespace coro::net::tcp {
         return *this;
     }
 
+    void Server::register_socket() {
+        if (m_registration == nullptr) {
+            m_registration = m_scheduler->register_fd(m_accept_socket.fd());
+        }
+    }
+
     Task<PollStatus> Server::poll(std::chrono::milliseconds timeout) {
+        if (m_registration) {
+            return m_scheduler->poll(*m_registration, PollOp::Read, timeout);
+        }
         return m_scheduler->poll(m_accept_socket, PollOp::Read, timeout);
     }
 
     Client Server::accept() {
         // 记录客户端的信息
         sockaddr_in clientaddr{};
-        int len = sizeof(clientaddr);
-        // 和客户端通信的Socket
-        Socket s {::accept(m_accept_socket.fd(), (struct sockaddr*)&clientaddr, (socklen_t*)&len)};
+        auto s = accept_socket(clientaddr);
+        return make_client(std::move(s), clientaddr);
+    }
 
-        std::span<uint8_t> ip_addr_view = { reinterpret_cast<uint8_t*>(&clientaddr.sin_addr.s_addr), sizeof(clientaddr.sin_addr.s_addr) };
+    std::size_t Server::accept_batch(std::vector<Client>& clients, std::size_t max_count) {
+        std::size_t count{0};
+        while (count < max_count) {
+            sockaddr_in clientaddr{};
+            auto s = accept_socket(clientaddr);
+            if (!s.is_valid()) {
+                // 对端在 accept 之前已经断开，继续取下一个
+                if (errno == ECONNABORTED || errno == EINTR) {
+                    continue;
+                }
+                // EAGAIN 表示队列已经取空；EMFILE 等错误留给下一次唤醒
+                break;
+            }
+            clients.push_back(make_client(std::move(s), clientaddr));
+            ++count;
+        }
+        return count;
+    }
 
-        return Client{m_scheduler, std::move(s), IpAddress{ip_addr_view}, clientaddr.sin_port };
+    void Server::shutdown() {
+        ::shutdown(m_accept_socket.fd(), SHUT_RDWR);
+    }
+
+    Socket Server::accept_socket(sockaddr_in& clientaddr) {
+        socklen_t len = sizeof(clientaddr);
+        auto sequence = m_registration ? m_registration->sequence(PollOp::Read) : 0;
+        // 和客户端通信的 Socket 总是非阻塞的，否则缓存的就绪状态过期或者 poll 误报时 recv 会阻塞工作线程
+        Socket s {::accept4(m_accept_socket.fd(), reinterpret_cast<sockaddr*>(&clientaddr), &len,
+                            SOCK_NONBLOCK | SOCK_CLOEXEC)};
+        auto error = errno;
+        if (!s.is_valid() && m_registration && (error == EAGAIN || error == EWOULDBLOCK)) {
+            // 连接队列已经取空，等待下一个边沿事件
+            m_registration->clear_ready(PollOp::Read, sequence);
+        }
+        // 调用方根据 errno 判断失败原因
+        errno = error;
+        return s;
+    }
+
+    Client Server::make_client(Socket socket, const sockaddr_in& clientaddr) {
+        std::span<const uint8_t> ip_addr_view = {reinterpret_cast<const uint8_t*>(&clientaddr.sin_addr.s_addr),
+                                                 sizeof(clientaddr.sin_addr.s_addr)};
+
+        Client client{m_scheduler, std::move(socket), IpAddress{ip_addr_view}, clientaddr.sin_port};
+        if (m_registration && client.socket().is_valid()) {
+            client.register_socket();
+        }
+        return client;
     }
 
-}
\ No newline at end of file
+}
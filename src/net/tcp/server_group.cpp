@@ -0,0 +1,57 @@
+#include "coro/net/tcp/server_group.hpp"
+
+#include <linux/filter.h>
+
+#include <cstring>
+#include <iostream>
+
+namespace coro::net::tcp {
+
+    ServerGroup::ServerGroup(std::shared_ptr<IoScheduler> scheduler, Server::LocalEndPoint local_end_point,
+                             uint32_t backlog) {
+        m_reactors.push_back(Reactor{scheduler, Server{scheduler, local_end_point, backlog}});
+        m_reactors.back().m_server.register_socket();
+    }
+
+    ServerGroup::ServerGroup(Options opts) {
+        if (opts.reactors == 0) {
+            throw std::runtime_error{"ServerGroup needs at least one reactor"};
+        }
+
+        m_reactors.reserve(opts.reactors);
+        for (std::size_t i = 0; i < opts.reactors; ++i) {
+            // 连接在接受它的 IO 线程上内联执行，不再经过线程池
+            auto scheduler = IoScheduler::make_shared(IoScheduler::Options{
+                .execution_strategy = IoScheduler::ExecutionStrategy::On_ThreadInline,
+                .threads_count = 1,
+                .backend = opts.backend,
+                .io_thread_cpu = opts.pin_cpus ? static_cast<int>(i) : -1,
+            });
+            m_reactors.push_back(Reactor{scheduler, Server{scheduler, opts.local_end_point, opts.backlog}});
+            m_reactors.back().m_server.register_socket();
+            // port 为 0 时之后的 reactor 绑定第一个 reactor 分到的端口
+            opts.local_end_point.port = m_reactors.front().m_server.local_end_point().port;
+        }
+
+        if (opts.steer_by_cpu && m_reactors.size() > 1) {
+            attach_cpu_steering();
+        }
+    }
+
+    void ServerGroup::attach_cpu_steering() {
+        // A = 处理这个 SYN 的 CPU；返回值是 reuseport 组内的 socket 下标（按 bind 的顺序），即 reactor 下标
+        sock_filter code[] = {
+            {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+            {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(m_reactors.size())},
+            {BPF_RET | BPF_A, 0, 0, 0},
+        };
+        sock_fprog program{.len = static_cast<unsigned short>(std::size(code)), .filter = code};
+
+        // 程序属于整个 reuseport 组，附加到任意一个 socket 即可
+        auto fd = m_reactors.front().m_server.m_accept_socket.fd();
+        if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) < 0) {
+            std::cerr << "ServerGroup failed to attach reuseport cpu steering: " << std::strerror(errno) << "\n";
+        }
+    }
+
+} // namespace coro::net::tcp
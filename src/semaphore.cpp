@@ -0,0 +1,152 @@
+#include "coro/semaphore.hpp"
+#include "coro/io_scheduler.hpp"
+#include "coro/thread_pool.hpp"
+
+namespace coro {
+
+    bool Semaphore::AcquireAwaiter::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept {
+        m_handle = awaiting_coroutine;
+        std::scoped_lock lk{m_semaphore.m_mutex};
+        return !m_semaphore.acquire_or_enqueue_locked(*this);
+    }
+
+    Task<bool> Semaphore::acquire_for(IoScheduler& scheduler, std::chrono::milliseconds timeout) {
+        if (try_acquire()) {
+            co_return true;
+        }
+        if (timeout <= std::chrono::milliseconds(0)) {
+            co_return false;
+        }
+
+        detail::PollInfo timer{};
+        Waiter waiter{};
+        waiter.m_scheduler = &scheduler;
+        waiter.m_timer = &timer;
+        {
+            std::scoped_lock lk{m_mutex};
+            if (acquire_or_enqueue_locked(waiter)) {
+                co_return true;
+            }
+        }
+
+        if (co_await scheduler.wait_notified(timer, timeout) == PollStatus::Event) {
+            co_return true;
+        }
+        // 超时。release 可能已经把它移出队列但没能通知到，这时许可已经交给了下一个等待者
+        std::scoped_lock lk{m_mutex};
+        if (waiter.m_linked) {
+            unlink_locked(waiter);
+            if (m_head == nullptr) {
+                m_state.store(0, std::memory_order_release);
+            }
+        }
+        co_return false;
+    }
+
+    void Semaphore::release(std::size_t n) {
+        if (n == 0) {
+            return;
+        }
+        auto state = m_state.load(std::memory_order_relaxed);
+        while ((state & waiters_bit) == 0) {
+            if (m_state.compare_exchange_weak(state, state + n, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        // 有等待者：按顺序交给它们，解锁之后再恢复
+        Waiter* ready_head{nullptr};
+        Waiter* ready_tail{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            while (n > 0 && m_head != nullptr) {
+                auto* waiter = m_head;
+                unlink_locked(*waiter);
+                if (waiter->m_timer != nullptr) {
+                    // 超时的等待者在移除自己之前要先拿到 m_mutex，所以这里访问它是安全的；
+                    // 通知失败说明它已经超时，许可交给下一个
+                    if (waiter->m_scheduler->notify_waiter(*waiter->m_timer)) {
+                        --n;
+                    }
+                    continue;
+                }
+                if (ready_tail != nullptr) {
+                    ready_tail->m_next = waiter;
+                } else {
+                    ready_head = waiter;
+                }
+                ready_tail = waiter;
+                --n;
+            }
+            if (m_head == nullptr) {
+                // 设置了等待者标志的状态只在这里修改；拿到锁之前标志可能已经被超时的等待者清除，
+                // 这时状态可以被无锁的 acquire / release 修改，只能累加
+                if (m_state.load(std::memory_order_relaxed) & waiters_bit) {
+                    m_state.store(n, std::memory_order_release);
+                } else if (n > 0) {
+                    m_state.fetch_add(n, std::memory_order_release);
+                }
+            }
+        }
+
+        while (ready_head != nullptr) {
+            auto* waiter = ready_head;
+            ready_head = waiter->m_next;
+            resume(waiter->m_handle);
+        }
+    }
+
+    bool Semaphore::acquire_or_enqueue_locked(Waiter& waiter) noexcept {
+        auto state = m_state.load(std::memory_order_relaxed);
+        while ((state & waiters_bit) == 0) {
+            // 没有许可时设置等待者标志，之后的 acquire 和 release 都要经过 m_mutex
+            auto desired = state > 0 ? state - 1 : waiters_bit;
+            if (m_state.compare_exchange_weak(state, desired, std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                if (state > 0) {
+                    return true;
+                }
+                break;
+            }
+        }
+
+        waiter.m_prev = m_tail;
+        waiter.m_next = nullptr;
+        if (m_tail != nullptr) {
+            m_tail->m_next = &waiter;
+        } else {
+            m_head = &waiter;
+        }
+        m_tail = &waiter;
+        waiter.m_linked = true;
+        return false;
+    }
+
+    void Semaphore::unlink_locked(Waiter& waiter) noexcept {
+        if (waiter.m_prev != nullptr) {
+            waiter.m_prev->m_next = waiter.m_next;
+        } else {
+            m_head = waiter.m_next;
+        }
+        if (waiter.m_next != nullptr) {
+            waiter.m_next->m_prev = waiter.m_prev;
+        } else {
+            m_tail = waiter.m_prev;
+        }
+        waiter.m_prev = nullptr;
+        waiter.m_next = nullptr;
+        waiter.m_linked = false;
+    }
+
+    void Semaphore::resume(std::coroutine_handle<> handle) {
+        if (m_scheduler && m_scheduler->resume(handle)) {
+            return;
+        }
+        if (m_pool != nullptr && m_pool->resume(handle)) {
+            return;
+        }
+        handle.resume();
+    }
+
+} // namespace coro
@@ -1,11 +1,34 @@
-              #include "../include/coro/thread_pool.hpp"
+#include "../include/coro/thread_pool.hpp"
 
 namespace  coro {
-    ThreadPool::ThreadPool(std::size_t thread_count) {
+    namespace {
+        // 记录当前线程所属的线程池及其本地队列下标，用于把工作线程内提交的任务放入本地队列
+        struct WorkerContext {
+            ThreadPool* pool{nullptr};
+            std::size_t index{0};
+            // 取任务的次数，用于定期检查全局队列
+            std::size_t tick{0};
+        };
+
+        thread_local WorkerContext t_worker{};
+    }
+
+    ThreadPool::ThreadPool(std::size_t thread_count, QueueStrategy strategy) : m_strategy(strategy) {
+        if (m_strategy == QueueStrategy::WorkStealing) {
+            m_local_queues.reserve(thread_count);
+            for (std::size_t i = 0; i < thread_count; ++i) {
+                m_local_queues.emplace_back(std::make_unique<local_queue>());
+            }
+        }
+
         m_threads.reserve(thread_count);
-        for (int i = 0; i < thread_count; ++i) {
-            m_threads.emplace_back([this]() {
-                executor();
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            m_threads.emplace_back([this, i]() {
+                if (m_strategy == QueueStrategy::WorkStealing) {
+                    work_stealing_executor(i);
+                } else {
+                    executor();
+                }
             });
         }
     }
@@ -57,8 +80,108 @@ namespace  coro {
 
     }
 
+    void ThreadPool::work_stealing_executor(std::size_t index) {
+        t_worker = WorkerContext{this, index};
+
+        while (true) {
+            if (auto handle = next_task(index)) {
+                handle.resume();
+                m_size.fetch_sub(1, std::memory_order_release);
+                continue;
+            }
+
+            // 停止后把能找到的任务执行完再退出
+            if (m_stop.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lk{m_queue_mutex};
+            m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+            // 与 notify_sleeping() 中的栅栏配对：要么提交方看到有线程在睡眠，要么这里看到新提交的任务
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_cv.wait(lk, [this]() {
+                return m_stop.load(std::memory_order_acquire) || has_pending_work();
+            });
+            m_sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        t_worker = WorkerContext{};
+    }
+
+    std::coroutine_handle<> ThreadPool::next_task(std::size_t index) {
+        if (++t_worker.tick % global_check_interval == 0) {
+            if (auto handle = pop_global()) {
+                return handle;
+            }
+        }
+
+        if (auto handle = m_local_queues[index]->pop()) {
+            return *handle;
+        }
+
+        if (auto handle = pop_global()) {
+            return handle;
+        }
+
+        // 从下一个线程开始轮流窃取，避免所有空闲线程都盯着同一个队列
+        auto count = m_local_queues.size();
+        for (std::size_t i = 1; i < count; ++i) {
+            auto& victim = m_local_queues[(index + i) % count];
+            if (auto handle = victim->steal()) {
+                return *handle;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::coroutine_handle<> ThreadPool::pop_global() {
+        if (m_global_size.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+        std::scoped_lock lk{m_queue_mutex};
+        if (m_queue.empty()) {
+            return nullptr;
+        }
+        auto handle = m_queue.front();
+        m_queue.pop();
+        m_global_size.fetch_sub(1, std::memory_order_release);
+        return handle;
+    }
+
+    bool ThreadPool::has_pending_work() const noexcept {
+        if (m_global_size.load(std::memory_order_acquire) > 0) {
+            return true;
+        }
+        for (const auto& queue : m_local_queues) {
+            if (!queue->empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::notify_sleeping(std::size_t count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto sleeping = m_sleeping.load(std::memory_order_seq_cst);
+        if (sleeping > 0) {
+            // 加锁保证睡眠线程要么还没检查条件，要么已经进入等待
+            std::scoped_lock lk{m_queue_mutex};
+            if (count >= sleeping) {
+                m_cv.notify_all();
+            } else {
+                for (std::size_t i = 0; i < count; ++i) {
+                    m_cv.notify_one();
+                }
+            }
+        }
+    }
+
     void ThreadPool::shutdown() noexcept {
         if (!m_stop.exchange(true, std::memory_order_acq_rel)) {
+            {
+                std::scoped_lock lk{m_queue_mutex};
+            }
             m_cv.notify_all();
 
             for (auto &thread: m_threads) {
@@ -82,15 +205,79 @@ namespace  coro {
         return true;
     }
 
-    void ThreadPool::scheduler_impl(std::coroutine_handle<> handle) noexcept {
+    std::size_t ThreadPool::resume(std::span<std::coroutine_handle<>> handles) {
+        if (handles.empty()) {
+            return 0;
+        }
+        m_size.fetch_add(handles.size(), std::memory_order_release);
+        if (m_stop.load(std::memory_order_acquire)) {
+            m_size.fetch_sub(handles.size(), std::memory_order_release);
+            return 0;
+        }
+
+        std::size_t count{0};
+        if (m_strategy == QueueStrategy::WorkStealing && t_worker.pool == this) {
+            auto& queue = *m_local_queues[t_worker.index];
+            for (auto handle : handles) {
+                if (handle != nullptr && !handle.done()) {
+                    queue.push(handle);
+                    ++count;
+                }
+            }
+        } else {
+            std::scoped_lock lk{m_queue_mutex};
+            for (auto handle : handles) {
+                if (handle != nullptr && !handle.done()) {
+                    m_queue.emplace(handle);
+                    ++count;
+                }
+            }
+            if (m_strategy == QueueStrategy::WorkStealing) {
+                m_global_size.fetch_add(count, std::memory_order_release);
+            }
+        }
+
+        if (count < handles.size()) {
+            m_size.fetch_sub(handles.size() - count, std::memory_order_release);
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        if (m_strategy == QueueStrategy::Global) {
+            // Global 模式下工作线程直接在条件变量上等待，没有睡眠计数
+            if (count >= m_threads.size()) {
+                m_cv.notify_all();
+            } else {
+                for (std::size_t i = 0; i < count; ++i) {
+                    m_cv.notify_one();
+                }
+            }
+        } else {
+            notify_sleeping(count);
+        }
+        return count;
+    }
+
+    void ThreadPool::scheduler_impl(std::coroutine_handle<> handle, bool fifo) noexcept {
         if (handle == nullptr || handle.done()) {
             return;
         }
 
-        {
+        if (m_strategy == QueueStrategy::Global) {
             std::scoped_lock lk{m_queue_mutex};
             m_queue.emplace(handle);
             m_cv.notify_one();
+            return;
+        }
+
+        if (!fifo && t_worker.pool == this) {
+            m_local_queues[t_worker.index]->push(handle);
+        } else {
+            std::scoped_lock lk{m_queue_mutex};
+            m_queue.emplace(handle);
+            m_global_size.fetch_add(1, std::memory_order_release);
         }
+        notify_sleeping();
     }
 } // namespace coro
@@ -0,0 +1,166 @@
+#include "coro/detail/timing_wheel.hpp"
+
+namespace coro::detail {
+
+    namespace {
+        void unlink(TimerNode& node) noexcept {
+            node.m_prev->m_next = node.m_next;
+            node.m_next->m_prev = node.m_prev;
+            node.m_prev = nullptr;
+            node.m_next = nullptr;
+        }
+
+        void link_back(TimerNode& head, TimerNode& node) noexcept {
+            node.m_prev = head.m_prev;
+            node.m_next = &head;
+            head.m_prev->m_next = &node;
+            head.m_prev = &node;
+        }
+
+        bool slot_empty(const TimerNode& head) noexcept { return head.m_next == &head; }
+    }
+
+    TimingWheel::TimingWheel(time_point origin, std::chrono::nanoseconds tick) : m_origin(origin), m_tick(tick) {
+        for (auto& head : m_slots) {
+            head.m_prev = &head;
+            head.m_next = &head;
+        }
+    }
+
+    std::uint64_t TimingWheel::time_to_tick(time_point tp) const noexcept {
+        if (tp <= m_origin) {
+            return 0;
+        }
+        // 向上取整，保证不会提前触发
+        auto elapsed = tp - m_origin;
+        return static_cast<std::uint64_t>((elapsed + m_tick - std::chrono::nanoseconds(1)) / m_tick);
+    }
+
+    std::uint64_t TimingWheel::add(TimerNode& node, time_point expiry) {
+        if (node.is_linked()) {
+            remove(node);
+        }
+
+        auto tick = time_to_tick(expiry);
+        // 已经过期的定时器在下一个 tick 触发
+        if (tick <= m_current) {
+            tick = m_current + 1;
+        }
+        node.m_expire_tick = tick;
+        place(node);
+        ++m_count;
+        return tick;
+    }
+
+    void TimingWheel::place(TimerNode& node) noexcept {
+        auto expire = node.m_expire_tick;
+        if (expire < m_current) {
+            expire = m_current;
+        }
+        auto delta = expire - m_current;
+
+        std::size_t level = 0;
+        while (level + 1 < level_count && delta >= (std::uint64_t{1} << (slot_bits * (level + 1)))) {
+            ++level;
+        }
+        // 超出最高层范围的定时器先放在最高层能表示的最远位置，下沉时重新计算
+        auto max_delta = (std::uint64_t{1} << (slot_bits * level_count)) - 1;
+        auto placed = delta > max_delta ? m_current + max_delta : expire;
+
+        auto index = (placed >> (slot_bits * level)) & slot_mask;
+        node.m_expire_tick = expire;
+        node.m_level = static_cast<std::uint8_t>(level);
+        link_back(slot(level, index), node);
+        ++m_level_counts[level];
+    }
+
+    void TimingWheel::remove(TimerNode& node) noexcept {
+        if (!node.is_linked()) {
+            return;
+        }
+        unlink(node);
+        --m_level_counts[node.m_level];
+        --m_count;
+    }
+
+    void TimingWheel::cascade(std::size_t level, std::size_t index) noexcept {
+        auto& head = slot(level, index);
+        while (!slot_empty(head)) {
+            auto& node = *head.m_next;
+            unlink(node);
+            --m_level_counts[level];
+            place(node);
+        }
+    }
+
+    void TimingWheel::process_tick(std::uint64_t tick, std::vector<TimerNode*>& expired) {
+        m_current = tick;
+
+        // 低层转完一圈，把上一层对应槽中的定时器下沉
+        if ((tick & slot_mask) == 0) {
+            for (std::size_t level = 1; level < level_count; ++level) {
+                auto index = (tick >> (slot_bits * level)) & slot_mask;
+                cascade(level, index);
+                if (index != 0) {
+                    break;
+                }
+            }
+        }
+
+        auto& head = slot(0, tick & slot_mask);
+        while (!slot_empty(head)) {
+            auto& node = *head.m_next;
+            unlink(node);
+            --m_level_counts[0];
+            --m_count;
+            expired.emplace_back(&node);
+        }
+    }
+
+    void TimingWheel::advance(time_point now, std::vector<TimerNode*>& expired) {
+        auto target = now <= m_origin ? 0 : static_cast<std::uint64_t>((now - m_origin) / m_tick);
+
+        while (m_current < target) {
+            if (m_count == 0) {
+                m_current = target;
+                break;
+            }
+
+            if (m_level_counts[0] == 0) {
+                // 最底层为空，下一次 cascade 之前没有定时器会到期，直接跳过
+                auto boundary = (m_current | slot_mask) + 1;
+                if (boundary > target) {
+                    m_current = target;
+                    break;
+                }
+                m_current = boundary - 1;
+            }
+
+            process_tick(m_current + 1, expired);
+        }
+    }
+
+    std::optional<std::uint64_t> TimingWheel::next_tick() const noexcept {
+        if (m_count == 0) {
+            return std::nullopt;
+        }
+
+        auto boundary = (m_current | slot_mask) + 1;
+        bool upper_levels = m_count != m_level_counts[0];
+
+        if (m_level_counts[0] > 0) {
+            // 最底层的槽恰好对应 (m_current, m_current + 256) 中的每个 tick
+            for (std::uint64_t tick = m_current + 1; tick < m_current + slot_count; ++tick) {
+                if (upper_levels && tick >= boundary) {
+                    return boundary;
+                }
+                if (!slot_empty(slot(0, tick & slot_mask))) {
+                    return tick;
+                }
+            }
+        }
+
+        return boundary;
+    }
+
+} // namespace coro::detail
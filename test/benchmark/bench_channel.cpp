@@ -0,0 +1,96 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coro/coro.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace coro;
+
+struct Totals {
+    std::atomic<std::size_t> received{0};
+    std::atomic<std::size_t> sum{0};
+};
+
+Task<> producer(ThreadPool& tp, Channel<std::size_t>& channel, std::size_t messages) {
+    co_await tp.schedule();
+    for (std::size_t i = 1; i <= messages; ++i) {
+        co_await channel.send(i);
+    }
+}
+
+Task<> consumer(ThreadPool& tp, Channel<std::size_t>& channel, Totals& totals) {
+    co_await tp.schedule();
+    std::size_t received{0};
+    std::size_t sum{0};
+    while (auto value = co_await channel.recv()) {
+        ++received;
+        sum += *value;
+    }
+    totals.received.fetch_add(received, std::memory_order_relaxed);
+    totals.sum.fetch_add(sum, std::memory_order_relaxed);
+}
+
+Task<> batch_consumer(ThreadPool& tp, Channel<std::size_t>& channel, Totals& totals) {
+    co_await tp.schedule();
+    std::array<std::size_t, 32> batch{};
+    std::size_t received{0};
+    std::size_t sum{0};
+    while (auto count = co_await channel.recv_many(batch)) {
+        received += count;
+        for (std::size_t i = 0; i < count; ++i) {
+            sum += batch[i];
+        }
+    }
+    totals.received.fetch_add(received, std::memory_order_relaxed);
+    totals.sum.fetch_add(sum, std::memory_order_relaxed);
+}
+
+// pairs 个生产者各发送 messages 个数据，pairs 个消费者接收直到通道关闭
+void run(const char* name, std::size_t threads, std::size_t pairs, std::size_t capacity, std::size_t messages,
+         bool batched) {
+    ThreadPool tp{threads};
+    Channel<std::size_t> channel{capacity, tp};
+    Totals totals;
+
+    std::vector<Task<>> producers;
+    for (std::size_t i = 0; i < pairs; ++i) {
+        producers.emplace_back(producer(tp, channel, messages));
+    }
+    auto close = [&]() -> Task<> {
+        co_await when_all(std::move(producers));
+        channel.close();
+    };
+
+    std::vector<Task<>> all;
+    for (std::size_t i = 0; i < pairs; ++i) {
+        all.emplace_back(batched ? batch_consumer(tp, channel, totals) : consumer(tp, channel, totals));
+    }
+    all.emplace_back(close());
+
+    auto start = std::chrono::steady_clock::now();
+    sync_wait(when_all(std::move(all)));
+    auto end = std::chrono::steady_clock::now();
+
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    auto total = pairs * messages;
+    auto ok = totals.received.load() == total && totals.sum.load() == pairs * messages * (messages + 1) / 2;
+    std::cout << name << " threads=" << threads << " pairs=" << pairs << " capacity=" << capacity << " : "
+              << static_cast<std::size_t>(static_cast<double>(total) / seconds) << " msgs/s, " << seconds * 1e3
+              << " ms total" << (ok ? "" : " (MISMATCH)") << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    std::size_t messages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200'000;
+    std::size_t capacity = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1024;
+
+    for (std::size_t pairs : {1, 4, 16}) {
+        run("recv     ", threads, pairs, capacity, messages, false);
+        run("recv_many", threads, pairs, capacity, messages, true);
+    }
+
+    return 0;
+}
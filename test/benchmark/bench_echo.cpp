@@ -0,0 +1,296 @@
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <coro/coro.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace coro;
+using namespace std::chrono_literals;
+
+// 回显服务器 + 客户端的往返测试，对比 epoll、常驻注册的 epoll（EPOLLET）与 io_uring
+// 系统调用的精确数量可以用 `strace -c -f ./bench_echo epoll` 观察，这里输出内核态 CPU 时间作为参考
+
+// 统计全局 operator new 的调用次数，用来观察每次往返的堆分配
+std::atomic<std::size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+struct EchoOptions {
+    uint16_t port{9090};
+    std::size_t connections{64};
+    std::size_t round_trips{10'000};
+    std::size_t message_size{64};
+    bool registered{false};  // 使用 IoScheduler::Registration，fd 只加入 epoll 一次
+    bool tcp_client{false};  // 服务端使用 tcp::Server / tcp::Client 的接口
+    bool zero_copy{false};   // tcp::Client 使用 recv_into/send_from，否则使用返回 string 的 recv/send
+    bool awaitable{false};   // tcp::Client 使用 read_some/write_all，先读写、只在 EAGAIN 时等待
+};
+
+// 按是否注册选择对应的 IoScheduler 接口
+struct EchoSocket {
+    std::shared_ptr<IoScheduler> scheduler;
+    int fd;
+    std::unique_ptr<IoScheduler::Registration> registration{nullptr};
+
+    Task<int> recv(std::span<char> buffer) {
+        return registration ? scheduler->recv(*registration, buffer) : scheduler->recv(fd, buffer);
+    }
+    Task<int> send(std::span<const char> buffer) {
+        return registration ? scheduler->send(*registration, buffer) : scheduler->send(fd, buffer);
+    }
+};
+
+Task<> echo_connection(std::shared_ptr<IoScheduler> scheduler, int fd, bool registered) {
+    EchoSocket sock{scheduler, fd, registered ? scheduler->register_fd(fd) : nullptr};
+    std::vector<char> buffer(4096);
+    while (true) {
+        auto n = co_await sock.recv(buffer);
+        if (n <= 0) {
+            break;
+        }
+        std::span<const char> data{buffer.data(), static_cast<std::size_t>(n)};
+        while (!data.empty()) {
+            auto sent = co_await sock.send(data);
+            if (sent <= 0) {
+                break;
+            }
+            data = data.subspan(static_cast<std::size_t>(sent));
+        }
+    }
+    sock.registration = nullptr;
+    ::close(fd);
+}
+
+Task<> echo_server(std::shared_ptr<IoScheduler> scheduler, net::Socket& listener, const EchoOptions& opts) {
+    co_await scheduler->schedule();
+    auto registration = opts.registered ? scheduler->register_fd(listener.fd()) : nullptr;
+    for (std::size_t i = 0; i < opts.connections; ++i) {
+        sockaddr_in addr{};
+        socklen_t len = sizeof(addr);
+        auto fd = registration
+                      ? co_await scheduler->accept(*registration, reinterpret_cast<sockaddr*>(&addr), &len)
+                      : co_await scheduler->accept(listener.fd(), reinterpret_cast<sockaddr*>(&addr), &len);
+        if (fd < 0) {
+            std::cerr << "accept failed: " << strerror(-fd) << "\n";
+            co_return;
+        }
+        scheduler->spawn(echo_connection(scheduler, fd, opts.registered));
+    }
+}
+
+// tcp::Client 接口的回显连接，对比返回 string 的 recv/send 与零拷贝的 recv_into/send_from
+Task<> tcp_echo_connection(net::tcp::Client client, bool zero_copy) {
+    std::vector<char> buffer(4096);
+    while (true) {
+        co_await client.poll(PollOp::Read);
+        std::size_t received{0};
+        if (zero_copy) {
+            auto [rstatus, data] = client.recv_into(buffer);
+            if (rstatus == net::RecvStatus::WouldBlock) {
+                continue;
+            } else if (rstatus != net::RecvStatus::Ok) {
+                co_return;
+            }
+            received = data.size();
+        } else {
+            auto [rstatus, data] = client.recv(buffer);
+            if (rstatus == net::RecvStatus::WouldBlock) {
+                continue;
+            } else if (rstatus != net::RecvStatus::Ok) {
+                co_return;
+            }
+            received = data.size();
+        }
+
+        std::span<const char> rest{buffer.data(), received};
+        while (!rest.empty()) {
+            co_await client.poll(PollOp::Write);
+            if (zero_copy) {
+                auto [sstatus, unsent] = client.send_from(rest);
+                if (sstatus == net::SendStatus::Ok) {
+                    rest = unsent;
+                } else if (sstatus != net::SendStatus::WouldBlock) {
+                    co_return;
+                }
+            } else {
+                auto [sstatus, unsent] = client.send(rest);
+                if (sstatus == net::SendStatus::Ok) {
+                    rest = rest.last(unsent.size());
+                } else if (sstatus != net::SendStatus::WouldBlock) {
+                    co_return;
+                }
+            }
+        }
+    }
+}
+
+Task<> tcp_awaitable_echo_connection(net::tcp::Client client) {
+    std::vector<char> buffer(4096);
+    while (true) {
+        auto [rstatus, received] = co_await client.read_some(buffer);
+        if (rstatus != net::RecvStatus::Ok) {
+            co_return;
+        }
+        auto [sstatus, sent] = co_await client.write_all(received);
+        if (sstatus != net::SendStatus::Ok) {
+            co_return;
+        }
+    }
+}
+
+Task<> tcp_echo_server(std::shared_ptr<IoScheduler> scheduler, const EchoOptions& opts) {
+    co_await scheduler->schedule();
+    net::tcp::Server server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = opts.port}};
+    server.register_socket();
+    std::size_t accepted{0};
+    while (accepted < opts.connections) {
+        if (co_await server.poll() != PollStatus::Event) {
+            co_return;
+        }
+        auto client = server.accept();
+        if (client.socket().is_valid()) {
+            if (opts.awaitable) {
+                scheduler->spawn(tcp_awaitable_echo_connection(std::move(client)));
+            } else {
+                scheduler->spawn(tcp_echo_connection(std::move(client), opts.zero_copy));
+            }
+            ++accepted;
+        }
+    }
+}
+
+Task<> echo_client(std::shared_ptr<IoScheduler> scheduler, const EchoOptions& opts) {
+    co_await scheduler->schedule();
+
+    auto sock = net::make_nonblocking_socket();
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(opts.port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto cret = co_await scheduler->connect(sock.fd(), reinterpret_cast<sockaddr*>(&addr), sizeof(addr), 1s);
+    if (cret < 0) {
+        std::cerr << "connect failed: " << strerror(-cret) << "\n";
+        co_return;
+    }
+    // 连接建立之后再注册，connect 使用的是一次性的 poll
+    EchoSocket echo{scheduler, sock.fd(), opts.registered ? scheduler->register_fd(sock.fd()) : nullptr};
+
+    std::vector<char> message(opts.message_size, 'x');
+    std::vector<char> reply(opts.message_size);
+    for (std::size_t i = 0; i < opts.round_trips; ++i) {
+        auto sent = co_await echo.send(message);
+        if (sent <= 0) {
+            co_return;
+        }
+        std::size_t received{0};
+        while (received < static_cast<std::size_t>(sent)) {
+            auto n = co_await echo.recv(std::span<char>{reply}.subspan(received));
+            if (n <= 0) {
+                co_return;
+            }
+            received += static_cast<std::size_t>(n);
+        }
+    }
+}
+
+double cpu_seconds(const timeval& tv) { return static_cast<double>(tv.tv_sec) + tv.tv_usec / 1e6; }
+
+void bench_backend(IoScheduler::IoBackend backend, const EchoOptions& opts) {
+    auto scheduler = IoScheduler::make_shared(IoScheduler::Options{
+        .execution_strategy = io_exec_thread_inline,
+        .threads_count = 1,
+        .queue_strategy = ThreadPool::QueueStrategy::WorkStealing,
+        .backend = backend,
+    });
+    auto name = opts.awaitable                                              ? "tcp_client_await"
+                : opts.tcp_client                                           ? (opts.zero_copy ? "tcp_client_zero_copy"
+                                                                                              : "tcp_client_copy")
+                : scheduler->backend() == IoScheduler::IoBackend::IoUring ? "io_uring"
+                : opts.registered                                           ? "epoll_et"
+                                                                            : "epoll";
+    if (backend == IoScheduler::IoBackend::IoUring && scheduler->backend() != backend) {
+        std::cout << "io_uring unavailable, fell back to epoll\n";
+    }
+
+    std::vector<Task<>> tasks;
+    net::Socket listener{};
+    if (opts.tcp_client) {
+        tasks.emplace_back(tcp_echo_server(scheduler, opts));
+    } else {
+        listener = net::make_accept_socket(net::IpAddress::from_string("127.0.0.1"), opts.port, 1024);
+        tasks.emplace_back(echo_server(scheduler, listener, opts));
+    }
+    for (std::size_t i = 0; i < opts.connections; ++i) {
+        tasks.emplace_back(echo_client(scheduler, opts));
+    }
+
+    rusage before{};
+    getrusage(RUSAGE_SELF, &before);
+    auto allocations_before = g_allocations.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    sync_wait(when_all(std::move(tasks)));
+    auto end = std::chrono::steady_clock::now();
+    auto allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+    rusage after{};
+    getrusage(RUSAGE_SELF, &after);
+
+    auto total = static_cast<double>(opts.connections * opts.round_trips);
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    auto sys = cpu_seconds(after.ru_stime) - cpu_seconds(before.ru_stime);
+    auto user = cpu_seconds(after.ru_utime) - cpu_seconds(before.ru_utime);
+    std::cout << "[" << name << "] connections=" << opts.connections << " round_trips=" << static_cast<std::size_t>(total)
+              << " : " << static_cast<std::size_t>(total / seconds) << " round_trips/s, sys "
+              << sys * 1e6 / total << " us/round_trip, user " << user * 1e6 / total << " us/round_trip, "
+              << static_cast<double>(allocations) / total << " allocs/round_trip\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "all";
+    EchoOptions opts{};
+    if (argc > 2) {
+        opts.connections = std::strtoul(argv[2], nullptr, 10);
+    }
+    if (argc > 3) {
+        opts.round_trips = std::strtoul(argv[3], nullptr, 10);
+    }
+
+    if (mode == "epoll" || mode == "all") {
+        bench_backend(IoScheduler::IoBackend::Epoll, opts);
+    }
+    if (mode == "epoll_et" || mode == "all") {
+        opts.port += 1;
+        opts.registered = true;
+        bench_backend(IoScheduler::IoBackend::Epoll, opts);
+        opts.registered = false;
+    }
+    if (mode == "io_uring" || mode == "all") {
+        opts.port += 1;
+        bench_backend(IoScheduler::IoBackend::IoUring, opts);
+    }
+    if (mode == "tcp_client" || mode == "all") {
+        opts.tcp_client = true;
+        for (bool zero_copy : {false, true}) {
+            opts.port += 1;
+            opts.zero_copy = zero_copy;
+            bench_backend(IoScheduler::IoBackend::Epoll, opts);
+        }
+        opts.port += 1;
+        opts.awaitable = true;
+        bench_backend(IoScheduler::IoBackend::Epoll, opts);
+    }
+    return 0;
+}
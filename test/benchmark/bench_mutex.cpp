@@ -0,0 +1,119 @@
+#include <atomic>
+#include <chrono>
+#include <coro/coro.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace coro;
+
+// 在临界区中忙等一段时间，模拟对共享状态的操作
+void busy_for(std::chrono::nanoseconds duration) {
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+struct Counters {
+    std::size_t locked{0};        // 只在临界区中修改
+    std::atomic<std::size_t> independent_done{0};
+};
+
+// 每次迭代加锁修改共享状态，解锁后让出，和其他协程交错执行
+Task<> std_locker(ThreadPool& tp, std::mutex& mutex, Counters& counters, std::size_t iterations,
+                  std::chrono::nanoseconds work) {
+    co_await tp.schedule();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        {
+            std::scoped_lock lk{mutex};
+            busy_for(work);
+            ++counters.locked;
+        }
+        co_await tp.yield();
+    }
+}
+
+Task<> coro_locker(ThreadPool& tp, Mutex& mutex, Counters& counters, std::size_t iterations,
+                   std::chrono::nanoseconds work) {
+    co_await tp.schedule();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        {
+            auto lk = co_await mutex.scoped_lock();
+            busy_for(work);
+            ++counters.locked;
+        }
+        co_await tp.yield();
+    }
+}
+
+// 不需要锁的任务，和加锁的任务共用线程池
+Task<> independent(ThreadPool& tp, Counters& counters, std::size_t iterations, std::chrono::nanoseconds work) {
+    co_await tp.schedule();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        busy_for(work);
+        co_await tp.yield();
+    }
+    counters.independent_done.fetch_add(1, std::memory_order_release);
+}
+
+template <typename MakeLocker>
+void run(const char* name, std::size_t threads, std::size_t lockers, std::size_t others, std::size_t iterations,
+         std::chrono::nanoseconds work, MakeLocker&& make_locker) {
+    ThreadPool tp{threads};
+    Counters counters;
+
+    std::vector<Task<>> all;
+    for (std::size_t i = 0; i < lockers; ++i) {
+        all.emplace_back(make_locker(tp, counters));
+    }
+    for (std::size_t i = 0; i < others; ++i) {
+        all.emplace_back(independent(tp, counters, iterations, work));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sync_wait(when_all(std::move(all)));
+    auto end = std::chrono::steady_clock::now();
+
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    auto ops = static_cast<double>(lockers * iterations);
+    std::cout << name << " threads=" << threads << " lockers=" << lockers << " others=" << others
+              << " : " << static_cast<std::size_t>(ops / seconds) << " locked ops/s, " << seconds * 1e3
+              << " ms total (counter " << counters.locked << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2'000;
+    auto work = std::chrono::nanoseconds{argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1'000};
+
+    // lockers 个协程争用同一把锁，others 个协程只做不需要锁的工作；
+    // std::mutex 争用时阻塞工作线程，其他协程也跟着等待
+    for (std::size_t others : {std::size_t{0}, threads * 4}) {
+        std::size_t lockers = threads * 4;
+
+        std::mutex std_mutex;
+        run("std::mutex          ", threads, lockers, others, iterations, work, [&](ThreadPool& tp, Counters& c) {
+            return std_locker(tp, std_mutex, c, iterations, work);
+        });
+
+        Mutex inline_mutex;
+        run("coro::Mutex (inline)", threads, lockers, others, iterations, work, [&](ThreadPool& tp, Counters& c) {
+            return coro_locker(tp, inline_mutex, c, iterations, work);
+        });
+
+        // 执行器要在线程池创建之后绑定，每次运行创建新的锁
+        std::unique_ptr<Mutex> pool_mutex;
+        run("coro::Mutex (pool)  ", threads, lockers, others, iterations, work, [&](ThreadPool& tp, Counters& c) {
+            if (!pool_mutex) {
+                pool_mutex = std::make_unique<Mutex>(tp);
+            }
+            return coro_locker(tp, *pool_mutex, c, iterations, work);
+        });
+    }
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <coro/net/tcp/http/router.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace coro::net::tcp::http;
+
+// 50 个资源，每个 10 条路由，共 500 条，接近一个中等规模的 REST 服务
+struct Route {
+    Method method;
+    std::string pattern;
+};
+
+struct Lookup {
+    Method method;
+    std::string path;
+};
+
+std::vector<Route> make_routes() {
+    std::vector<Route> routes;
+    for (int r = 0; r < 50; ++r) {
+        auto base = "/api/v" + std::to_string(r % 3 + 1) + "/resource" + std::to_string(r);
+        routes.push_back({Method::Get, base});
+        routes.push_back({Method::Post, base});
+        routes.push_back({Method::Get, base + "/search"});
+        routes.push_back({Method::Get, base + "/:id"});
+        routes.push_back({Method::Put, base + "/:id"});
+        routes.push_back({Method::Delete, base + "/:id"});
+        routes.push_back({Method::Get, base + "/:id/items"});
+        routes.push_back({Method::Post, base + "/:id/items"});
+        routes.push_back({Method::Get, base + "/:id/items/:item"});
+        routes.push_back({Method::Get, "/static/resource" + std::to_string(r) + "/*file"});
+    }
+    return routes;
+}
+
+// 把模式中的参数换成具体的值，得到能匹配它的请求路径
+std::string instantiate(const std::string& pattern, int seed) {
+    std::string path;
+    std::size_t i = 0;
+    while (i < pattern.size()) {
+        if ((pattern[i] == ':' || pattern[i] == '*') && pattern[i - 1] == '/') {
+            path += pattern[i] == ':' ? std::to_string(10000 + seed * 7) : "css/app." + std::to_string(seed) + ".css";
+            while (i < pattern.size() && pattern[i] != '/') {
+                ++i;
+            }
+        } else {
+            path += pattern[i++];
+        }
+    }
+    return path;
+}
+
+// 逐条比较的基线：按段匹配每一条路由
+bool linear_match(const Route& route, Method method, std::string_view path, PathParams& params) {
+    if (route.method != method) {
+        return false;
+    }
+    params.clear();
+    std::string_view pattern{route.pattern};
+    while (!pattern.empty() && !path.empty()) {
+        auto pslash = pattern.find('/', 1);
+        auto segment = pattern.substr(0, pslash);
+        if (segment.size() > 1 && segment[1] == '*') {
+            params.push(segment.substr(2), path.substr(1));
+            return true;
+        }
+        auto slash = path.find('/', 1);
+        auto value = path.substr(0, slash);
+        if (segment.size() > 1 && segment[1] == ':') {
+            if (value.size() < 2) {
+                return false;
+            }
+            params.push(segment.substr(2), value.substr(1));
+        } else if (segment != value) {
+            return false;
+        }
+        pattern.remove_prefix(segment.size());
+        path.remove_prefix(value.size());
+    }
+    return pattern.empty() && path.empty();
+}
+
+template <typename Func>
+void run(const char* impl, const char* name, const std::vector<Lookup>& lookups, std::size_t iterations, Func&& func) {
+    std::size_t checksum{0};
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        const auto& lookup = lookups[i % lookups.size()];
+        checksum += func(lookup);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << impl << " [" << name << "] : " << static_cast<std::size_t>(iterations / seconds)
+              << " lookups/s, " << seconds * 1e9 / iterations << " ns/lookup (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5'000'000;
+
+    auto routes = make_routes();
+    Router router;
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        router.add(routes[i].method, routes[i].pattern, static_cast<Router::value_type>(i));
+    }
+    router.freeze();
+
+    // 静态路径和带参数的路径分开测，哈希表只能处理前者
+    std::vector<Lookup> static_lookups;
+    std::vector<Lookup> param_lookups;
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        auto path = instantiate(routes[i].pattern, static_cast<int>(i));
+        auto& lookups = path == routes[i].pattern ? static_lookups : param_lookups;
+        lookups.push_back({routes[i].method, std::move(path)});
+    }
+    std::cout << "routes=" << router.size() << " static=" << static_lookups.size()
+              << " param=" << param_lookups.size() << "\n";
+
+    // 原来 HttpServer 的做法：方法 -> 路径 -> 处理函数的两层哈希表，只支持精确匹配
+    std::unordered_map<std::string, std::unordered_map<std::string, std::size_t>> exact;
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        if (routes[i].pattern.find_first_of(":*") == std::string::npos) {
+            exact[std::to_string(static_cast<int>(routes[i].method))][routes[i].pattern] = i;
+        }
+    }
+
+    PathParams params;
+    auto radix = [&](const Lookup& lookup) -> std::size_t {
+        params.clear();
+        auto match = router.match(lookup.method, lookup.path, params);
+        if (match.status != Router::Status::Found) {
+            std::cerr << "no route: " << lookup.path << "\n";
+            std::exit(1);
+        }
+        return match.value + params.size();
+    };
+    auto linear = [&](const Lookup& lookup) -> std::size_t {
+        for (std::size_t i = 0; i < routes.size(); ++i) {
+            if (linear_match(routes[i], lookup.method, lookup.path, params)) {
+                return i + params.size();
+            }
+        }
+        std::cerr << "no route: " << lookup.path << "\n";
+        std::exit(1);
+    };
+    auto hash = [&](const Lookup& lookup) -> std::size_t {
+        // 和原来一样，每次查找都用请求中的字符串构造 key
+        auto& paths = exact.find(std::to_string(static_cast<int>(lookup.method)))->second;
+        return paths.find(std::string{lookup.path})->second;
+    };
+
+    run("hash_exact ", "static", static_lookups, iterations, hash);
+    run("linear     ", "static", static_lookups, iterations / 10, linear);
+    run("radix      ", "static", static_lookups, iterations, radix);
+    run("linear     ", "param", param_lookups, iterations / 10, linear);
+    run("radix      ", "param", param_lookups, iterations, radix);
+    return 0;
+}
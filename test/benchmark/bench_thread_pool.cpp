@@ -0,0 +1,159 @@
+#include <chrono>
+#include <coro/coro.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace coro;
+
+// 每个任务先被调度到线程池，然后反复 yield，模拟大量协程在工作线程之间来回恢复
+Task<> yield_task(ThreadPool& tp, std::size_t yields) {
+    co_await tp.schedule();
+    for (std::size_t i = 0; i < yields; ++i) {
+        co_await tp.yield();
+    }
+    co_return;
+}
+
+// 在工作线程内部继续派生子任务，考察本地队列 + 窃取的负载均衡
+Task<> fan_out_task(ThreadPool& tp, std::size_t depth) {
+    co_await tp.schedule();
+    if (depth == 0) {
+        co_return;
+    }
+    std::vector<Task<>> children;
+    children.emplace_back(fan_out_task(tp, depth - 1));
+    children.emplace_back(fan_out_task(tp, depth - 1));
+    co_await when_all(std::move(children));
+}
+
+// 模拟 IO 线程：协程挂起后把句柄交给外部线程，外部线程每次最多取 128 个恢复到线程池
+struct ParkingLot {
+    struct Awaiter {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            std::scoped_lock lk{lot.mutex};
+            lot.parked.emplace_back(handle);
+        }
+        void await_resume() noexcept {}
+
+        ParkingLot& lot;
+    };
+
+    Awaiter park() { return Awaiter{*this}; }
+
+    std::mutex mutex;
+    std::vector<std::coroutine_handle<>> parked;
+};
+
+Task<> park_task(ThreadPool& tp, ParkingLot& lot, std::size_t rounds, std::atomic<std::size_t>& done) {
+    co_await tp.schedule();
+    for (std::size_t i = 0; i < rounds; ++i) {
+        co_await lot.park();
+    }
+    done.fetch_add(1, std::memory_order_release);
+}
+
+const char* strategy_name(ThreadPool::QueueStrategy strategy) {
+    return strategy == ThreadPool::QueueStrategy::WorkStealing ? "work_stealing" : "global_mutex";
+}
+
+void bench_yield(ThreadPool::QueueStrategy strategy, std::size_t threads, std::size_t tasks, std::size_t yields) {
+    ThreadPool tp{threads, strategy};
+
+    std::vector<Task<>> all;
+    all.reserve(tasks);
+    for (std::size_t i = 0; i < tasks; ++i) {
+        all.emplace_back(yield_task(tp, yields));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sync_wait(when_all(std::move(all)));
+    auto end = std::chrono::steady_clock::now();
+
+    auto ops = static_cast<double>(tasks * (yields + 1));
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "yield   [" << strategy_name(strategy) << "] threads=" << threads << " tasks=" << tasks
+              << " resumes=" << static_cast<std::size_t>(ops) << " : " << static_cast<std::size_t>(ops / seconds)
+              << " resumes/s\n";
+}
+
+void bench_fan_out(ThreadPool::QueueStrategy strategy, std::size_t threads, std::size_t depth) {
+    ThreadPool tp{threads, strategy};
+
+    auto start = std::chrono::steady_clock::now();
+    sync_wait(fan_out_task(tp, depth));
+    auto end = std::chrono::steady_clock::now();
+
+    auto ops = static_cast<double>((std::size_t{1} << (depth + 1)) - 1);
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "fan_out [" << strategy_name(strategy) << "] threads=" << threads << " depth=" << depth
+              << " tasks=" << static_cast<std::size_t>(ops) << " : " << static_cast<std::size_t>(ops / seconds)
+              << " tasks/s\n";
+}
+
+void bench_handoff(ThreadPool::QueueStrategy strategy, std::size_t threads, std::size_t tasks, std::size_t rounds,
+                   bool batched) {
+    constexpr std::size_t batch_size = 128;
+    ThreadPool tp{threads, strategy};
+    ParkingLot lot;
+    std::atomic<std::size_t> done{0};
+
+    std::vector<Task<>> all;
+    all.reserve(tasks);
+    for (std::size_t i = 0; i < tasks; ++i) {
+        all.emplace_back(park_task(tp, lot, rounds, done));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread waiter{[&all]() { sync_wait(when_all(std::move(all))); }};
+
+    std::vector<std::coroutine_handle<>> ready;
+    while (done.load(std::memory_order_acquire) < tasks) {
+        {
+            std::scoped_lock lk{lot.mutex};
+            ready.swap(lot.parked);
+        }
+        if (ready.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (std::size_t offset = 0; offset < ready.size(); offset += batch_size) {
+            auto batch = std::span{ready}.subspan(offset, std::min(batch_size, ready.size() - offset));
+            if (batched) {
+                tp.resume(batch);
+            } else {
+                for (auto handle : batch) {
+                    tp.resume(handle);
+                }
+            }
+        }
+        ready.clear();
+    }
+    waiter.join();
+    auto end = std::chrono::steady_clock::now();
+
+    auto ops = static_cast<double>(tasks * rounds);
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "handoff [" << strategy_name(strategy) << (batched ? ", batched" : ", one_by_one")
+              << "] threads=" << threads << " tasks=" << tasks << " handoffs=" << static_cast<std::size_t>(ops)
+              << " : " << static_cast<std::size_t>(ops / seconds) << " handoffs/s\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    std::size_t tasks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10'000;
+    std::size_t yields = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100;
+
+    for (auto strategy : {ThreadPool::QueueStrategy::Global, ThreadPool::QueueStrategy::WorkStealing}) {
+        bench_yield(strategy, threads, tasks, yields);
+        bench_fan_out(strategy, threads, 16);
+        bench_handoff(strategy, threads, tasks, yields, false);
+        bench_handoff(strategy, threads, tasks, yields, true);
+    }
+
+    return 0;
+}
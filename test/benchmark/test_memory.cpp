@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <malloc.h>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -59,6 +60,76 @@ int coroutine_test() {
     return 0;
 }
 
+Task<int> leaf_task(int value) { co_return value; }
+
+// 顺序创建、执行、销毁 count 个子协程帧，全部在同一个线程上
+Task<std::size_t> chain_task(std::size_t count) {
+    std::size_t sum{0};
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += co_await leaf_task(static_cast<int>(i));
+    }
+    co_return sum;
+}
+
+Task<int> hop_task(ThreadPool& tp, int value) {
+    co_await tp.yield();
+    co_return value;
+}
+
+// 子协程帧在一个工作线程上创建，可能在另一个工作线程上销毁，走跨线程归还的路径
+Task<std::size_t> hop_chain_task(ThreadPool& tp, std::size_t count) {
+    co_await tp.schedule();
+    std::size_t sum{0};
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += co_await hop_task(tp, static_cast<int>(i));
+    }
+    co_return sum;
+}
+
+void frame_test_once(bool pooled) {
+    detail::FrameAllocator::set_enabled(pooled);
+    const char* name = pooled ? "pool" : "malloc";
+
+    const std::size_t frames = 10'000'000;
+    auto start = std::chrono::steady_clock::now();
+    sync_wait(chain_task(frames));
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[" << name << "] 同线程: " << static_cast<std::size_t>(frames / seconds) << " frames/s\n";
+
+    {
+        ThreadPool tp{4};
+        const std::size_t hops = 200'000;
+        const std::size_t chains = 8;
+        std::vector<Task<std::size_t>> tasks;
+        for (std::size_t i = 0; i < chains; ++i) {
+            tasks.emplace_back(hop_chain_task(tp, hops));
+        }
+        start = std::chrono::steady_clock::now();
+        sync_wait(when_all(std::move(tasks)));
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[" << name << "] 跨线程: " << static_cast<std::size_t>(hops * chains / seconds)
+                  << " frames/s\n";
+    }
+
+    // 同时持有大量帧时堆上占用的增量（mallinfo2 统计已分配的字节，不受之前释放的内存是否归还系统影响），
+    // 包括 malloc 块头、分配器头部和大小类取整的开销
+    const std::size_t live = 1'000'000;
+    std::vector<Task<int>> tasks;
+    tasks.reserve(live);
+    auto heap_before = mallinfo2().uordblks;
+    for (std::size_t i = 0; i < live; ++i) {
+        tasks.emplace_back(leaf_task(static_cast<int>(i)));
+    }
+    auto heap_after = mallinfo2().uordblks;
+    std::cout << "[" << name << "] 每帧内存: " << static_cast<double>(heap_after - heap_before) / live << " 字节\n";
+}
+
+int frame_test() {
+    frame_test_once(false);
+    frame_test_once(true);
+    return 0;
+}
+
 void thread_function() {}
 
 // 线程测试：创建 1000 个线程
@@ -88,7 +159,7 @@ int thread_test() {
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cout << "用法: " << argv[0] << " [coroutine|thread]\n";
+        std::cout << "用法: " << argv[0] << " [coroutine|thread|frames]\n";
         return 1;
     }
     std::string mode = argv[1];
@@ -96,8 +167,10 @@ int main(int argc, char* argv[]) {
         return coroutine_test();
     } else if (mode == "thread") {
         return thread_test();
+    } else if (mode == "frames") {
+        return frame_test();
     } else {
-        std::cout << "无效的模式。请选择 'coroutine' 或 'thread'.\n";
+        std::cout << "无效的模式。请选择 'coroutine'、'thread' 或 'frames'.\n";
         return 1;
     }
 
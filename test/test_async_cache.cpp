@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace coro;
+using namespace std::chrono_literals;
+
+namespace {
+    std::shared_ptr<IoScheduler> make_scheduler() {
+        return IoScheduler::make_shared({io_exec_thread_pool, 2, ThreadPool::QueueStrategy::WorkStealing,
+                                         IoScheduler::IoBackend::Epoll});
+    }
+} // namespace
+
+TEST(AsyncCacheTest, LruEvictionAndStats) {
+    AsyncCache<std::string, int> cache{make_scheduler(), {.capacity = 2, .shards = 1, .ttl = 0ms}};
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    EXPECT_EQ(cache.get("a"), 1);
+    // b 最久未使用，被淘汰
+    cache.put("c", 3);
+    EXPECT_EQ(cache.get("b"), std::nullopt);
+    EXPECT_EQ(cache.get("a"), 1);
+    EXPECT_EQ(cache.get("c"), 3);
+    EXPECT_EQ(cache.size(), 2u);
+
+    EXPECT_TRUE(cache.erase("a"));
+    EXPECT_FALSE(cache.erase("a"));
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.expirations, 0u);
+}
+
+TEST(AsyncCacheTest, TtlExpiresThroughTimer) {
+    AsyncCache<int, std::string> cache{make_scheduler(), {.capacity = 16, .shards = 4, .ttl = 50ms}};
+
+    cache.put(1, "short");
+    cache.put(2, "long", 10s);
+    cache.put(3, "overwritten");
+    EXPECT_EQ(cache.get(1), "short");
+
+    // 覆盖之后的版本使用新的 TTL，旧的定时器不删除它
+    cache.put(3, "kept", 0ms);
+
+    // 没有访问，定时器到期时删除
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (cache.size() > 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.stats().misses, 0u);
+    EXPECT_EQ(cache.get(1), std::nullopt);
+    EXPECT_EQ(cache.get(2), "long");
+    EXPECT_EQ(cache.get(3), "kept");
+    EXPECT_EQ(cache.stats().expirations, 1u);
+}
+
+TEST(AsyncCacheTest, OverwritesCancelTimers) {
+    auto scheduler = make_scheduler();
+    AsyncCache<int, int> cache{scheduler, {.capacity = 4, .shards = 1, .ttl = 5s}};
+
+    // 覆盖、淘汰和删除都取消旧条目的定时器，等待中的定时协程数不随写入次数增长
+    for (int i = 0; i < 20000; ++i) {
+        cache.put(i % 8, i);
+    }
+    cache.erase(7);
+    // 每个等待中的定时器在 scheduler 中计两次：spawn 的任务和其中的 wait_notified
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (scheduler->size() > 2 * cache.size() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_LE(scheduler->size(), 2 * cache.size());
+    EXPECT_EQ(cache.stats().expirations, 0u);
+}
+
+TEST(AsyncCacheTest, GetOrLoadCoalescesMisses) {
+    auto scheduler = make_scheduler();
+    AsyncCache<int, long> cache{scheduler, {.capacity = 64, .shards = 4, .ttl = 10s}};
+    std::atomic<int> loads{0};
+    std::atomic<long> sum{0};
+
+    auto caller = [&](int key) -> Task<> {
+        co_await scheduler->schedule();
+        auto value = co_await cache.get_or_load(key, [&, key]() -> Task<long> {
+            loads.fetch_add(1, std::memory_order_relaxed);
+            co_await scheduler->yield_for(50ms);
+            co_return key * 10L;
+        });
+        sum.fetch_add(value, std::memory_order_relaxed);
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 100; ++i) {
+        tasks.emplace_back(caller(i % 2));
+    }
+    sync_wait(when_all(std::move(tasks)));
+
+    EXPECT_EQ(loads.load(), 2);
+    EXPECT_EQ(sum.load(), 50L * 10);
+    EXPECT_EQ(cache.stats().loads, 2u);
+
+    // 之后命中，不再加载
+    EXPECT_EQ(sync_wait(cache.get_or_load(1, [&]() -> Task<long> { co_return -1; })), 10);
+
+    // 结果为空时不写入缓存
+    auto missing = sync_wait(cache.get_or_load_if(7, []() -> Task<std::optional<long>> { co_return std::nullopt; }));
+    EXPECT_EQ(missing, std::nullopt);
+    EXPECT_EQ(cache.get(7), std::nullopt);
+    EXPECT_EQ(cache.stats().loads, 3u);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <vector>
+
+using namespace coro;
+
+TEST(ChannelTest, BackpressureAndClose) {
+    Channel<int> channel{2};
+    std::vector<int> sent;
+
+    auto sender = [](Channel<int>& channel, std::vector<int>& sent, int value) -> Task<> {
+        if (co_await channel.send(value)) {
+            sent.push_back(value);
+        }
+    };
+
+    int value = 1;
+    EXPECT_TRUE(channel.try_send(value));
+    value = 2;
+    EXPECT_TRUE(channel.try_send(value));
+    value = 3;
+    EXPECT_FALSE(channel.try_send(value));
+    EXPECT_EQ(value, 3);
+
+    // 缓冲区满，发送者挂起
+    std::vector<Task<>> senders;
+    senders.push_back(sender(channel, sent, 3));
+    senders.back().resume();
+    senders.push_back(sender(channel, sent, 4));
+    senders.back().resume();
+    EXPECT_TRUE(sent.empty());
+
+    // 没有执行器时接收者取走一个数据，在自己的线程上替第一个等待的发送者放入
+    EXPECT_EQ(channel.try_recv(), 1);
+    EXPECT_EQ(sent, (std::vector<int>{3}));
+    EXPECT_TRUE(senders[0].done());
+    EXPECT_FALSE(senders[1].done());
+
+    // 关闭之后等待的发送者得到 false，已经放入的数据仍然可以取出
+    channel.close();
+    EXPECT_TRUE(senders[1].done());
+    EXPECT_EQ(sent, (std::vector<int>{3}));
+
+    auto drain = [](Channel<int>& channel) -> Task<std::vector<int>> {
+        std::vector<int> values;
+        while (auto value = co_await channel.recv()) {
+            values.push_back(*value);
+        }
+        EXPECT_FALSE(co_await channel.send(5));
+        co_return values;
+    };
+    EXPECT_EQ(sync_wait(drain(channel)), (std::vector<int>{2, 3}));
+}
+
+TEST(ChannelTest, ReceiverWaitsAndRecvManyBatches) {
+    Channel<int> channel{8};
+    std::optional<int> received;
+    std::array<int, 4> batch{};
+    std::size_t batch_count{0};
+
+    auto receiver = [](Channel<int>& channel, std::optional<int>& received) -> Task<> {
+        received = co_await channel.recv();
+    };
+    auto batch_receiver = [](Channel<int>& channel, std::span<int> out, std::size_t& count) -> Task<> {
+        count = co_await channel.recv_many(out);
+    };
+
+    auto single = receiver(channel, received);
+    single.resume();
+    auto many = batch_receiver(channel, batch, batch_count);
+    many.resume();
+    EXPECT_FALSE(single.done());
+    EXPECT_FALSE(many.done());
+
+    // 发送者替第一个等待的接收者取出数据，再唤醒下一个
+    for (int i = 1; i <= 2; ++i) {
+        auto value = i;
+        EXPECT_TRUE(channel.try_send(value));
+    }
+    EXPECT_TRUE(single.done());
+    EXPECT_EQ(received, 1);
+    EXPECT_TRUE(many.done());
+    EXPECT_EQ(batch_count, 1u);
+    EXPECT_EQ(batch[0], 2);
+
+    // 缓冲区有数据时 recv_many 一次取出多个
+    for (int i = 3; i <= 8; ++i) {
+        auto value = i;
+        EXPECT_TRUE(channel.try_send(value));
+    }
+    auto again = batch_receiver(channel, batch, batch_count);
+    again.resume();
+    EXPECT_TRUE(again.done());
+    EXPECT_EQ(batch_count, 4u);
+    EXPECT_EQ(batch, (std::array<int, 4>{3, 4, 5, 6}));
+
+    channel.close();
+    auto last = batch_receiver(channel, batch, batch_count);
+    last.resume();
+    EXPECT_EQ(batch_count, 2u);
+    auto closed = batch_receiver(channel, batch, batch_count);
+    closed.resume();
+    EXPECT_EQ(batch_count, 0u);
+}
+
+TEST(ChannelTest, ProducersAndConsumersOnThreadPool) {
+    ThreadPool tp{4};
+    Channel<int> channel{16, tp};
+    std::atomic<long> sum{0};
+    std::atomic<int> received{0};
+
+    auto producer = [&](int base) -> Task<> {
+        co_await tp.schedule();
+        for (int i = 1; i <= 10000; ++i) {
+            EXPECT_TRUE(co_await channel.send(base + i));
+        }
+    };
+    auto consumer = [&]() -> Task<> {
+        co_await tp.schedule();
+        while (auto value = co_await channel.recv()) {
+            sum.fetch_add(*value, std::memory_order_relaxed);
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    auto batch_consumer = [&]() -> Task<> {
+        co_await tp.schedule();
+        std::array<int, 8> batch{};
+        while (auto count = co_await channel.recv_many(batch)) {
+            for (std::size_t i = 0; i < count; ++i) {
+                sum.fetch_add(batch[i], std::memory_order_relaxed);
+            }
+            received.fetch_add(static_cast<int>(count), std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<Task<>> producers;
+    for (int i = 0; i < 4; ++i) {
+        producers.emplace_back(producer(i * 10000));
+    }
+    auto close = [&]() -> Task<> {
+        co_await when_all(std::move(producers));
+        channel.close();
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.emplace_back(consumer());
+    }
+    tasks.emplace_back(batch_consumer());
+    tasks.emplace_back(close());
+    sync_wait(when_all(std::move(tasks)));
+
+    EXPECT_EQ(received.load(), 40000);
+    EXPECT_EQ(sum.load(), 4L * 50005000 + 10000L * (0 + 10000 + 20000 + 30000));
+}
@@ -0,0 +1,1069 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+#include <coro/net/tcp/http/handler.hpp>
+#include <coro/net/tcp/http/request_parser.hpp>
+#include <coro/net/tcp/http/response.hpp>
+#include <coro/net/tcp/http/router.hpp>
+#include <coro/net/tcp/http/scan.hpp>
+#include <coro/net/tcp/http/static_files.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+using namespace coro::net::tcp::http;
+
+// 统计当前线程在打开开关期间调用全局 operator new 的次数，用来检查稳定状态下处理请求不分配堆内存
+namespace {
+    thread_local bool t_count_allocations{false};
+    std::atomic<std::size_t> g_allocations{0};
+}
+
+namespace {
+    // 所有替换的 operator new 都从这里分配，所有 operator delete 都转到不带参数的版本释放
+    void* counted_allocate(std::size_t size, std::size_t alignment) noexcept {
+        if (t_count_allocations) {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        size = size == 0 ? 1 : size;
+        if (alignment <= alignof(std::max_align_t)) {
+            return std::malloc(size);
+        }
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void* counted_allocate_or_throw(std::size_t size, std::size_t alignment) {
+        if (void* ptr = counted_allocate(size, alignment)) {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+}
+
+void* operator new(std::size_t size) { return counted_allocate_or_throw(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return counted_allocate_or_throw(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+// std::pmr 的默认资源使用对齐版本
+void* operator new(std::size_t size, std::align_val_t align) {
+    return counted_allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return counted_allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { ::operator delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { ::operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { ::operator delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { ::operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { ::operator delete(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { ::operator delete(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { ::operator delete(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { ::operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { ::operator delete(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { ::operator delete(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { ::operator delete(ptr); }
+
+namespace {
+    constexpr std::string_view simple_request =
+        "POST /api/login?user=admin HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "content-type:  application/json \r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "hello";
+}
+
+TEST(RequestParserTest, ParseComplete) {
+    RequestParser parser;
+    Request req;
+    ASSERT_EQ(parser.parse(simple_request, req), RequestParser::Result::Complete);
+    EXPECT_EQ(req.method, "POST");
+    EXPECT_EQ(req.target, "/api/login?user=admin");
+    EXPECT_EQ(req.path, "/api/login");
+    EXPECT_EQ(req.query, "user=admin");
+    EXPECT_EQ(req.version, "HTTP/1.1");
+    ASSERT_EQ(req.headers.size(), 3u);
+    EXPECT_EQ(req.header("Content-Type"), "application/json");
+    EXPECT_EQ(req.header("HOST"), "example.com");
+    EXPECT_FALSE(req.header("Accept").has_value());
+    EXPECT_EQ(req.content_length, 5u);
+    EXPECT_EQ(req.body, "hello");
+    EXPECT_EQ(parser.consumed(), simple_request.size());
+
+    // 视图直接指向输入缓冲区
+    EXPECT_EQ(req.method.data(), simple_request.data());
+}
+
+TEST(RequestParserTest, ResumeAcrossPartialReads) {
+    // 每次多给一个字节，缓冲区每次都重新分配，解析结果仍然指向最后一次的数据
+    RequestParser parser;
+    Request req;
+    std::string buffer;
+    for (size_t i = 0; i < simple_request.size(); ++i) {
+        buffer.push_back(simple_request[i]);
+        buffer.shrink_to_fit();
+        auto result = parser.parse(buffer, req);
+        if (i + 1 < simple_request.size()) {
+            ASSERT_EQ(result, RequestParser::Result::Incomplete) << "at byte " << i;
+        } else {
+            ASSERT_EQ(result, RequestParser::Result::Complete);
+        }
+    }
+    EXPECT_EQ(req.path, "/api/login");
+    EXPECT_EQ(req.body, "hello");
+    EXPECT_EQ(req.body.data(), buffer.data() + buffer.size() - 5);
+}
+
+TEST(RequestParserTest, PipelinedRequests) {
+    std::string buffer = "GET /a HTTP/1.1\r\nHost: x\r\n\r\nGET /b HTTP/1.0\r\n\r\nGET /c";
+    RequestParser parser;
+    Request req;
+    std::string_view data{buffer};
+
+    ASSERT_EQ(parser.parse(data, req), RequestParser::Result::Complete);
+    EXPECT_EQ(req.path, "/a");
+    data.remove_prefix(parser.consumed());
+    parser.reset();
+
+    ASSERT_EQ(parser.parse(data, req), RequestParser::Result::Complete);
+    EXPECT_EQ(req.path, "/b");
+    EXPECT_EQ(req.version, "HTTP/1.0");
+    EXPECT_TRUE(req.headers.empty());
+    data.remove_prefix(parser.consumed());
+    parser.reset();
+
+    EXPECT_EQ(parser.parse(data, req), RequestParser::Result::Incomplete);
+}
+
+TEST(RequestParserTest, RejectInvalidRequests) {
+    auto status_of = [](std::string_view data, RequestParser::Limits limits = {}) {
+        RequestParser parser{limits};
+        Request req;
+        auto result = parser.parse(data, req);
+        return result == RequestParser::Result::Error ? parser.error_status() : 0;
+    };
+
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nHost: x\r\n\r\n"), 0);
+    EXPECT_EQ(status_of("GET /\r\n\r\n"), 400);
+    EXPECT_EQ(status_of("G(T / HTTP/1.1\r\n\r\n"), 400);
+    EXPECT_EQ(status_of("GET / HTTP/2.0\r\n\r\n"), 505);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\nHost: x\n\n"), 400);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nHost : x\r\n\r\n"), 400);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nHost: x\r\n folded\r\n\r\n"), 400);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n"), 400);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n"), 400);
+    EXPECT_EQ(status_of("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"), 0);
+    EXPECT_EQ(status_of("POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n"), 501);
+    EXPECT_EQ(status_of("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 3\r\n\r\n"), 400);
+}
+
+TEST(RequestParserTest, EnforceLimits) {
+    RequestParser::Limits limits{.max_request_line = 32, .max_header_bytes = 128, .max_headers = 2, .max_body = 10};
+    auto status_of = [&](std::string_view data) {
+        RequestParser parser{limits};
+        Request req;
+        auto result = parser.parse(data, req);
+        return result == RequestParser::Result::Error ? parser.error_status() : 0;
+    };
+
+    // 即使还没有收到行尾也要及时拒绝
+    EXPECT_EQ(status_of("GET /" + std::string(64, 'a')), 414);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nX: " + std::string(200, 'a')), 431);
+    EXPECT_EQ(status_of("GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n"), 431);
+    EXPECT_EQ(status_of("POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\n"), 413);
+    EXPECT_EQ(status_of("POST / HTTP/1.1\r\nContent-Length: 10\r\n\r\n"), 0);
+}
+
+TEST(RequestParserTest, StreamLargeAndChunkedBodies) {
+    RequestParser parser{{.max_buffered_body = 4}};
+    Request req;
+
+    // 小的正文照常缓冲
+    ASSERT_EQ(parser.parse("POST / HTTP/1.1\r\nContent-Length: 4\r\n\r\nabcd", req), RequestParser::Result::Complete);
+    EXPECT_FALSE(parser.body_streamed());
+    EXPECT_EQ(req.body, "abcd");
+
+    // 大的正文在头部结束时就完成，不等正文
+    std::string_view large = "POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nab";
+    parser.reset();
+    ASSERT_EQ(parser.parse(large, req), RequestParser::Result::Complete);
+    EXPECT_TRUE(parser.body_streamed());
+    EXPECT_EQ(req.content_length, 5u);
+    EXPECT_TRUE(req.body.empty());
+    EXPECT_EQ(parser.consumed(), large.size() - 2);
+
+    std::string_view chunked = "POST / HTTP/1.1\r\nTransfer-Encoding: Chunked\r\n\r\n";
+    parser.reset();
+    ASSERT_EQ(parser.parse(chunked, req), RequestParser::Result::Complete);
+    EXPECT_TRUE(parser.body_streamed());
+    EXPECT_TRUE(parser.chunked());
+    EXPECT_EQ(parser.consumed(), chunked.size());
+}
+
+TEST(HttpScanTest, KernelsMatchScalar) {
+    using namespace coro::net::tcp::http::detail;
+    auto original = scan_level();
+
+    // 每个字节值都放在每个位置上，覆盖 SIMD 主循环和标量尾部
+    std::string buffer(100, 'a');
+    for (auto level : {ScanLevel::Scalar, ScanLevel::Sse42, ScanLevel::Avx2}) {
+        auto actual = set_scan_level(level);
+        for (int c = 0; c < 256; ++c) {
+            bool control = (c < 0x20 && c != '\t') || c == 0x7f;
+            bool token = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                         std::string_view{"!#$%&'*+-.^_`|~"}.find(static_cast<char>(c)) != std::string_view::npos;
+            for (size_t pos = 0; pos < buffer.size(); pos += 7) {
+                buffer[pos] = static_cast<char>(c);
+                ASSERT_EQ(find_control(buffer), control ? pos : buffer.size())
+                    << to_string(actual) << " byte " << c << " at " << pos;
+                ASSERT_EQ(find_non_token(buffer), token ? buffer.size() : pos)
+                    << to_string(actual) << " byte " << c << " at " << pos;
+                buffer[pos] = 'a';
+            }
+        }
+    }
+    set_scan_level(original);
+}
+
+TEST(RouterTest, MatchStaticParamsAndWildcards) {
+    Router router;
+    router.add(Method::Get, "/", 0);
+    router.add(Method::Get, "/users", 1);
+    router.add(Method::Get, "/users/new", 2);
+    router.add(Method::Get, "/users/:id", 3);
+    router.add(Method::Put, "/users/:id", 4);
+    router.add(Method::Get, "/users/:id/posts/:post", 5);
+    router.add(Method::Get, "/static/*file", 6);
+    router.add(Method::Get, "/user", 7);
+    router.add(Method::Get, "/a:b", 8);  // 不在段首的 ':' 是普通字符
+    EXPECT_THROW(router.add(Method::Get, "/users/:id", 9), std::runtime_error);
+    EXPECT_THROW(router.add(Method::Get, "/users/:name/x", 9), std::runtime_error);
+    EXPECT_THROW(router.add(Method::Get, "/files/*path/x", 9), std::runtime_error);
+    EXPECT_THROW(router.add(Method::Get, "users", 9), std::runtime_error);
+    router.freeze();
+    EXPECT_THROW(router.add(Method::Get, "/late", 9), std::runtime_error);
+    EXPECT_EQ(router.size(), 9u);
+
+    auto match = [&](Method method, std::string_view path, PathParams& params) {
+        params.clear();
+        return router.match(method, path, params);
+    };
+    PathParams params;
+    auto found = [&](Method method, std::string_view path) -> int {
+        auto m = match(method, path, params);
+        return m.status == Router::Status::Found ? static_cast<int>(m.value) : -1;
+    };
+
+    EXPECT_EQ(found(Method::Get, "/"), 0);
+    EXPECT_EQ(found(Method::Get, "/users"), 1);
+    EXPECT_EQ(found(Method::Get, "/user"), 7);
+    EXPECT_EQ(found(Method::Get, "/a:b"), 8);
+    // 静态段优先于参数
+    EXPECT_EQ(found(Method::Get, "/users/new"), 2);
+    EXPECT_EQ(params.size(), 0u);
+    EXPECT_EQ(found(Method::Get, "/users/42"), 3);
+    EXPECT_EQ(params.get("id"), "42");
+    EXPECT_EQ(found(Method::Put, "/users/42"), 4);
+    // 从静态的 "new" 分支回溯到参数
+    EXPECT_EQ(found(Method::Get, "/users/new/posts/7"), 5);
+    EXPECT_EQ(params.get("id"), "new");
+    EXPECT_EQ(params.get("post"), "7");
+    EXPECT_EQ(found(Method::Get, "/static/css/site.css"), 6);
+    EXPECT_EQ(params.get("file"), "css/site.css");
+    EXPECT_EQ(found(Method::Get, "/static/"), 6);
+    EXPECT_EQ(params.get("file"), "");
+
+    // 参数不匹配空段，也不跨越 '/'
+    EXPECT_EQ(match(Method::Get, "/users/", params).status, Router::Status::NotFound);
+    EXPECT_EQ(match(Method::Get, "/users/42/posts", params).status, Router::Status::NotFound);
+    EXPECT_EQ(params.size(), 0u);
+    EXPECT_EQ(match(Method::Get, "/nothing", params).status, Router::Status::NotFound);
+    EXPECT_EQ(match(Method::Delete, "/users/42", params).status, Router::Status::MethodNotAllowed);
+    EXPECT_EQ(match(Method::Unknown, "/users", params).status, Router::Status::MethodNotAllowed);
+
+    // 参数指向传入的路径，不拷贝
+    std::string path = "/users/abc";
+    ASSERT_EQ(found(Method::Get, path), 3);
+    EXPECT_EQ(params.get("id")->data(), path.data() + 7);
+}
+
+namespace {
+    // 读到对端关闭为止
+    coro::Task<std::string> read_until_closed(coro::net::tcp::Client& client) {
+        std::string received;
+        char buffer[4096];
+        while (true) {
+            auto [status, data] = co_await client.read_some(buffer, std::chrono::milliseconds(1000));
+            if (status != coro::net::RecvStatus::Ok) {
+                co_return received;
+            }
+            received.append(data.data(), data.size());
+        }
+    }
+
+    size_t count(std::string_view haystack, std::string_view needle) {
+        size_t n{0};
+        for (auto pos = haystack.find(needle); pos != std::string_view::npos; pos = haystack.find(needle, pos + 1)) {
+            ++n;
+        }
+        return n;
+    }
+}
+
+TEST(HandlerTest, InlineStorageAndSyncFastPath) {
+    using namespace coro;
+    auto state = std::make_shared<int>(0);
+
+    // 小的可调用对象放在 Handler 内部，构造和移动都不分配
+    g_allocations = 0;
+    t_count_allocations = true;
+    Handler sync_handler{[state](Request&, Response& resp) {
+        ++*state;
+        resp.status_code = 204;
+    }};
+    Handler moved{std::move(sync_handler)};
+    t_count_allocations = false;
+    EXPECT_EQ(g_allocations.load(), 0u);
+    EXPECT_FALSE(sync_handler);
+    EXPECT_TRUE(moved.is_sync());
+    EXPECT_TRUE(moved.is_inline());
+
+    Request req;
+    Response resp;
+    moved.call_sync(req, resp);
+    EXPECT_EQ(resp.status_code, 204);
+    // 返回 void 的处理函数也可以当作协程调用
+    resp.status_code = 200;
+    sync_wait(moved(req, resp));
+    EXPECT_EQ(resp.status_code, 204);
+    EXPECT_EQ(*state, 2);
+
+    // 被移走的 Handler 为空，调用时和 std::function 一样抛出异常
+    EXPECT_FALSE(sync_handler.is_sync());
+    EXPECT_FALSE(sync_handler.is_inline());
+    EXPECT_THROW(sync_handler(req, resp), std::bad_function_call);
+
+    // 大的可调用对象放在堆上
+    std::array<char, Handler::inline_size + 1> big{'x'};
+    Handler async_handler{[state, big](Request&, Response& resp) -> Task<> {
+        resp.body.assign(big.data(), 1);
+        ++*state;
+        co_return;
+    }};
+    EXPECT_FALSE(async_handler.is_sync());
+    EXPECT_FALSE(async_handler.is_inline());
+    sync_wait(async_handler(req, resp));
+    EXPECT_EQ(resp.body, "x");
+    EXPECT_EQ(*state, 3);
+
+    // 赋值和析构释放原来的可调用对象
+    EXPECT_EQ(state.use_count(), 3);
+    moved = std::move(async_handler);
+    EXPECT_EQ(state.use_count(), 2);
+    moved = Handler{};
+    EXPECT_EQ(state.use_count(), 1);
+}
+
+TEST(ResponseTest, SerializeHead) {
+    EXPECT_EQ(reason_phrase(200), "OK");
+    EXPECT_EQ(reason_phrase(404), "Not Found");
+    EXPECT_EQ(reason_phrase(431), "Request Header Fields Too Large");
+    EXPECT_EQ(reason_phrase(299), "");
+    EXPECT_EQ(reason_phrase(42), "");
+
+    // 例如 "Sun, 06 Nov 1994 08:49:37 GMT"
+    auto date = http_date();
+    EXPECT_EQ(date.size(), 29u);
+    EXPECT_TRUE(date.ends_with(" GMT"));
+    EXPECT_EQ(http_date().data(), date.data());
+
+    Response resp;
+    resp.status_code = 404;
+    resp.headers["Content-Type"] = "text/plain";
+    resp.body = "missing";
+
+    std::string head;
+    head.reserve(1024);
+    auto buffer = head.data();
+    resp.write_head(head);
+    EXPECT_TRUE(head.starts_with("HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nDate: "));
+    EXPECT_TRUE(head.ends_with("\r\nContent-Length: 7\r\n\r\n"));
+    EXPECT_EQ(resp.to_string(), head + "missing");
+
+    // 复用缓冲区时不重新分配
+    head.clear();
+    resp.headers["Date"] = "Thu, 01 Jan 1970 00:00:00 GMT";
+    resp.write_head(head);
+    EXPECT_EQ(head.data(), buffer);
+    EXPECT_EQ(count(head, "Date: "), 1u);
+}
+
+TEST(HttpServerTest, PipeliningAndConnectionClose) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    // 由内核分配端口，同时运行的测试进程不会共用同一个 SO_REUSEPORT 端口
+    const auto port = server.port();
+    server.Get("/a", [](Request&, Response& resp) -> Task<> {
+        resp.body = "first";
+        co_return;
+    });
+    server.Get("/b", [scheduler](Request& req, Response& resp) -> Task<> {
+        // 处理函数挂起时，后面的流水线请求要等它完成
+        co_await scheduler->schedule_after(5ms);
+        resp.body = std::string{req.path};
+        co_return;
+    });
+    server.route(Method::Delete, "/items/:id", [](Request& req, Response& resp) -> Task<> {
+        resp.body = "deleted " + std::string{req.param("id").value_or("")};
+        co_return;
+    });
+    // 空的处理函数在注册时拒绝
+    EXPECT_THROW(server.Get("/empty", Handler{}), std::invalid_argument);
+    EXPECT_THROW(server.Get("/empty", Handler{}, nullptr), std::invalid_argument);
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        auto connect = [&]() -> Task<net::tcp::Client> {
+            net::tcp::Client client{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+            EXPECT_EQ(co_await client.connect(1000ms), net::ConnectStatus::Connected);
+            co_return client;
+        };
+
+        // 三个请求在同一个段里，最后一个要求关闭连接
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"GET /a HTTP/1.1\r\nHost: x\r\n\r\n"
+                                                  "GET /b HTTP/1.1\r\nHost: x\r\n\r\n"
+                                                  "GET /a HTTP/1.1\r\nConnection: close\r\n\r\n"
+                                                  "GET /b HTTP/1.1\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_EQ(count(received, "HTTP/1.1 200"), 3u);
+            auto first = received.find("first");
+            auto second = received.find("/b");
+            auto third = received.find("first", first + 1);
+            EXPECT_TRUE(first < second && second < third && third != std::string::npos) << received;
+            EXPECT_EQ(count(received, "Connection: close"), 1u);
+        }
+
+        // 一个请求分成两段到达；HTTP/1.0 默认不保持连接
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"GET /a HT"});
+            co_await scheduler->schedule_after(10ms);
+            co_await c.write_all(std::string_view{"TP/1.0\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_EQ(count(received, "HTTP/1.1 200"), 1u);
+            EXPECT_EQ(count(received, "Connection: close"), 1u);
+        }
+
+        // 路径参数、405 和 404
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"DELETE /items/17 HTTP/1.1\r\n\r\n"
+                                                  "GET /items/17 HTTP/1.1\r\n\r\n"
+                                                  "GET /missing HTTP/1.1\r\nConnection: close\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_NE(received.find("deleted 17"), std::string::npos) << received;
+            EXPECT_EQ(count(received, "HTTP/1.1 405"), 1u);
+            EXPECT_EQ(count(received, "HTTP/1.1 404"), 1u);
+        }
+
+        // HEAD 由 GET 路由处理，头部带正文的长度但不发送正文，之后的响应紧接着头部
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"HEAD /a HTTP/1.1\r\n\r\n"
+                                                  "HEAD /missing HTTP/1.1\r\n\r\n"
+                                                  "GET /a HTTP/1.1\r\nConnection: close\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            auto first_end = received.find("\r\n\r\n");
+            auto second_end = received.find("\r\n\r\n", first_end + 4);
+            EXPECT_TRUE(received.starts_with("HTTP/1.1 200")) << received;
+            EXPECT_NE(received.substr(0, first_end).find("Content-Length: 5"), std::string::npos) << received;
+            EXPECT_EQ(received.compare(first_end + 4, 12, "HTTP/1.1 404"), 0) << received;
+            EXPECT_EQ(received.compare(second_end + 4, 12, "HTTP/1.1 200"), 0) << received;
+            EXPECT_EQ(count(received, "Not Found"), 1u) << received;
+            EXPECT_EQ(count(received, "first"), 1u);
+            EXPECT_TRUE(received.ends_with("\r\n\r\nfirst")) << received;
+        }
+
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
+
+namespace {
+    // 测试用的临时目录，结束时删除
+    struct TempDir {
+        std::filesystem::path path;
+
+        TempDir() {
+            path = std::filesystem::temp_directory_path() / ("coro_static_" + std::to_string(::getpid()));
+            std::filesystem::create_directories(path / "css");
+        }
+        ~TempDir() { std::filesystem::remove_all(path); }
+
+        void write(const std::string& name, const std::string& content) const {
+            // 先写临时文件再改名，和部署时替换文件的方式一样
+            auto tmp = path / (name + ".tmp");
+            std::ofstream{tmp, std::ios::binary} << content;
+            std::filesystem::rename(tmp, path / name);
+        }
+    };
+
+    Request make_request(std::vector<Header> headers = {}) {
+        Request req;
+        req.method = "GET";
+        req.version = "HTTP/1.1";
+        req.headers.assign(headers.begin(), headers.end());
+        return req;
+    }
+}
+
+TEST(StaticFilesTest, RangesEtagsAndInvalidation) {
+    TempDir dir;
+    dir.write("css/site.css", "0123456789");
+    dir.write("index.html", "<html></html>");
+    StaticFiles files{{.root = dir.path.string(), .max_open_files = 1}};
+
+    Response resp;
+    files.serve("css/site.css", make_request(), resp);
+    ASSERT_EQ(resp.status_code, 200);
+    ASSERT_TRUE(resp.file.has_value());
+    EXPECT_EQ(resp.file->offset, 0);
+    EXPECT_EQ(resp.file->length, 10u);
+    EXPECT_EQ(resp.headers["Content-Type"], "text/css; charset=utf-8");
+    auto etag = resp.headers["ETag"];
+    EXPECT_EQ(files.cached(), 1u);
+
+    auto serve = [&](std::string_view path, std::vector<Header> headers) {
+        Response r;
+        files.serve(path, make_request(std::move(headers)), r);
+        return r;
+    };
+
+    auto not_modified = serve("css/site.css", {{"If-None-Match", "\"x\", W/" + etag}});
+    EXPECT_EQ(not_modified.status_code, 304);
+    EXPECT_FALSE(not_modified.file.has_value());
+    EXPECT_EQ(not_modified.to_string().find("Content-Length"), std::string::npos);
+
+    auto partial = serve("css/site.css", {{"Range", "bytes=2-4"}});
+    EXPECT_EQ(partial.status_code, 206);
+    EXPECT_EQ(partial.headers["Content-Range"], "bytes 2-4/10");
+    EXPECT_EQ(partial.file->offset, 2);
+    EXPECT_EQ(partial.file->length, 3u);
+    auto suffix = serve("css/site.css", {{"Range", "bytes=-3"}});
+    EXPECT_EQ(suffix.headers["Content-Range"], "bytes 7-9/10");
+    EXPECT_EQ(serve("css/site.css", {{"Range", "bytes=10-"}}).status_code, 416);
+    EXPECT_EQ(serve("css/site.css", {{"Range", "bytes=0-1,4-5"}}).status_code, 200);
+    EXPECT_EQ(serve("css/site.css", {{"Range", "bytes=2-4"}, {"If-Range", "\"old\""}}).status_code, 200);
+
+    // 替换文件后缓存失效，ETag 随之改变
+    dir.write("css/site.css", "changed");
+    auto changed = serve("css/site.css", {{"If-None-Match", etag}});
+    EXPECT_EQ(changed.status_code, 200);
+    EXPECT_EQ(changed.file->length, 7u);
+    EXPECT_NE(changed.headers["ETag"], etag);
+
+    // 只缓存 1 个文件，旧的被淘汰，正在使用它的响应仍然持有 fd
+    EXPECT_EQ(serve("", {}).file->length, 13u);
+    EXPECT_EQ(files.cached(), 1u);
+    EXPECT_GE(::fcntl(changed.file->fd, F_GETFD), 0);
+
+    EXPECT_EQ(serve("css/missing.css", {}).status_code, 404);
+    EXPECT_EQ(serve("../etc/passwd", {}).status_code, 404);
+    EXPECT_EQ(serve("css/%2e%2e/%2e%2e/etc/passwd", {}).status_code, 404);
+    EXPECT_EQ(serve("css", {}).status_code, 404);
+    EXPECT_EQ(serve("/css/site%2Ecss", {}).status_code, 200);
+
+    // 根目录中指向外面的符号链接不跟随
+    auto outside = dir.path.string() + "_outside";
+    std::filesystem::create_directories(outside);
+    std::ofstream{outside + "/secret.txt"} << "secret";
+    std::filesystem::create_symlink(outside + "/secret.txt", dir.path / "leak.txt");
+    std::filesystem::create_symlink("../../" + dir.path.filename().string() + "_outside/secret.txt",
+                                    dir.path / "css" / "up.txt");
+    std::filesystem::create_directory_symlink(outside, dir.path / "linked");
+    EXPECT_EQ(serve("leak.txt", {}).status_code, 404);
+    EXPECT_EQ(serve("css/up.txt", {}).status_code, 404);
+    EXPECT_EQ(serve("linked/secret.txt", {}).status_code, 404);
+    std::filesystem::remove_all(outside);
+}
+
+TEST(HttpServerTest, ServeStaticWithSendfile) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+
+    TempDir dir;
+    // 比 socket 发送缓冲区大，sendfile 需要等待可写
+    std::string content(4 * 1024 * 1024, '\0');
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    dir.write("big.bin", content);
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    const auto port = server.port();
+    server.serve_static("/assets/", {.root = dir.path.string()});
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        net::tcp::Client c{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+        EXPECT_EQ(co_await c.connect(1000ms), net::ConnectStatus::Connected);
+        co_await c.write_all(std::string_view{"GET /assets/big.bin HTTP/1.1\r\n\r\n"
+                                              "GET /assets/big.bin HTTP/1.1\r\nRange: bytes=26-51\r\n"
+                                              "Connection: close\r\n\r\n"});
+        auto received = co_await read_until_closed(c);
+        auto body = received.find("\r\n\r\n");
+        EXPECT_NE(body, std::string::npos);
+        if (body == std::string::npos) {
+            server.stop();
+            co_return;
+        }
+        EXPECT_NE(received.find("Content-Length: 4194304\r\n"), std::string::npos);
+        EXPECT_EQ(received.compare(body + 4, content.size(), content), 0);
+        auto second = received.substr(body + 4 + content.size());
+        EXPECT_TRUE(second.starts_with("HTTP/1.1 206 Partial Content\r\n")) << second.substr(0, 100);
+        EXPECT_TRUE(second.ends_with("\r\n\r\nabcdefghijklmnopqrstuvwxyz"));
+
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
+
+namespace {
+    // 解码 chunked 正文，格式错误时返回 nullopt
+    std::optional<std::string> decode_chunked(std::string_view data) {
+        std::string out;
+        while (true) {
+            auto line_end = data.find("\r\n");
+            if (line_end == std::string_view::npos) {
+                return std::nullopt;
+            }
+            auto size = std::stoul(std::string{data.substr(0, line_end)}, nullptr, 16);
+            data.remove_prefix(line_end + 2);
+            if (size == 0) {
+                return data == "\r\n" ? std::optional{out} : std::nullopt;
+            }
+            if (data.size() < size + 2 || data.substr(size, 2) != "\r\n") {
+                return std::nullopt;
+            }
+            out.append(data.substr(0, size));
+            data.remove_prefix(size + 2);
+        }
+    }
+}
+
+TEST(HttpServerTest, StreamingChunkedResponse) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+    constexpr size_t chunk_size = 64 * 1024;
+    constexpr size_t chunk_count = 128;
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    const auto port = server.port();
+    server.Get("/events", [scheduler](Request& req, Response& resp) -> Task<> {
+        resp.headers["Content-Type"] = "text/event-stream";
+        resp.stream = [scheduler, &req](ResponseWriter& writer) -> Task<> {
+            for (int i = 0; i < 3; ++i) {
+                co_await writer.write("data: " + std::to_string(i) + " " + std::string{req.path} + "\n\n");
+                co_await scheduler->schedule_after(2ms);
+            }
+        };
+        co_return;
+    });
+    // 8 MiB 的正文复用同一个 64 KiB 的缓冲区，每块都要等到发送出去才继续
+    server.Get("/export", [](Request&, Response& resp) -> Task<> {
+        resp.stream = [](ResponseWriter& writer) -> Task<> {
+            std::string buffer(chunk_size, '\0');
+            for (size_t i = 0; i < chunk_count; ++i) {
+                std::fill(buffer.begin(), buffer.end(), static_cast<char>('a' + i % 26));
+                if (!co_await writer.write(buffer)) {
+                    co_return;
+                }
+            }
+            EXPECT_EQ(writer.bytes_written(), chunk_size * chunk_count);
+        };
+        co_return;
+    });
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        auto connect = [&]() -> Task<net::tcp::Client> {
+            net::tcp::Client client{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+            EXPECT_EQ(co_await client.connect(1000ms), net::ConnectStatus::Connected);
+            co_return client;
+        };
+
+        // 流式响应和之后的流水线请求按顺序返回
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"GET /events HTTP/1.1\r\n\r\n"
+                                                  "GET /export HTTP/1.1\r\nConnection: close\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            auto first = received.find("\r\n\r\n");
+            auto second = received.find("HTTP/1.1 200", first);
+            auto second_body = received.find("\r\n\r\n", second);
+            EXPECT_NE(second_body, std::string::npos);
+            if (second_body != std::string::npos) {
+                EXPECT_EQ(count(received.substr(0, second), "Transfer-Encoding: chunked"), 1u);
+                EXPECT_EQ(received.substr(0, second).find("Content-Length"), std::string::npos);
+                EXPECT_EQ(decode_chunked(received.substr(first + 4, second - first - 4)),
+                          "data: 0 /events\n\ndata: 1 /events\n\ndata: 2 /events\n\n");
+                auto exported = decode_chunked(received.substr(second_body + 4));
+                EXPECT_TRUE(exported.has_value());
+                if (exported) {
+                    EXPECT_EQ(exported->size(), chunk_size * chunk_count);
+                    EXPECT_EQ((*exported)[chunk_size * 27], 'b');
+                }
+            }
+        }
+
+        // HTTP/1.0 不使用 chunked，正文由关闭连接结束
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"GET /events HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_EQ(received.find("Transfer-Encoding"), std::string::npos);
+            EXPECT_NE(received.find("Connection: close\r\n"), std::string::npos);
+            EXPECT_TRUE(received.ends_with("\r\n\r\ndata: 0 /events\n\ndata: 1 /events\n\ndata: 2 /events\n\n"));
+        }
+
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
+
+TEST(HttpServerTest, StreamingRequestBodies) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    const auto port = server.port();
+    // 逐段读取正文，回复长度和字节和
+    size_t largest_piece{0};
+    server.Post("/upload", [&](Request& req, Response& resp) -> Task<> {
+        size_t sum{0};
+        while (true) {
+            auto piece = co_await req.body_reader->read();
+            if (piece.empty()) {
+                break;
+            }
+            largest_piece = std::max(largest_piece, piece.size());
+            for (char c : piece) {
+                sum += static_cast<unsigned char>(c);
+            }
+        }
+        if (req.body_reader->failed()) {
+            co_return;
+        }
+        resp.body = std::to_string(req.body_reader->bytes_read()) + ":" + std::to_string(sum);
+    });
+    server.Post("/ignore", [](Request&, Response& resp) -> Task<> {
+        resp.body = "ignored";
+        co_return;
+    });
+    server.Get("/a", [](Request&, Response& resp) -> Task<> {
+        resp.body = "first";
+        co_return;
+    });
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        auto connect = [&]() -> Task<net::tcp::Client> {
+            net::tcp::Client client{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+            EXPECT_EQ(co_await client.connect(1000ms), net::ConnectStatus::Connected);
+            co_return client;
+        };
+        auto expected = [](size_t size) {
+            size_t sum{0};
+            for (size_t i = 0; i < size; ++i) {
+                sum += static_cast<unsigned char>('a' + i % 26);
+            }
+            return std::to_string(size) + ":" + std::to_string(sum);
+        };
+        std::string upload(3 * 1024 * 1024, '\0');
+        for (size_t i = 0; i < upload.size(); ++i) {
+            upload[i] = static_cast<char>('a' + i % 26);
+        }
+
+        // 3 MiB 的 Content-Length 正文，之后是流水线请求
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"POST /upload HTTP/1.1\r\nContent-Length: 3145728\r\n\r\n"});
+            co_await c.write_all(std::string_view{upload});
+            co_await c.write_all(std::string_view{"GET /a HTTP/1.1\r\nConnection: close\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_NE(received.find("\r\n\r\n" + expected(upload.size()) + "HTTP/1.1 200"), std::string::npos);
+            EXPECT_TRUE(received.ends_with("first"));
+            EXPECT_LE(largest_piece, 64u * 1024);
+        }
+
+        // chunked 正文：chunk 被读取边界切开、带扩展和 trailer
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                                  "3;ext=1\r\nabc\r\n1"});
+            co_await scheduler->schedule_after(5ms);
+            co_await c.write_all(std::string_view{"7\r\ndefghijklmnopqrstuvwxyz\r\n0\r\nX-Trailer: 1\r\n\r\n"
+                                                  "POST /ignore HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                                  "5\r\nhello\r\n0\r\n\r\n"
+                                                  "GET /a HTTP/1.1\r\nConnection: close\r\n\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_NE(received.find("\r\n\r\n" + expected(26) + "HTTP/1.1 200"), std::string::npos) << received;
+            EXPECT_NE(received.find("\r\n\r\nignoredHTTP/1.1 200"), std::string::npos);
+            EXPECT_TRUE(received.ends_with("first"));
+        }
+
+        // Expect: 100-continue：等到 100 Continue 才发送正文
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"POST /upload HTTP/1.1\r\nExpect: 100-continue\r\n"
+                                                  "Content-Length: 100000\r\nConnection: close\r\n\r\n"});
+            char buffer[64];
+            auto [status, data] = co_await c.read_some(buffer, 1000ms);
+            EXPECT_EQ(std::string_view(data.data(), data.size()), "HTTP/1.1 100 Continue\r\n\r\n");
+            co_await c.write_all(std::string_view{upload}.substr(0, 100000));
+            auto received = co_await read_until_closed(c);
+            EXPECT_TRUE(received.ends_with("\r\n\r\n" + expected(100000))) << received;
+        }
+
+        // 编码错误的 chunked 正文
+        {
+            auto c = co_await connect();
+            co_await c.write_all(std::string_view{"POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                                  "zz\r\n"});
+            auto received = co_await read_until_closed(c);
+            EXPECT_TRUE(received.starts_with("HTTP/1.1 400 Bad Request\r\n")) << received;
+        }
+
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
+
+TEST(HttpServerTest, SteadyStateRequestsDoNotAllocate) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+    constexpr size_t pipeline_depth = 8;
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    const auto port = server.port();
+    // 头部的名字和值都超过 SSO 的长度，必须从连接的内存池分配
+    server.Get("/hello/:name", [](Request& req, Response& resp) -> Task<> {
+        resp.headers.emplace("Content-Type", "text/plain; charset=utf-8");
+        resp.headers.emplace("X-Request-Path-Parameter", req.param("name").value_or(""));
+        resp.body = "hello, ";
+        resp.body.append(req.param("name").value_or(""));
+        resp.body.append(std::string_view{" -- a body longer than the small string buffer"});
+        co_return;
+    });
+
+    // 所有响应的长度相同（Date 的长度固定）
+    Response expected;
+    expected.headers.emplace("Content-Type", "text/plain; charset=utf-8");
+    expected.headers.emplace("X-Request-Path-Parameter", "someone-with-a-long-name");
+    expected.body = "hello, someone-with-a-long-name -- a body longer than the small string buffer";
+    auto response_size = expected.to_string().size();
+
+    std::string batch;
+    for (size_t i = 0; i < pipeline_depth; ++i) {
+        batch += "GET /hello/someone-with-a-long-name HTTP/1.1\r\nHost: localhost\r\n"
+                 "User-Agent: test-client/1.0\r\nAccept: */*\r\n\r\n";
+    }
+    std::string received(response_size * pipeline_depth, '\0');
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        net::tcp::Client c{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+        EXPECT_EQ(co_await c.connect(1000ms), net::ConnectStatus::Connected);
+
+        auto round = [&]() -> Task<bool> {
+            auto [wstatus, sent] = co_await c.write_all(batch, 1000ms);
+            auto [rstatus, size] = co_await c.read_exact(received, 1000ms);
+            co_return wstatus == net::SendStatus::Ok && rstatus == net::RecvStatus::Ok;
+        };
+
+        // 预热：连接的缓冲区、协程帧池、解析器和 Request 的头部数组达到稳定的容量
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_TRUE(co_await round());
+        }
+        EXPECT_TRUE(received.starts_with("HTTP/1.1 200 OK\r\n")) << received.substr(0, 200);
+        EXPECT_NE(received.find("hello, someone-with-a-long-name"), std::string::npos);
+
+        g_allocations = 0;
+        t_count_allocations = true;
+        bool ok{true};
+        for (int i = 0; i < 100 && ok; ++i) {
+            ok = co_await round();
+        }
+        t_count_allocations = false;
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(g_allocations.load(), 0u);
+
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
+
+TEST(HttpServerTest, PerRouteConcurrencyLimit) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    const auto port = server.port();
+    int running{0};
+    int max_running{0};
+    auto slow = [&](Request& req, Response& resp) -> Task<> {
+        max_running = std::max(max_running, ++running);
+        co_await scheduler->schedule_after(50ms);
+        --running;
+        resp.body = std::string{req.path};
+    };
+    // 超过上限直接拒绝
+    server.route(Method::Get, "/reject", slow, {.max_concurrent = 1});
+    // 超过上限排队等待
+    server.route(Method::Get, "/queue", slow, {.max_concurrent = 2, .queue_timeout = 1000ms});
+
+    auto request = [&](std::string path, std::chrono::milliseconds delay) -> Task<std::string> {
+        co_await scheduler->schedule_after(delay);
+        net::tcp::Client c{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+        EXPECT_EQ(co_await c.connect(1000ms), net::ConnectStatus::Connected);
+        co_await c.write_all("GET " + path + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        co_return co_await read_until_closed(c);
+    };
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        auto [first, second] = co_await when_all(request("/reject", 0ms), request("/reject", 10ms));
+        EXPECT_TRUE(first.starts_with("HTTP/1.1 200")) << first;
+        EXPECT_TRUE(second.starts_with("HTTP/1.1 503")) << second;
+
+        max_running = 0;
+        std::vector<Task<std::string>> queued;
+        for (int i = 0; i < 5; ++i) {
+            queued.push_back(request("/queue", 0ms));
+        }
+        auto responses = co_await when_all(std::move(queued));
+        for (auto& response : responses) {
+            EXPECT_TRUE(response.starts_with("HTTP/1.1 200")) << response;
+        }
+        EXPECT_EQ(max_running, 2);
+
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
+
+TEST(HttpServerTest, ResponseCacheForGetRoutes) {
+    using namespace coro;
+    using namespace std::chrono_literals;
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    HttpServer server{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = 0}};
+    const auto port = server.port();
+    auto cache = std::make_shared<ResponseCache>(
+            scheduler, ResponseCache::Options{.ttl = 10s, .vary_headers = {"Accept-Language"}});
+    int greetings{0};
+    int misses{0};
+    server.Get("/greeting", [&](Request& req, Response& resp) -> Task<> {
+        ++greetings;
+        co_await scheduler->schedule_after(30ms);
+        resp.headers["Content-Type"] = "text/plain";
+        resp.body = "hello " + std::string{req.header("Accept-Language").value_or("?")};
+    }, cache);
+    // 非 200 的响应不缓存
+    server.Get("/missing", [&](Request&, Response& resp) {
+        ++misses;
+        resp.status_code = 404;
+    }, cache);
+
+    auto request = [&](std::string path, std::string language) -> Task<std::string> {
+        net::tcp::Client c{scheduler, {.address = net::IpAddress::from_string("127.0.0.1"), .port = port}};
+        EXPECT_EQ(co_await c.connect(1000ms), net::ConnectStatus::Connected);
+        co_await c.write_all("GET " + path + " HTTP/1.1\r\nAccept-Language: " + language +
+                             "\r\nConnection: close\r\n\r\n");
+        co_return co_await read_until_closed(c);
+    };
+
+    auto client = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        // 同时到达的未命中只调用一次处理函数
+        std::vector<Task<std::string>> concurrent;
+        for (int i = 0; i < 3; ++i) {
+            concurrent.push_back(request("/greeting", "en"));
+        }
+        concurrent.push_back(request("/greeting", "fr"));
+        auto responses = co_await when_all(std::move(concurrent));
+        EXPECT_EQ(greetings, 2);
+        int hits{0};
+        for (auto& response : responses) {
+            EXPECT_TRUE(response.starts_with("HTTP/1.1 200")) << response;
+            EXPECT_NE(response.find("Content-Type: text/plain"), std::string::npos) << response;
+            hits += response.find("X-Cache: HIT") != std::string::npos;
+        }
+        EXPECT_EQ(hits, 2);
+        EXPECT_TRUE(responses[0].ends_with("hello en"));
+        EXPECT_TRUE(responses[3].ends_with("hello fr"));
+
+        auto cached = co_await request("/greeting", "fr");
+        EXPECT_TRUE(cached.ends_with("hello fr")) << cached;
+        EXPECT_NE(cached.find("X-Cache: HIT"), std::string::npos);
+        EXPECT_EQ(greetings, 2);
+
+        auto [first, second] = co_await when_all(request("/missing", "en"), request("/missing", "en"));
+        EXPECT_TRUE(first.starts_with("HTTP/1.1 404")) << first;
+        EXPECT_TRUE(second.starts_with("HTTP/1.1 404")) << second;
+        EXPECT_EQ(misses, 2);
+
+        auto stats = cache->stats();
+        EXPECT_EQ(stats.hits, 1u);
+        EXPECT_EQ(stats.loads, 4u);
+        server.stop();
+    };
+
+    sync_wait(when_all(server.start(), client()));
+}
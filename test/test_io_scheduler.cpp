@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace coro;
+using namespace std::chrono_literals;
+
+namespace {
+    // 参数化的用例在两种后端上各运行一次；内核不支持 io_uring 时跳过 IoUring 的那一次
+    class IoSchedulerBackendTest : public ::testing::TestWithParam<IoScheduler::IoBackend> {
+    protected:
+        void SetUp() override {
+            if (make_scheduler(io_exec_thread_inline, 1)->backend() != GetParam()) {
+                GTEST_SKIP() << "io_uring is unavailable, the scheduler fell back to epoll";
+            }
+        }
+
+        std::shared_ptr<IoScheduler> make_scheduler(IoScheduler::ExecutionStrategy strategy,
+                                                    std::size_t threads) const {
+            return IoScheduler::make_shared({strategy, threads, ThreadPool::QueueStrategy::WorkStealing, GetParam()});
+        }
+    };
+
+    std::string backend_name(const ::testing::TestParamInfo<IoScheduler::IoBackend>& info) {
+        return info.param == IoScheduler::IoBackend::IoUring ? "IoUring" : "Epoll";
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, IoSchedulerBackendTest,
+                         ::testing::Values(IoScheduler::IoBackend::Epoll, IoScheduler::IoBackend::IoUring),
+                         backend_name);
+
+TEST_P(IoSchedulerBackendTest, PollTimeoutThenEvent) {
+    auto scheduler = make_scheduler(io_exec_thread_pool, 2);
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds), 0);
+
+    // IoUring 后端：POLL_ADD / RECV 和 LINK_TIMEOUT 一起提交，超时取消时返回 -ETIMEDOUT
+    auto func = [](std::shared_ptr<IoScheduler> scheduler, int read_fd, int write_fd) -> Task<int> {
+        co_await scheduler->schedule();
+        EXPECT_EQ(co_await scheduler->poll(read_fd, PollOp::Read, 20ms), PollStatus::Timeout);
+
+        EXPECT_EQ(::write(write_fd, "abc", 3), 3);
+        EXPECT_EQ(co_await scheduler->poll(read_fd, PollOp::Read, 1000ms), PollStatus::Event);
+        char buffer[8];
+        EXPECT_EQ(co_await scheduler->recv(read_fd, buffer, 1000ms), 3);
+
+        auto n = co_await scheduler->recv(read_fd, buffer, 20ms);
+        EXPECT_EQ(n, -ETIMEDOUT);
+
+        // 对端关闭
+        ::shutdown(write_fd, SHUT_WR);
+        EXPECT_EQ(co_await scheduler->recv(read_fd, buffer, 1000ms), 0);
+        co_return n;
+    };
+
+    EXPECT_EQ(sync_wait(func(scheduler, fds[0], fds[1])), -ETIMEDOUT);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_P(IoSchedulerBackendTest, ScheduleAfterAndAt) {
+    auto scheduler = make_scheduler(io_exec_thread_pool, 2);
+    // 同时等待的定时器比 io_uring 的队列（4096 项）多
+    constexpr int timers = 6000;
+    std::atomic<int> early{0};
+
+    auto sleeper = [&](int i) -> Task<> {
+        co_await scheduler->schedule();
+        auto start = IoScheduler::clock::now();
+        auto amount = std::chrono::milliseconds{5 + i % 20};
+        if (i % 2 == 0) {
+            co_await scheduler->schedule_after(amount);
+        } else {
+            co_await scheduler->schedule_at(start + amount);
+        }
+        // 定时器按 1ms 的 tick 到期，schedule_at 的时间截断到毫秒，最多提前一个 tick
+        if (IoScheduler::clock::now() - start + 1ms < amount) {
+            early.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < timers; ++i) {
+        tasks.push_back(sleeper(i));
+    }
+    sync_wait(when_all(std::move(tasks)));
+    EXPECT_EQ(early.load(), 0);
+}
+
+TEST_P(IoSchedulerBackendTest, RegisteredPollTimeoutThenEvent) {
+    auto scheduler = make_scheduler(io_exec_thread_pool, 2);
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds), 0);
+
+    auto func = [](std::shared_ptr<IoScheduler> scheduler, int read_fd, int write_fd) -> Task<int> {
+        co_await scheduler->schedule();
+        auto registration = scheduler->register_fd(read_fd);
+
+        auto status = co_await scheduler->poll(*registration, PollOp::Read, 20ms);
+        EXPECT_EQ(status, PollStatus::Timeout);
+
+        EXPECT_EQ(::write(write_fd, "abc", 3), 3);
+        char buffer[8];
+        auto n = co_await scheduler->recv(*registration, buffer, 1000ms);
+        EXPECT_EQ(n, 3);
+
+        // 数据已经读完，recv 遇到 EAGAIN 后清除就绪状态并等待到超时
+        n = co_await scheduler->recv(*registration, buffer, 20ms);
+        EXPECT_EQ(n, -ETIMEDOUT);
+        co_return n;
+    };
+
+    EXPECT_EQ(sync_wait(func(scheduler, fds[0], fds[1])), -ETIMEDOUT);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_P(IoSchedulerBackendTest, RegisteredRecvWakesOnWrite) {
+    // 常驻注册不使用 io_uring，但写端的 schedule_after 使用
+    auto scheduler = make_scheduler(io_exec_thread_inline, 1);
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds), 0);
+
+    auto reader = [](std::shared_ptr<IoScheduler> scheduler, int fd) -> Task<int> {
+        co_await scheduler->schedule();
+        auto registration = scheduler->register_fd(fd);
+        int total{0};
+        char buffer[16];
+        while (total < 10) {
+            auto n = co_await scheduler->recv(*registration, buffer, 1000ms);
+            if (n <= 0) {
+                co_return n;
+            }
+            total += n;
+        }
+        co_return total;
+    };
+    auto writer = [](std::shared_ptr<IoScheduler> scheduler, int fd) -> Task<int> {
+        for (int i = 0; i < 10; ++i) {
+            co_await scheduler->schedule_after(2ms);
+            EXPECT_EQ(::write(fd, "x", 1), 1);
+        }
+        co_return 10;
+    };
+
+    auto [received, written] = sync_wait(when_all(reader(scheduler, fds[0]), writer(scheduler, fds[1])));
+    EXPECT_EQ(received, 10);
+    EXPECT_EQ(written, 10);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(IoSchedulerTest, IoUringFallsBackToEpoll) {
+    // 只留出 scheduler 自己的 4 个 fd，io_uring_setup 因为 EMFILE 失败
+    int probe[5];
+    for (auto& fd : probe) {
+        fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        ASSERT_GE(fd, 0);
+    }
+    for (auto fd : probe) {
+        ::close(fd);
+    }
+    rlimit saved{};
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &saved), 0);
+    rlimit limited{static_cast<rlim_t>(probe[4]), saved.rlim_max};
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limited), 0);
+    std::shared_ptr<IoScheduler> scheduler;
+    try {
+        scheduler = IoScheduler::make_shared({io_exec_thread_pool, 2, ThreadPool::QueueStrategy::WorkStealing,
+                                              IoScheduler::IoBackend::IoUring});
+    } catch (...) {
+        setrlimit(RLIMIT_NOFILE, &saved);
+        throw;
+    }
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &saved), 0);
+    EXPECT_EQ(scheduler->backend(), IoScheduler::IoBackend::Epoll);
+
+    // 退回的 epoll 调度器可以正常使用
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds), 0);
+    auto func = [](std::shared_ptr<IoScheduler> scheduler, int read_fd, int write_fd) -> Task<int> {
+        co_await scheduler->schedule_after(5ms);
+        EXPECT_EQ(co_await scheduler->poll(read_fd, PollOp::Read, 10ms), PollStatus::Timeout);
+        EXPECT_EQ(::write(write_fd, "x", 1), 1);
+        char buffer[4];
+        co_return co_await scheduler->recv(read_fd, buffer, 1000ms);
+    };
+    EXPECT_EQ(sync_wait(func(scheduler, fds[0], fds[1])), 1);
+    close(fds[0]);
+    close(fds[1]);
+}
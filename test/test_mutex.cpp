@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <deque>
+#include <vector>
+
+using namespace coro;
+
+TEST(MutexTest, WaitersResumeInArrivalOrder) {
+    Mutex mutex;
+    std::vector<int> order;
+
+    auto waiter = [](Mutex& mutex, std::vector<int>& order, int id) -> Task<> {
+        auto lock = co_await mutex.scoped_lock();
+        order.push_back(id);
+    };
+
+    ASSERT_TRUE(mutex.try_lock());
+    EXPECT_FALSE(mutex.try_lock());
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(waiter(mutex, order, i));
+        tasks.back().resume();
+    }
+    EXPECT_TRUE(order.empty());
+
+    // 没有执行器时在解锁的线程上依次恢复，每个等待者解锁时把锁交给下一个
+    mutex.unlock();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    for (auto& task : tasks) {
+        EXPECT_TRUE(task.done());
+    }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(MutexTest, ContendedOnThreadPool) {
+    ThreadPool tp{4};
+    Mutex mutex{tp};
+    std::size_t counter{0};
+
+    // 临界区中让出，持有锁跨越挂起
+    auto func = [](ThreadPool& tp, Mutex& mutex, std::size_t& counter) -> Task<> {
+        co_await tp.schedule();
+        for (int i = 0; i < 100; ++i) {
+            auto lock = co_await mutex.scoped_lock();
+            auto value = counter;
+            if (i % 10 == 0) {
+                co_await tp.yield();
+            }
+            counter = value + 1;
+        }
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 100; ++i) {
+        tasks.emplace_back(func(tp, mutex, counter));
+    }
+    sync_wait(when_all(std::move(tasks)));
+    EXPECT_EQ(counter, 10000u);
+}
+
+TEST(MutexTest, ContendedOnIoScheduler) {
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_pool, 4, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    Mutex mutex{scheduler};
+    std::size_t counter{0};
+
+    auto func = [](std::shared_ptr<IoScheduler> scheduler, Mutex& mutex, std::size_t& counter) -> Task<> {
+        co_await scheduler->schedule();
+        for (int i = 0; i < 100; ++i) {
+            co_await mutex.lock();
+            ++counter;
+            mutex.unlock();
+        }
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 50; ++i) {
+        tasks.emplace_back(func(scheduler, mutex, counter));
+    }
+    sync_wait(when_all(std::move(tasks)));
+    EXPECT_EQ(counter, 5000u);
+}
+
+TEST(ConditionVariableTest, ProducersAndConsumers) {
+    ThreadPool tp{4};
+    Mutex mutex{tp};
+    ConditionVariable cv;
+    std::deque<int> queue;
+    bool closed{false};
+    std::atomic<long> sum{0};
+
+    auto consumer = [&]() -> Task<> {
+        co_await tp.schedule();
+        while (true) {
+            auto lock = co_await mutex.scoped_lock();
+            co_await cv.wait(lock, [&] { return !queue.empty() || closed; });
+            if (queue.empty()) {
+                co_return;
+            }
+            auto value = queue.front();
+            queue.pop_front();
+            lock.unlock();
+            sum.fetch_add(value, std::memory_order_relaxed);
+        }
+    };
+    auto producer = [&](int base) -> Task<> {
+        co_await tp.schedule();
+        for (int i = 1; i <= 1000; ++i) {
+            auto lock = co_await mutex.scoped_lock();
+            queue.push_back(base + i);
+            lock.unlock();
+            cv.notify_one();
+        }
+    };
+
+    std::vector<Task<>> producers;
+    for (int i = 0; i < 4; ++i) {
+        producers.emplace_back(producer(i * 1000));
+    }
+    auto close = [&]() -> Task<> {
+        co_await when_all(std::move(producers));
+        auto lock = co_await mutex.scoped_lock();
+        closed = true;
+        cv.notify_all();
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 8; ++i) {
+        tasks.emplace_back(consumer());
+    }
+    tasks.emplace_back(close());
+    sync_wait(when_all(std::move(tasks)));
+    // 4 个生产者各自 base + 1 .. base + 1000
+    EXPECT_EQ(sum.load(), 4 * 500500 + 1000 * (0 + 1000 + 2000 + 3000));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(ConditionVariableTest, NotifyAllWakesEveryWaiter) {
+    Mutex mutex;
+    ConditionVariable cv;
+    bool ready{false};
+    int woken{0};
+
+    auto waiter = [&]() -> Task<> {
+        auto lock = co_await mutex.scoped_lock();
+        co_await cv.wait(lock, [&] { return ready; });
+        ++woken;
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 5; ++i) {
+        tasks.push_back(waiter());
+        tasks.back().resume();
+    }
+    // 所有等待者都已经在 wait 中释放了锁
+    ASSERT_TRUE(mutex.try_lock());
+    cv.notify_one();
+    EXPECT_EQ(woken, 0);
+    ready = true;
+    mutex.unlock();
+    // notify_one 唤醒的等待者在解锁时取得锁，看到 ready 后结束
+    EXPECT_EQ(woken, 1);
+
+    cv.notify_all();
+    EXPECT_EQ(woken, 5);
+    for (auto& task : tasks) {
+        EXPECT_TRUE(task.done());
+    }
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace coro;
+using namespace std::chrono_literals;
+
+TEST(SemaphoreTest, FastPathAndFifoHandOff) {
+    Semaphore semaphore{2};
+    std::vector<int> order;
+
+    auto waiter = [](Semaphore& semaphore, std::vector<int>& order, int id) -> Task<> {
+        co_await semaphore.acquire();
+        order.push_back(id);
+    };
+
+    EXPECT_TRUE(semaphore.try_acquire());
+    EXPECT_TRUE(semaphore.try_acquire());
+    EXPECT_FALSE(semaphore.try_acquire());
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(waiter(semaphore, order, i));
+        tasks.back().resume();
+    }
+    EXPECT_TRUE(order.empty());
+
+    // 许可直接交给最早的等待者，后来的 try_acquire 不能插队
+    semaphore.release();
+    EXPECT_EQ(order, (std::vector<int>{0}));
+    EXPECT_FALSE(semaphore.try_acquire());
+
+    // 多出来的许可在等待者都恢复之后留下
+    semaphore.release(4);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(semaphore.available(), 2u);
+    for (auto& task : tasks) {
+        EXPECT_TRUE(task.done());
+    }
+}
+
+TEST(SemaphoreTest, AcquireForTimesOutOrGetsReleasedPermit) {
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_pool, 2, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    Semaphore semaphore{1};
+    ASSERT_TRUE(semaphore.try_acquire());
+
+    auto timed_out = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_FALSE(co_await semaphore.acquire_for(*scheduler, 30ms));
+        EXPECT_GE(std::chrono::steady_clock::now() - start, 25ms);
+        EXPECT_FALSE(co_await semaphore.acquire_for(*scheduler, 0ms));
+    };
+    auto released = [&]() -> Task<> {
+        co_await scheduler->schedule();
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_TRUE(co_await semaphore.acquire_for(*scheduler, 1000ms));
+        EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+        semaphore.release();
+    };
+    auto releaser = [&]() -> Task<> {
+        co_await scheduler->schedule_after(60ms);
+        semaphore.release();
+    };
+
+    sync_wait(when_all(timed_out(), released(), releaser()));
+    // 超时的等待者没有占用许可
+    EXPECT_EQ(semaphore.available(), 1u);
+}
+
+TEST(SemaphoreTest, CapsConcurrencyOnThreadPool) {
+    ThreadPool tp{4};
+    Semaphore semaphore{3, tp};
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+
+    auto func = [&]() -> Task<> {
+        co_await tp.schedule();
+        for (int i = 0; i < 20; ++i) {
+            co_await semaphore.acquire();
+            auto now = running.fetch_add(1) + 1;
+            auto seen = max_running.load();
+            while (now > seen && !max_running.compare_exchange_weak(seen, now)) {
+            }
+            co_await tp.yield();
+            running.fetch_sub(1);
+            semaphore.release();
+        }
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 50; ++i) {
+        tasks.emplace_back(func());
+    }
+    sync_wait(when_all(std::move(tasks)));
+    EXPECT_LE(max_running.load(), 3);
+    EXPECT_EQ(semaphore.available(), 3u);
+}
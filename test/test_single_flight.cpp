@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace coro;
+
+TEST(SingleFlightTest, ConcurrentCallersShareOneLoad) {
+    SingleFlight<std::string, int> flight;
+    Semaphore gate{0};
+    int loads{0};
+    std::vector<int> results;
+
+    auto loader = [&]() -> Task<int> {
+        ++loads;
+        co_await gate.acquire();
+        co_return 42;
+    };
+    auto caller = [&](std::string key) -> Task<> {
+        results.push_back(co_await flight.run(std::move(key), loader));
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 5; ++i) {
+        tasks.push_back(caller("hot"));
+        tasks.back().resume();
+    }
+    // 不同的 key 各自加载
+    tasks.push_back(caller("cold"));
+    tasks.back().resume();
+    EXPECT_EQ(loads, 2);
+    EXPECT_EQ(flight.in_flight(), 2u);
+    EXPECT_TRUE(results.empty());
+
+    // 第一个加载完成时在同一个线程上依次恢复它的等待者
+    gate.release();
+    EXPECT_EQ(results, (std::vector<int>(5, 42)));
+    gate.release();
+    EXPECT_EQ(results.size(), 6u);
+    EXPECT_EQ(flight.in_flight(), 0u);
+    for (auto& task : tasks) {
+        EXPECT_TRUE(task.done());
+    }
+
+    // 完成之后重新加载
+    gate.release();
+    EXPECT_EQ(sync_wait(flight.run("hot", loader)), 42);
+    EXPECT_EQ(loads, 3);
+}
+
+TEST(SingleFlightTest, ExceptionReachesEveryWaiter) {
+    SingleFlight<int, std::string> flight;
+    Semaphore gate{0};
+    int failures{0};
+
+    auto loader = [&]() -> Task<std::string> {
+        co_await gate.acquire();
+        throw std::runtime_error("backend down");
+    };
+    auto caller = [&]() -> Task<> {
+        try {
+            co_await flight.run(1, loader);
+        } catch (const std::runtime_error& e) {
+            EXPECT_STREQ(e.what(), "backend down");
+            ++failures;
+        }
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(caller());
+        tasks.back().resume();
+    }
+    gate.release();
+    EXPECT_EQ(failures, 3);
+    EXPECT_EQ(flight.in_flight(), 0u);
+}
+
+TEST(SingleFlightTest, CoalescesAcrossIoScheduler) {
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_pool, 4, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    SingleFlight<int, long> flight{scheduler};
+    std::atomic<int> loads{0};
+    std::atomic<long> sum{0};
+
+    // 加载在定时器上挂起，期间到达的同一个 key 的调用者都等待它
+    auto loader = [&](int key) {
+        return [&, key]() -> Task<long> {
+            loads.fetch_add(1, std::memory_order_relaxed);
+            co_await scheduler->yield_for(std::chrono::milliseconds{20});
+            co_return key * 100L;
+        };
+    };
+    auto caller = [&](int key) -> Task<> {
+        co_await scheduler->schedule();
+        sum.fetch_add(co_await flight.run(key, loader(key)), std::memory_order_relaxed);
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 200; ++i) {
+        tasks.emplace_back(caller(i % 4));
+    }
+    sync_wait(when_all(std::move(tasks)));
+
+    EXPECT_EQ(sum.load(), 50L * (0 + 100 + 200 + 300));
+    EXPECT_GE(loads.load(), 4);
+    EXPECT_LT(loads.load(), 200);
+    EXPECT_EQ(flight.in_flight(), 0u);
+}
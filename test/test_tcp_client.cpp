@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <coro/coro.hpp>
+
+#include <fcntl.h>
+
+#include <atomic>
+#include <numeric>
+
+using namespace coro;
+using namespace coro::net;
+using namespace std::chrono_literals;
+
+namespace {
+    // 监听 127.0.0.1 上由内核分配的端口，同时运行的测试进程不会共用同一个 SO_REUSEPORT 端口
+    tcp::Server listen_any(std::shared_ptr<IoScheduler> scheduler) {
+        return tcp::Server{std::move(scheduler), {.address = IpAddress::from_string("127.0.0.1"), .port = 0}};
+    }
+
+    // 接受一个连接，交给 handler 处理
+    Task<> serve_one(std::shared_ptr<IoScheduler> scheduler, tcp::Server& server,
+                     std::function<Task<>(tcp::Client)> handler) {
+        co_await scheduler->schedule();
+        server.register_socket();
+        while (true) {
+            if (co_await server.poll(1000ms) != PollStatus::Event) {
+                co_return;
+            }
+            auto client = server.accept();
+            if (client.socket().is_valid()) {
+                co_await handler(std::move(client));
+                co_return;
+            }
+        }
+    }
+
+    Task<tcp::Client> connect_to(std::shared_ptr<IoScheduler> scheduler, uint16_t port) {
+        co_await scheduler->schedule();
+        tcp::Client client{scheduler, {.address = IpAddress::from_string("127.0.0.1"), .port = port}};
+        EXPECT_EQ(co_await client.connect(1000ms), ConnectStatus::Connected);
+        co_return client;
+    }
+}
+
+TEST(TcpClientTest, WriteAllReadExactLargeBuffer) {
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_pool, 2, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    auto server = listen_any(scheduler);
+    auto port = server.local_end_point().port;
+    // 远大于 socket 缓冲区，write_all 必须多次等待可写
+    std::vector<char> payload(8 * 1024 * 1024);
+    std::iota(payload.begin(), payload.end(), 0);
+
+    std::vector<char> received(payload.size());
+    auto reader = [&](tcp::Client client) -> Task<> {
+        auto [status, n] = co_await client.read_exact(received, 5000ms);
+        EXPECT_EQ(status, RecvStatus::Ok);
+        EXPECT_EQ(n, payload.size());
+    };
+    auto writer = [&]() -> Task<> {
+        auto client = co_await connect_to(scheduler, port);
+        client.register_socket();
+        auto [status, n] = co_await client.write_all(payload, 5000ms);
+        EXPECT_EQ(status, SendStatus::Ok);
+        EXPECT_EQ(n, payload.size());
+    };
+
+    sync_wait(when_all(serve_one(scheduler, server, reader), writer()));
+    EXPECT_EQ(received, payload);
+}
+
+TEST(TcpClientTest, ReadSomeTimeoutAndClose) {
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    auto listener = listen_any(scheduler);
+    auto port = listener.local_end_point().port;
+
+    auto server = [&](tcp::Client client) -> Task<> {
+        char buffer[16];
+        // 对端没有发送数据
+        auto [status, data] = co_await client.read_some(buffer, 20ms);
+        EXPECT_EQ(status, RecvStatus::Timeout);
+        EXPECT_TRUE(data.empty());
+
+        // 对端发送 3 字节后关闭，read_exact 读不满
+        auto [exact_status, n] = co_await client.read_exact(buffer, 1000ms);
+        EXPECT_EQ(exact_status, RecvStatus::Closed);
+        EXPECT_EQ(n, 3u);
+    };
+    auto client = [&]() -> Task<> {
+        auto client = co_await connect_to(scheduler, port);
+        co_await scheduler->schedule_after(50ms);
+        auto [status, n] = co_await client.write_all(std::string_view{"abc"});
+        EXPECT_EQ(status, SendStatus::Ok);
+        EXPECT_EQ(n, 3u);
+    };
+
+    sync_wait(when_all(serve_one(scheduler, listener, server), client()));
+}
+
+TEST(TcpServerTest, AcceptBatchDrainsBacklog) {
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    constexpr std::size_t connections = 10;
+
+    auto func = [&]() -> Task<std::size_t> {
+        co_await scheduler->schedule();
+        auto server = listen_any(scheduler);
+        auto port = server.local_end_point().port;
+        server.register_socket();
+
+        // 连接进入监听队列后才开始 accept
+        std::vector<Socket> peers;
+        for (std::size_t i = 0; i < connections; ++i) {
+            tcp::Client peer{scheduler, {.address = IpAddress::from_string("127.0.0.1"), .port = port}};
+            EXPECT_EQ(co_await peer.connect(1000ms), ConnectStatus::Connected);
+            peers.push_back(peer.socket());
+        }
+
+        EXPECT_EQ(co_await server.poll(1000ms), PollStatus::Event);
+        std::vector<tcp::Client> clients;
+        EXPECT_EQ(server.accept_batch(clients, 4), 4u);
+        EXPECT_EQ(server.accept_batch(clients), connections - 4);
+        EXPECT_EQ(server.accept_batch(clients), 0u);
+        for (auto& client : clients) {
+            EXPECT_TRUE(client.is_registered());
+            EXPECT_TRUE(::fcntl(client.socket().fd(), F_GETFL) & O_NONBLOCK);
+        }
+
+        // 队列取空后缓存的就绪状态已清除，poll 会等到超时
+        EXPECT_EQ(co_await server.poll(20ms), PollStatus::Timeout);
+        co_return clients.size();
+    };
+
+    EXPECT_EQ(sync_wait(func()), connections);
+}
+
+TEST(TcpServerTest, ServerGroupSharesPort) {
+    constexpr std::size_t connections = 16;
+    // 第一个 reactor 分到端口，其他 reactor 绑定同一个端口
+    tcp::ServerGroup group{tcp::ServerGroup::Options{
+        .local_end_point = {.address = IpAddress::from_string("127.0.0.1"), .port = 0},
+        .reactors = 2,
+        .steer_by_cpu = true,
+    }};
+    ASSERT_EQ(group.size(), 2u);
+    auto port = group.port();
+    ASSERT_NE(port, 0);
+    EXPECT_EQ(group.server(1).local_end_point().port, port);
+
+    std::atomic<std::size_t> served{0};
+    auto echo = [&](tcp::Client client) -> Task<> {
+        char buffer[16];
+        auto [rstatus, data] = co_await client.read_some(buffer, 1000ms);
+        if (rstatus == RecvStatus::Ok) {
+            co_await client.write_all(data);
+            served.fetch_add(1);
+        }
+    };
+    // 每个 reactor 接受并处理自己监听 socket 上的连接
+    auto acceptor = [&](std::size_t index) -> Task<> {
+        auto& scheduler = group.scheduler(index);
+        auto& server = group.server(index);
+        co_await scheduler->schedule();
+        std::vector<tcp::Client> clients;
+        while (served.load() < connections && co_await server.poll(50ms) != PollStatus::Error) {
+            server.accept_batch(clients);
+            for (auto& client : clients) {
+                scheduler->spawn(echo(std::move(client)));
+            }
+            clients.clear();
+        }
+    };
+
+    auto scheduler = IoScheduler::make_shared({io_exec_thread_inline, 1, ThreadPool::QueueStrategy::WorkStealing,
+                                               IoScheduler::IoBackend::Epoll});
+    auto client = [&]() -> Task<std::size_t> {
+        co_await scheduler->schedule();
+        std::size_t echoed{0};
+        for (std::size_t i = 0; i < connections; ++i) {
+            tcp::Client client{scheduler, {.address = IpAddress::from_string("127.0.0.1"), .port = port}};
+            EXPECT_EQ(co_await client.connect(1000ms), ConnectStatus::Connected);
+            co_await client.write_all(std::string_view{"ping"});
+            char buffer[4];
+            auto [status, n] = co_await client.read_exact(buffer, 1000ms);
+            echoed += status == RecvStatus::Ok && std::string_view(buffer, n) == "ping";
+        }
+        co_return echoed;
+    };
+
+    auto [a, b, echoed] = sync_wait(when_all(acceptor(0), acceptor(1), client()));
+    EXPECT_EQ(echoed, connections);
+    EXPECT_EQ(served.load(), connections);
+}
@@ -30,3 +30,117 @@ TEST(ThreadPoolTest, OneWorkerMulitTask) {
     auto result = coro::sync_wait(func(tp));
     EXPECT_EQ(result, 42);
 }
+
+TEST(ThreadPoolTest, WorkStealingMultiWorkerMultiTask) {
+    ThreadPool tp(4, ThreadPool::QueueStrategy::WorkStealing);
+    std::atomic<int> counter{0};
+
+    auto func = [](ThreadPool& tp, std::atomic<int>& counter) -> Task<> {
+        co_await tp.schedule();
+        for (int i = 0; i < 10; ++i) {
+            co_await tp.yield();
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 1000; ++i) {
+        tasks.emplace_back(func(tp, counter));
+    }
+    coro::sync_wait(when_all(std::move(tasks)));
+    EXPECT_EQ(counter.load(), 10000);
+}
+
+TEST(ThreadPoolTest, GlobalQueueMultiWorkerMultiTask) {
+    ThreadPool tp(4, ThreadPool::QueueStrategy::Global);
+    std::atomic<int> counter{0};
+
+    auto func = [](ThreadPool& tp, std::atomic<int>& counter) -> Task<> {
+        co_await tp.schedule();
+        counter.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 1000; ++i) {
+        tasks.emplace_back(func(tp, counter));
+    }
+    coro::sync_wait(when_all(std::move(tasks)));
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTest, BatchResume) {
+    for (auto strategy : {ThreadPool::QueueStrategy::Global, ThreadPool::QueueStrategy::WorkStealing}) {
+        ThreadPool tp(4, strategy);
+        std::mutex mutex;
+        std::vector<std::coroutine_handle<>> parked;
+
+        struct ParkAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                std::scoped_lock lk{mutex};
+                parked.emplace_back(handle);
+            }
+            void await_resume() noexcept {}
+
+            std::mutex& mutex;
+            std::vector<std::coroutine_handle<>>& parked;
+        };
+
+        auto func = [](ThreadPool& tp, ParkAwaiter awaiter) -> Task<int> {
+            co_await tp.schedule();
+            co_await awaiter;
+            co_return 1;
+        };
+
+        std::vector<Task<int>> tasks;
+        for (int i = 0; i < 100; ++i) {
+            tasks.emplace_back(func(tp, ParkAwaiter{mutex, parked}));
+        }
+
+        std::vector<int> results;
+        std::thread waiter{[&]() { results = coro::sync_wait(when_all(std::move(tasks))); }};
+
+        while (true) {
+            std::scoped_lock lk{mutex};
+            if (parked.size() == 100) {
+                break;
+            }
+        }
+        EXPECT_EQ(tp.resume(std::span{parked}), 100u);
+        waiter.join();
+
+        EXPECT_EQ(results.size(), 100u);
+        EXPECT_EQ(tp.resume(std::span<std::coroutine_handle<>>{}), 0u);
+    }
+}
+
+TEST(ThreadPoolTest, YieldDoesNotStarveExternalTasks) {
+    // 默认的工作窃取模式，只有一个工作线程
+    ThreadPool tp{1};
+    std::atomic<bool> started{false};
+    std::atomic<bool> ran{false};
+    constexpr std::size_t max_spins = 20'000'000;
+
+    auto spinner = [&]() -> Task<std::size_t> {
+        co_await tp.schedule();
+        started.store(true);
+        std::size_t spins{0};
+        while (!ran.load() && spins < max_spins) {
+            co_await tp.yield();
+            ++spins;
+        }
+        co_return spins;
+    };
+    // 在工作线程之外提交，进入全局队列；yield 排在它之后，不会一直占着工作线程
+    auto external = [&]() -> Task<> {
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+        co_await tp.schedule();
+        ran.store(true);
+    };
+
+    auto [spins, _] = sync_wait(when_all(spinner(), external()));
+    EXPECT_TRUE(ran.load());
+    EXPECT_LT(spins, max_spins);
+}
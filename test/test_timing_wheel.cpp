@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <coro/detail/timing_wheel.hpp>
+
+#include <chrono>
+#include <vector>
+
+using namespace coro::detail;
+using namespace std::chrono_literals;
+
+TEST(TimingWheelTest, ExpireInOrder) {
+    auto origin = TimingWheel::clock::now();
+    TimingWheel wheel(origin);
+
+    TimerNode a, b, c;
+    EXPECT_EQ(wheel.add(a, origin + 5ms), 5u);
+    EXPECT_EQ(wheel.add(b, origin + 300ms), 300u);
+    EXPECT_EQ(wheel.add(c, origin + 1ms), 1u);
+    EXPECT_EQ(wheel.size(), 3u);
+    EXPECT_EQ(wheel.next_tick(), 1u);
+
+    std::vector<TimerNode*> expired;
+    wheel.advance(origin + 4ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &c);
+    EXPECT_EQ(wheel.next_tick(), 5u);
+
+    expired.clear();
+    wheel.advance(origin + 299ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &a);
+
+    expired.clear();
+    wheel.advance(origin + 300ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &b);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.next_tick().has_value());
+}
+
+TEST(TimingWheelTest, RemoveBeforeExpire) {
+    auto origin = TimingWheel::clock::now();
+    TimingWheel wheel(origin);
+
+    TimerNode a, b;
+    wheel.add(a, origin + 10ms);
+    wheel.add(b, origin + 100000ms);
+    wheel.remove(a);
+    wheel.remove(b);
+    wheel.remove(b);
+    EXPECT_FALSE(a.is_linked());
+    EXPECT_TRUE(wheel.empty());
+
+    std::vector<TimerNode*> expired;
+    wheel.advance(origin + 200000ms, expired);
+    EXPECT_TRUE(expired.empty());
+}
+
+TEST(TimingWheelTest, CascadeAcrossLevels) {
+    auto origin = TimingWheel::clock::now();
+    TimingWheel wheel(origin);
+
+    // 分别落在第 1、2、3 层
+    TimerNode a, b, c;
+    wheel.add(a, origin + 1000ms);
+    wheel.add(b, origin + 70000ms);
+    wheel.add(c, origin + 20000000ms);
+
+    std::vector<TimerNode*> expired;
+    wheel.advance(origin + 999ms, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(origin + 1000ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &a);
+
+    expired.clear();
+    wheel.advance(origin + 69999ms, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(origin + 70000ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &b);
+
+    expired.clear();
+    wheel.advance(origin + 19999999ms, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(origin + 20000000ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &c);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, ExpiredTimerFiresNextTick) {
+    auto origin = TimingWheel::clock::now();
+    TimingWheel wheel(origin);
+
+    std::vector<TimerNode*> expired;
+    wheel.advance(origin + 50ms, expired);
+
+    TimerNode a;
+    EXPECT_EQ(wheel.add(a, origin), 51u);
+    wheel.advance(origin + 51ms, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &a);
+}